@@ -0,0 +1,19 @@
+#!/bin/bash
+# Times each benchmark on the tree walker and on the closures. Run it from the root of the repo after 'make'.
+TIMEFORMAT="%3R seconds"
+for script in Benchmarks/*.kal
+do
+    [ "$script" == "Benchmarks/lexer.kal" ] && continue
+    echo "$script"
+    echo -n "  tree walker: "; time ./kalman "$script" > /dev/null
+    echo -n "  closures:    "; time ./kalman "$script" --closures > /dev/null
+done
+
+# The lexer and the parser on their own. The script is lexer.kal 20000 times over, about 24 MB, and the
+# unfinished statement at the end is a syntax error, so nothing is evaluated.
+LEXER_SCRIPT=$(mktemp)
+for i in $(seq 20000); do cat Benchmarks/lexer.kal; done > "$LEXER_SCRIPT"
+echo "int" >> "$LEXER_SCRIPT"
+echo "Benchmarks/lexer.kal x 20000 (lexing and parsing only)"
+echo -n "  "; time ./kalman "$LEXER_SCRIPT" > /dev/null
+rm "$LEXER_SCRIPT"
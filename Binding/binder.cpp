@@ -0,0 +1,453 @@
+#include "binding.h"
+#include "../Evaluators/builtin-functions.h"
+
+using namespace Binding;
+using namespace Syntax;
+using namespace Objects;
+using namespace Diagnostics;
+
+// The binder walks the tree once before evaluation and works out the static type of every expression it can.
+// Errors that don't depend on the values are reported up front with the same messages the evaluator uses,
+// and binary operations on known types are swapped for bound ones that skip the object dispatch.
+// It follows the contexts the evaluator creates, so a type is only known when every path agrees on it.
+Binder::Binder() : _scope(nullptr), _conditional(0), _has_writes(false) {}
+
+SyntaxNode* Binder::bind_program(SyntaxNode* root)
+{
+    push_scope(false);
+    collect(root);
+    BoundType type;
+    root = bind(root, type);
+    pop_scope();
+    return root;
+}
+
+// For a script that's run as it's parsed. The global scope is opened with the first statement and stays until
+// the binder is gone, so each statement still knows the types the ones before it declared.
+SyntaxNode* Binder::bind_statement(SyntaxNode* node)
+{
+    if (_scope == nullptr) push_scope(false);
+    collect(node);
+    BoundType type;
+    return bind(node, type);
+}
+
+Binder::~Binder()
+{
+    while (_scope != nullptr)
+        pop_scope();
+}
+
+// A new scope starts out unconditional, the evaluator creates its context only when the code runs.
+void Binder::push_scope(bool is_function)
+{
+    _scope = new BoundScope(_scope, is_function);
+    _conditionals.push_back(_conditional);
+    _conditional = 0;
+}
+
+void Binder::pop_scope()
+{
+    BoundScope* parent = _scope->get_parent();
+    delete _scope;
+    _scope = parent;
+    _conditional = _conditionals.back();
+    _conditionals.pop_back();
+}
+
+// Finds the declarations that will end up in the current scope. Bodies that get their own context are skipped,
+// while their conditions still run in this one.
+void Binder::collect(SyntaxNode* node)
+{
+    if (node == nullptr) return;
+
+    switch (node->kind())
+    {
+        case SyntaxKind::VarDeclareExpression:
+        {
+            VarDeclareExpressionSyntax* t = (VarDeclareExpressionSyntax*)node;
+            Type type = SyntaxFacts::get_keyword_type(t->get_var_keyword()->kind());
+            _scope->declare(t->get_identifier()->get_text(), BoundType(type));
+            return;
+        }
+        case SyntaxKind::FuncDefineExpression:
+        {
+            FuncDefineExpressionSyntax* t = (FuncDefineExpressionSyntax*)node;
+            _scope->declare(t->get_identifier()->get_text(), BoundType(Type::FUNCTION));
+            return;
+        }
+        case SyntaxKind::UnaryExpression:
+            collect(((UnaryExpressionSyntax*)node)->get_operand());
+            return;
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            collect(t->get_left());
+            collect(t->get_right());
+            return;
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            collect(t->get_to_access());
+            collect(t->get_indexer());
+            return;
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+                collect(t->get_node(i));
+            return;
+        }
+        case SyntaxKind::VarAssignExpression:
+            collect(((VarAssignExpressionSyntax*)node)->get_value());
+            return;
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            int n = t->get_size();
+            for (int i = 0; i < n; i++)
+                collect(t->get_condition(i));
+            return;
+        }
+        case SyntaxKind::WhileExpression:
+            collect(((WhileExpressionSyntax*)node)->get_condition());
+            return;
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                collect(t->get_arg(i));
+            return;
+        }
+        case SyntaxKind::ReturnExpression:
+            collect(((ReturnExpressionSyntax*)node)->get_to_return());
+            return;
+        default:
+            return;
+    }
+}
+
+void Binder::check_condition(SyntaxNode* condition, BoundType type)
+{
+    if (type.is_known && type.type != Type::BOOLEAN)
+    {
+        DiagnosticBag::report_unexpected_type(type_to_string(type.type), type_to_string(Type::BOOLEAN),
+            condition->get_pos());
+    }
+}
+
+// Picks the right function and casts the node appropriately, like the evaluator.
+// Returns the node that takes the place of the given node, which is deleted if it was replaced.
+SyntaxNode* Binder::bind(SyntaxNode* node, BoundType& type)
+{
+    type = BoundType();
+    if (node == nullptr) return nullptr;
+
+    switch (node->kind())
+    {
+        case SyntaxKind::LiteralExpression:
+        {
+            Object* value = ((LiteralExpressionSyntax*)node)->get_object();
+            if (value != nullptr) type = BoundType(value->type());
+            return node;
+        }
+        case SyntaxKind::UnaryExpression:
+            return bind_unary((UnaryExpressionSyntax*)node, type);
+        case SyntaxKind::BinaryExpression:
+            return bind_binary((BinaryExpressionSyntax*)node, type);
+        case SyntaxKind::IndexExpression:
+            return bind_index((IndexExpressionSyntax*)node, type);
+        case SyntaxKind::SequenceExpression:
+            return bind_sequence((SequenceExpressionSyntax*)node, type);
+        case SyntaxKind::VarDeclareExpression:
+            return bind_var_declare((VarDeclareExpressionSyntax*)node, type);
+        case SyntaxKind::VarAssignExpression:
+            return bind_var_assign((VarAssignExpressionSyntax*)node, type);
+        case SyntaxKind::VarAccessExpression:
+            return bind_var_access((VarAccessExpressionSyntax*)node, type);
+        case SyntaxKind::IfExpression:
+            return bind_if((IfExpressionSyntax*)node, type);
+        case SyntaxKind::WhileExpression:
+            return bind_while((WhileExpressionSyntax*)node, type);
+        case SyntaxKind::ForExpression:
+            return bind_for((ForExpressionSyntax*)node, type);
+        case SyntaxKind::FuncDefineExpression:
+            return bind_function_define((FuncDefineExpressionSyntax*)node, type);
+        case SyntaxKind::FuncCallExpression:
+            return bind_function_call((FuncCallExpressionSyntax*)node, type);
+        case SyntaxKind::ReturnExpression:
+            return bind_return((ReturnExpressionSyntax*)node, type);
+        case SyntaxKind::BreakExpression:
+        case SyntaxKind::ContinueExpression:
+        case SyntaxKind::NoneExpression:
+            type = BoundType(Type::NONE);
+            return node;
+        default:
+            return node;
+    }
+}
+
+SyntaxNode* Binder::bind_unary(UnaryExpressionSyntax* node, BoundType& type)
+{
+    BoundType operand;
+    node->set_operand(bind(node->get_operand(), operand));
+
+    SyntaxKind op_kind = node->get_op_token()->kind();
+    if (!OperatorTypes::is_legal_unary(op_kind, operand, type) && operand.is_known)
+    {
+        DiagnosticBag::report_illegal_unary_operation(kind_to_string(op_kind), type_to_string(operand.type),
+            node->get_pos());
+    }
+    return node;
+}
+
+// The right operand of 'and' and 'or' might not run, so declarations in it aren't certain.
+SyntaxNode* Binder::bind_binary(BinaryExpressionSyntax* node, BoundType& type)
+{
+    SyntaxKind op_kind = node->get_op_token()->kind();
+    bool is_logical = op_kind == SyntaxKind::AndKeyword || op_kind == SyntaxKind::DAmpersandToken ||
+        op_kind == SyntaxKind::OrKeyword || op_kind == SyntaxKind::DPipeToken;
+
+    BoundType left, right;
+    node->set_left(bind(node->get_left(), left));
+    if (is_logical) _conditional++;
+    node->set_right(bind(node->get_right(), right));
+    if (is_logical) _conditional--;
+
+    if (!OperatorTypes::is_legal_binary(op_kind, left, right, type))
+    {
+        if (left.is_known && right.is_known)
+        {
+            DiagnosticBag::report_illegal_binary_operation(type_to_string(left.type), kind_to_string(op_kind),
+                type_to_string(right.type), node->get_pos());
+        }
+        return node;
+    }
+
+    BoundBinaryOperator op;
+    if (!OperatorTypes::get_bound_operator(op_kind, left, right, op)) return node;
+
+    SyntaxNode* bound = new BoundBinaryExpressionSyntax(node->get_left(), *node->get_op_token(), node->get_right(), op,
+        node->get_pos());
+    node->set_left(nullptr);
+    node->set_right(nullptr);
+    delete node;
+    return bound;
+}
+
+SyntaxNode* Binder::bind_index(IndexExpressionSyntax* node, BoundType& type)
+{
+    BoundType left, right;
+    node->set_to_access(bind(node->get_to_access(), left));
+    node->set_indexer(bind(node->get_indexer(), right));
+
+    if (!OperatorTypes::is_legal_index(left, right, type) && left.is_known && right.is_known)
+    {
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.type),
+            kind_to_string(SyntaxKind::IndexExpression), type_to_string(right.type), node->get_pos());
+    }
+    return node;
+}
+
+SyntaxNode* Binder::bind_sequence(SequenceExpressionSyntax* node, BoundType& type)
+{
+    int n = node->get_nodes_size();
+    for (int i = 0; i < n; i++)
+    {
+        BoundType elem;
+        node->set_node(i, bind(node->get_node(i), elem));
+    }
+
+    type = BoundType(node->get_to_return() ? Type::LIST : Type::NONE);
+    return node;
+}
+
+SyntaxNode* Binder::bind_var_declare(VarDeclareExpressionSyntax* node, BoundType& type)
+{
+    _has_writes = true;
+    if (!_conditional) _scope->define(node->get_identifier()->get_text());
+    type = BoundType(SyntaxFacts::get_keyword_type(node->get_var_keyword()->kind()));
+    return node;
+}
+
+// An assignment whose types are known to match doesn't need to be checked again during evaluation.
+SyntaxNode* Binder::bind_var_assign(VarAssignExpressionSyntax* node, BoundType& type)
+{
+    _has_writes = true;
+    BoundType value;
+    node->set_value(bind(node->get_value(), value));
+
+    BoundType variable = _scope->lookup(node->get_identifier()->get_text());
+    if (variable.is_known && value.is_known)
+    {
+        if (variable.type != value.type)
+        {
+            DiagnosticBag::report_invalid_assign(type_to_string(value.type), type_to_string(variable.type),
+                node->get_pos());
+        }
+        else node->set_type_checked(true);
+    }
+
+    type = variable.is_known ? variable : value;
+    return node;
+}
+
+SyntaxNode* Binder::bind_var_access(VarAccessExpressionSyntax* node, BoundType& type)
+{
+    type = _scope->lookup(node->get_identifier()->get_text());
+    return node;
+}
+
+// Only the first condition is certain to run. Each body gets a new scope, like the new context in the evaluator.
+// Bodies that declare nothing are marked so the evaluator can run them in the current context.
+SyntaxNode* Binder::bind_if(IfExpressionSyntax* node, BoundType& type)
+{
+    int n = node->get_size();
+    for (int i = 0; i < n; i++)
+    {
+        BoundType condition;
+        if (i == 1) _conditional++;
+        node->set_condition(i, bind(node->get_condition(i), condition));
+        check_condition(node->get_condition(i), condition);
+
+        BoundType body;
+        push_scope(false);
+        collect(node->get_body(i));
+        node->set_scoped(i, _scope->has_declarations());
+        node->set_body(i, bind(node->get_body(i), body));
+        pop_scope();
+    }
+    if (n > 1) _conditional--;
+
+    if (node->get_else_body() != nullptr)
+    {
+        BoundType body;
+        push_scope(false);
+        collect(node->get_else_body());
+        node->set_else_scoped(_scope->has_declarations());
+        node->set_else_body(bind(node->get_else_body(), body));
+        pop_scope();
+    }
+
+    type = BoundType();
+    return node;
+}
+
+// The condition runs in the outer context, while the body keeps one context for the whole loop.
+SyntaxNode* Binder::bind_while(WhileExpressionSyntax* node, BoundType& type)
+{
+    BoundType condition;
+    node->set_condition(bind(node->get_condition(), condition));
+    check_condition(node->get_condition(), condition);
+
+    BoundType body;
+    push_scope(false);
+    collect(node->get_body());
+    node->set_scoped(_scope->has_declarations());
+    node->set_body(bind(node->get_body(), body));
+    pop_scope();
+
+    type = BoundType(Type::NONE);
+    return node;
+}
+
+// Everything in a for loop shares one context. The update can be reached through 'continue',
+// so the declarations in the body aren't certain there.
+SyntaxNode* Binder::bind_for(ForExpressionSyntax* node, BoundType& type)
+{
+    push_scope(false);
+    collect(node->get_init());
+    collect(node->get_condition());
+    collect(node->get_update());
+    collect(node->get_body());
+    node->set_scoped(_scope->has_declarations());
+
+    BoundType init, condition, update, body;
+    node->set_init(bind(node->get_init(), init));
+    node->set_condition(bind(node->get_condition(), condition));
+    check_condition(node->get_condition(), condition);
+
+    std::set<std::string> definite = _scope->get_definite();
+    node->set_body(bind(node->get_body(), body));
+    _scope->set_definite(definite);
+    node->set_update(bind(node->get_update(), update));
+    pop_scope();
+
+    type = BoundType(Type::NONE);
+    return node;
+}
+
+// The body can be called from anywhere, so it can't rely on anything outside its own scope.
+SyntaxNode* Binder::bind_function_define(FuncDefineExpressionSyntax* node, BoundType& type)
+{
+    _has_writes = true;
+    if (!_conditional) _scope->define(node->get_identifier()->get_text());
+
+    std::vector<std::string> arg_names;
+    int n = node->get_arg_size();
+    for (int i = 0; i < n; i++)
+        arg_names.push_back(node->get_arg_name(i)->get_text());
+    node->set_body(bind_function_body(arg_names, node->get_body()));
+
+    type = BoundType(Type::FUNCTION);
+    return node;
+}
+
+// Nothing outside a function is certain inside it, so a body is bound the same way wherever it's defined.
+// This is also used for a pre-parsed body once it's parsed. Refer to compile_body in evaluator.cpp.
+SyntaxNode* Binder::bind_function_body(const std::vector<std::string>& arg_names, SyntaxNode* body)
+{
+    push_scope(true);
+    for (const std::string& name : arg_names)
+    {
+        _scope->declare(name, BoundType());
+        _scope->define(name);
+    }
+    collect(body);
+    BoundType type;
+    body = bind(body, type);
+    pop_scope();
+    return body;
+}
+
+// A user-defined function sees the variables of its caller, so calling one can change any of them.
+// When the arguments can't, the evaluator can use the function where it's stored instead of copying it.
+SyntaxNode* Binder::bind_function_call(FuncCallExpressionSyntax* node, BoundType& type)
+{
+    const Evaluators::BuiltIn* builtin = node->get_builtin();
+    if (builtin == nullptr)
+    {
+        BoundType func = _scope->lookup(node->get_identifier()->get_text());
+        if (func.is_known && func.type != Type::FUNCTION)
+        {
+            DiagnosticBag::report_unexpected_type(type_to_string(func.type), type_to_string(Type::FUNCTION),
+                node->get_identifier()->get_pos());
+        }
+    }
+
+    bool has_writes = _has_writes;
+    _has_writes = false;
+    int n = node->get_arg_size();
+    for (int i = 0; i < n; i++)
+    {
+        BoundType arg;
+        node->set_arg(i, bind(node->get_arg(i), arg));
+    }
+    node->set_args_write(_has_writes);
+    _has_writes = has_writes || _has_writes || builtin == nullptr;
+
+    type = builtin != nullptr ? BoundType(builtin->return_type) : BoundType();
+    return node;
+}
+
+SyntaxNode* Binder::bind_return(ReturnExpressionSyntax* node, BoundType& type)
+{
+    BoundType value;
+    node->set_to_return(bind(node->get_to_return(), value));
+    type = BoundType(Type::NONE);
+    return node;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../Syntax/Expressions/syntax-expressions.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace Binding
+{
+    // Refer to bound-scope.cpp.
+    struct BoundType
+    {
+        bool is_known;
+        Objects::Type type;
+        BoundType();
+        BoundType(Objects::Type _type);
+
+        bool is(Objects::Type _type) const;
+        static BoundType join(BoundType a, BoundType b);
+    };
+
+    // Refer to bound-scope.cpp.
+    class BoundScope final
+    {
+    private:
+        std::map<std::string, BoundType> _declared;
+        std::set<std::string> _definite;
+        BoundScope* _parent;
+        bool _is_function;
+    public:
+        BoundScope(BoundScope* parent, bool is_function);
+
+        void declare(const std::string& name, BoundType type);
+        void define(const std::string& name);
+        std::set<std::string> get_definite() const;
+        void set_definite(std::set<std::string>& definite);
+
+        BoundType lookup(const std::string& name) const;
+        bool has_declarations() const;
+        BoundScope* get_parent() const;
+    };
+
+    // Refer to binder.cpp.
+    class Binder final
+    {
+    private:
+        BoundScope* _scope;
+        int _conditional;
+        std::vector<int> _conditionals;
+        bool _has_writes;
+
+        void push_scope(bool is_function);
+        void pop_scope();
+        void collect(Syntax::SyntaxNode* node);
+        void check_condition(Syntax::SyntaxNode* condition, BoundType type);
+
+        Syntax::SyntaxNode* bind(Syntax::SyntaxNode* node, BoundType& type);
+        Syntax::SyntaxNode* bind_unary(Syntax::UnaryExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_binary(Syntax::BinaryExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_index(Syntax::IndexExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_sequence(Syntax::SequenceExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_var_declare(Syntax::VarDeclareExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_var_assign(Syntax::VarAssignExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_var_access(Syntax::VarAccessExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_if(Syntax::IfExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_while(Syntax::WhileExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_for(Syntax::ForExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_function_define(Syntax::FuncDefineExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_function_call(Syntax::FuncCallExpressionSyntax* node, BoundType& type);
+        Syntax::SyntaxNode* bind_return(Syntax::ReturnExpressionSyntax* node, BoundType& type);
+    public:
+        Binder();
+        ~Binder();
+        Syntax::SyntaxNode* bind_program(Syntax::SyntaxNode* root);
+        Syntax::SyntaxNode* bind_statement(Syntax::SyntaxNode* node);
+        Syntax::SyntaxNode* bind_function_body(const std::vector<std::string>& arg_names, Syntax::SyntaxNode* body);
+    };
+
+    // Refer to operator-types.cpp.
+    class OperatorTypes final
+    {
+    public:
+        static bool is_legal_unary(Syntax::SyntaxKind op_kind, BoundType operand, BoundType& result);
+        static bool is_legal_binary(Syntax::SyntaxKind op_kind, BoundType left, BoundType right, BoundType& result);
+        static bool is_legal_index(BoundType left, BoundType right, BoundType& result);
+        static bool get_bound_operator(Syntax::SyntaxKind op_kind, BoundType left, BoundType right,
+            Syntax::BoundBinaryOperator& op);
+        static bool get_bound_unary_operator(Syntax::SyntaxKind op_kind, BoundType operand,
+            Syntax::BoundUnaryOperator& op);
+    };
+}
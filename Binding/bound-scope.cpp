@@ -0,0 +1,76 @@
+#include "binding.h"
+
+using namespace Binding;
+using namespace Objects;
+
+// The static type of an expression. It's unknown when it can only be found out during evaluation,
+// like the value returned by a user-defined function.
+BoundType::BoundType() : is_known(false), type(Type::NONE) {}
+BoundType::BoundType(Type _type) : is_known(true), type(_type) {}
+
+bool BoundType::is(Type _type) const
+{
+    return is_known && type == _type;
+}
+
+// The type of something that can be either of the two.
+BoundType BoundType::join(BoundType a, BoundType b)
+{
+    if (a.is_known && b.is_known && a.type == b.type) return a;
+    return BoundType();
+}
+
+// This mirrors a Context during evaluation.
+// '_declared' holds every declaration in the scope, while '_definite' holds the names that are surely declared
+// at the point the binder is currently at.
+BoundScope::BoundScope(BoundScope* parent, bool is_function) : _parent(parent), _is_function(is_function) {}
+
+// Redeclaring a name with a different type makes its type unknown.
+void BoundScope::declare(const std::string& name, BoundType type)
+{
+    auto it = _declared.find(name);
+    if (it == _declared.end()) _declared[name] = type;
+    else it->second = BoundType::join(it->second, type);
+}
+
+void BoundScope::define(const std::string& name)
+{
+    _definite.insert(name);
+}
+
+std::set<std::string> BoundScope::get_definite() const
+{
+    return _definite;
+}
+
+void BoundScope::set_definite(std::set<std::string>& definite)
+{
+    _definite = definite;
+}
+
+// A name that isn't surely declared yet can still refer to a variable further out.
+// Functions see the variables of their caller, so the lookup stops being certain past a function scope.
+BoundType BoundScope::lookup(const std::string& name) const
+{
+    auto it = _declared.find(name);
+    if (it != _declared.end())
+    {
+        if (_definite.count(name)) return it->second;
+        if (_is_function || _parent == nullptr) return BoundType();
+        return BoundType::join(it->second, _parent->lookup(name));
+    }
+
+    if (_is_function || _parent == nullptr) return BoundType();
+    return _parent->lookup(name);
+}
+
+// A scope without declarations can share the context of its parent during evaluation.
+bool BoundScope::has_declarations() const
+{
+    return !_declared.empty();
+}
+
+BoundScope* BoundScope::get_parent() const
+{
+    return _parent;
+}
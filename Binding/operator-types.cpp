@@ -0,0 +1,248 @@
+#include "binding.h"
+
+using namespace Binding;
+using namespace Syntax;
+using namespace Objects;
+
+// Every type an unknown operand could turn out to be.
+const Type ALL_TYPES[] = {Type::BOOLEAN, Type::INTEGER, Type::DOUBLE, Type::STRING, Type::LIST, Type::FUNCTION, Type::NONE};
+
+static bool is_number(Type type)
+{
+    return type == Type::INTEGER || type == Type::DOUBLE;
+}
+
+// Mirrors the operations in the Objects classes. An operation is legal if it can succeed for some values,
+// so dividing by an integer is legal even though dividing by zero fails.
+static bool binary_result(SyntaxKind op_kind, Type left, Type right, BoundType& result)
+{
+    bool both_numbers = is_number(left) && is_number(right);
+    bool both_integers = left == Type::INTEGER && right == Type::INTEGER;
+    Type number = both_integers ? Type::INTEGER : Type::DOUBLE;
+    switch (op_kind)
+    {
+        case SyntaxKind::PlusToken:
+            if (both_numbers) result = BoundType(number);
+            else if (left == Type::STRING && right == Type::STRING) result = BoundType(Type::STRING);
+            else if (left == Type::LIST) result = BoundType(Type::LIST);
+            else return false;
+            return true;
+        case SyntaxKind::MinusToken:
+        case SyntaxKind::SlashToken:
+            if (!both_numbers) return false;
+            result = BoundType(number);
+            return true;
+        case SyntaxKind::StarToken:
+            if (both_numbers) result = BoundType(number);
+            else if (left == Type::INTEGER && right == Type::STRING) result = BoundType(Type::STRING);
+            else if (left == Type::STRING && right == Type::INTEGER) result = BoundType(Type::STRING);
+            else if (left == Type::LIST && right == Type::LIST) result = BoundType(Type::LIST);
+            else return false;
+            return true;
+        case SyntaxKind::ModuloToken:
+            if (!both_integers) return false;
+            result = BoundType(Type::INTEGER);
+            return true;
+        case SyntaxKind::PowerToken:
+            // A negative integer exponent gives a double, so the type of an integer power is unknown.
+            if (both_integers) result = BoundType();
+            else if (both_numbers) result = BoundType(Type::DOUBLE);
+            else if (left == Type::LIST && right == Type::INTEGER) result = BoundType(Type::LIST);
+            else return false;
+            return true;
+        case SyntaxKind::AndKeyword:
+        case SyntaxKind::DAmpersandToken:
+        case SyntaxKind::OrKeyword:
+        case SyntaxKind::DPipeToken:
+            // The right operand may never be evaluated, so only the left one decides.
+            if (left != Type::BOOLEAN) return false;
+            result = BoundType(Type::BOOLEAN);
+            return true;
+        case SyntaxKind::XorKeyword:
+            if (left != Type::BOOLEAN || right != Type::BOOLEAN) return false;
+            result = BoundType(Type::BOOLEAN);
+            return true;
+        case SyntaxKind::LessThanToken:
+        case SyntaxKind::GreaterThanToken:
+        case SyntaxKind::LessEqualsToken:
+        case SyntaxKind::GreaterEqualsToken:
+            if (!both_numbers && !(left == Type::STRING && right == Type::STRING)) return false;
+            result = BoundType(Type::BOOLEAN);
+            return true;
+        case SyntaxKind::DEqualsToken:
+        case SyntaxKind::BangEqualsToken:
+            result = BoundType(Type::BOOLEAN);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool unary_result(SyntaxKind op_kind, Type operand, BoundType& result)
+{
+    switch (op_kind)
+    {
+        case SyntaxKind::MinusToken:
+            if (!is_number(operand)) return false;
+            result = BoundType(operand);
+            return true;
+        case SyntaxKind::PlusToken:
+            if (!is_number(operand) && operand != Type::STRING) return false;
+            result = BoundType(operand);
+            return true;
+        case SyntaxKind::NotKeyword:
+        case SyntaxKind::BangToken:
+            if (operand != Type::BOOLEAN) return false;
+            result = BoundType(Type::BOOLEAN);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool index_result(Type left, Type right, BoundType& result)
+{
+    if (right != Type::INTEGER) return false;
+    if (left == Type::STRING) result = BoundType(Type::STRING);
+    else if (left == Type::LIST) result = BoundType();
+    else return false;
+    return true;
+}
+
+// An unknown operand is tried with every type. The operation is legal if any of them is,
+// and the result is only known if all of the legal ones agree.
+bool OperatorTypes::is_legal_binary(SyntaxKind op_kind, BoundType left, BoundType right, BoundType& result)
+{
+    bool is_legal = false;
+    for (Type l : ALL_TYPES)
+    {
+        if (left.is_known && l != left.type) continue;
+        for (Type r : ALL_TYPES)
+        {
+            if (right.is_known && r != right.type) continue;
+            BoundType r_result;
+            if (!binary_result(op_kind, l, r, r_result)) continue;
+            result = is_legal ? BoundType::join(result, r_result) : r_result;
+            is_legal = true;
+        }
+    }
+    return is_legal;
+}
+
+bool OperatorTypes::is_legal_unary(SyntaxKind op_kind, BoundType operand, BoundType& result)
+{
+    bool is_legal = false;
+    for (Type t : ALL_TYPES)
+    {
+        if (operand.is_known && t != operand.type) continue;
+        BoundType t_result;
+        if (!unary_result(op_kind, t, t_result)) continue;
+        result = is_legal ? BoundType::join(result, t_result) : t_result;
+        is_legal = true;
+    }
+    return is_legal;
+}
+
+bool OperatorTypes::is_legal_index(BoundType left, BoundType right, BoundType& result)
+{
+    bool is_legal = false;
+    for (Type l : ALL_TYPES)
+    {
+        if (left.is_known && l != left.type) continue;
+        for (Type r : ALL_TYPES)
+        {
+            if (right.is_known && r != right.type) continue;
+            BoundType r_result;
+            if (!index_result(l, r, r_result)) continue;
+            result = is_legal ? BoundType::join(result, r_result) : r_result;
+            is_legal = true;
+        }
+    }
+    return is_legal;
+}
+
+// Picks the specialized operation when both operand types are known.
+bool OperatorTypes::get_bound_operator(SyntaxKind op_kind, BoundType left, BoundType right, BoundBinaryOperator& op)
+{
+    if (!left.is_known || !right.is_known) return false;
+
+    if (left.type == Type::INTEGER && right.type == Type::INTEGER)
+    {
+        switch (op_kind)
+        {
+            case SyntaxKind::PlusToken:             op = BoundBinaryOperator::IntAdd;               return true;
+            case SyntaxKind::MinusToken:            op = BoundBinaryOperator::IntSubtract;          return true;
+            case SyntaxKind::StarToken:             op = BoundBinaryOperator::IntMultiply;          return true;
+            case SyntaxKind::SlashToken:            op = BoundBinaryOperator::IntDivide;            return true;
+            case SyntaxKind::ModuloToken:           op = BoundBinaryOperator::IntModulo;            return true;
+            case SyntaxKind::LessThanToken:         op = BoundBinaryOperator::IntLess;              return true;
+            case SyntaxKind::GreaterThanToken:      op = BoundBinaryOperator::IntGreater;           return true;
+            case SyntaxKind::LessEqualsToken:       op = BoundBinaryOperator::IntLessEquals;        return true;
+            case SyntaxKind::GreaterEqualsToken:    op = BoundBinaryOperator::IntGreaterEquals;     return true;
+            case SyntaxKind::DEqualsToken:          op = BoundBinaryOperator::IntEquals;            return true;
+            case SyntaxKind::BangEqualsToken:       op = BoundBinaryOperator::IntNotEquals;         return true;
+            default:                                                                                return false;
+        }
+    }
+
+    if (is_number(left.type) && is_number(right.type))
+    {
+        switch (op_kind)
+        {
+            case SyntaxKind::PlusToken:             op = BoundBinaryOperator::DoubleAdd;            return true;
+            case SyntaxKind::MinusToken:            op = BoundBinaryOperator::DoubleSubtract;       return true;
+            case SyntaxKind::StarToken:             op = BoundBinaryOperator::DoubleMultiply;       return true;
+            case SyntaxKind::SlashToken:            op = BoundBinaryOperator::DoubleDivide;         return true;
+            case SyntaxKind::LessThanToken:         op = BoundBinaryOperator::DoubleLess;           return true;
+            case SyntaxKind::GreaterThanToken:      op = BoundBinaryOperator::DoubleGreater;        return true;
+            case SyntaxKind::LessEqualsToken:       op = BoundBinaryOperator::DoubleLessEquals;     return true;
+            case SyntaxKind::GreaterEqualsToken:    op = BoundBinaryOperator::DoubleGreaterEquals;  return true;
+            case SyntaxKind::DEqualsToken:          op = BoundBinaryOperator::DoubleEquals;         return true;
+            case SyntaxKind::BangEqualsToken:       op = BoundBinaryOperator::DoubleNotEquals;      return true;
+            default:                                                                                return false;
+        }
+    }
+
+    if (left.type == Type::BOOLEAN && right.type == Type::BOOLEAN)
+    {
+        switch (op_kind)
+        {
+            case SyntaxKind::AndKeyword:
+            case SyntaxKind::DAmpersandToken:       op = BoundBinaryOperator::BoolAnd;              return true;
+            case SyntaxKind::OrKeyword:
+            case SyntaxKind::DPipeToken:            op = BoundBinaryOperator::BoolOr;               return true;
+            case SyntaxKind::XorKeyword:            op = BoundBinaryOperator::BoolXor;              return true;
+            case SyntaxKind::DEqualsToken:          op = BoundBinaryOperator::BoolEquals;           return true;
+            case SyntaxKind::BangEqualsToken:       op = BoundBinaryOperator::BoolNotEquals;        return true;
+            default:                                                                                return false;
+        }
+    }
+
+    return false;
+}
+
+bool OperatorTypes::get_bound_unary_operator(SyntaxKind op_kind, BoundType operand, BoundUnaryOperator& op)
+{
+    if (!operand.is_known) return false;
+
+    switch (op_kind)
+    {
+        case SyntaxKind::MinusToken:
+            if (operand.type == Type::INTEGER) op = BoundUnaryOperator::IntNegate;
+            else if (operand.type == Type::DOUBLE) op = BoundUnaryOperator::DoubleNegate;
+            else return false;
+            return true;
+        case SyntaxKind::PlusToken:
+            if (operand.type == Type::INTEGER) op = BoundUnaryOperator::IntIdentity;
+            else if (operand.type == Type::DOUBLE) op = BoundUnaryOperator::DoubleIdentity;
+            else return false;
+            return true;
+        case SyntaxKind::NotKeyword:
+        case SyntaxKind::BangToken:
+            if (operand.type != Type::BOOLEAN) return false;
+            op = BoundUnaryOperator::BoolNot;
+            return true;
+        default:
+            return false;
+    }
+}
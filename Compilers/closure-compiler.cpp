@@ -0,0 +1,1135 @@
+#include "compilers.h"
+
+using namespace Syntax;
+using namespace Contexts;
+using namespace Diagnostics;
+using namespace Objects;
+using namespace Evaluators;
+using namespace Compilers;
+
+// Another way to run a program, turned on with '--closures'. Instead of switching on the kind of a node and
+// casting it every time it's visited, each node is compiled once into a closure: a function picked for its kind
+// and its operator, with its operands compiled the same way, and the names, types, operators and builtins it
+// needs looked up beforehand. Evaluating a node is then just a call through its function pointer.
+// The objects, the contexts and the passes over the tree are the same as the evaluator's, and so are the
+// errors, the counted loops and the traces of hot loops.
+// A function body is compiled the first time it's called, and each call remembers the last body it ran.
+
+std::unordered_map<SyntaxNode*, Closure*> ClosureCompiler::_bodies;
+
+Closure::Closure(Run _run, SyntaxNode* _node)
+    : run(_run), node(_node), constant(nullptr), builtin(nullptr), counted_loop(nullptr), counted(0),
+    is_copied(false), body(nullptr), compiled_body(nullptr) {}
+
+Closure::~Closure()
+{
+    for (Closure* operand : operands)
+        delete operand;
+}
+
+// Runs a whole program the way Evaluator::evaluate does.
+Completion ClosureCompiler::run(Context& context, SyntaxNode* root)
+{
+    Closure* program = compile(root);
+    Completion result = program->run(program, context, true);
+    delete program;
+    clear();
+    return result;
+}
+
+// The function bodies can only go once nothing can call them anymore.
+void ClosureCompiler::clear()
+{
+    for (auto& body : _bodies)
+        delete body.second;
+    _bodies.clear();
+}
+
+Closure* ClosureCompiler::compile(SyntaxNode* node)
+{
+    switch (node->kind())
+    {
+        case SyntaxKind::LiteralExpression:
+        {
+            Closure* closure = new Closure(run_literal, node);
+            closure->constant = ((LiteralExpressionSyntax*)node)->get_object();
+            return closure;
+        }
+        case SyntaxKind::UnaryExpression:
+        {
+            UnaryExpressionSyntax* t = (UnaryExpressionSyntax*)node;
+            Closure* closure = new Closure(pick_unary(t->get_op_token()->kind()), node);
+            closure->operands.push_back(compile(t->get_operand()));
+            return closure;
+        }
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            Closure* closure = new Closure(pick_binary(t->get_op_token()->kind()), node);
+            closure->operands.push_back(compile(t->get_left()));
+            closure->operands.push_back(compile(t->get_right()));
+            return closure;
+        }
+        case SyntaxKind::BoundBinaryExpression:
+        {
+            BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)node;
+            Closure* closure = new Closure(pick_bound_binary(t->get_op()), node);
+            closure->operands.push_back(compile(t->get_left()));
+            closure->operands.push_back(compile(t->get_right()));
+            return closure;
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            Closure* closure = new Closure(run_index, node);
+            closure->operands.push_back(compile(t->get_to_access()));
+            closure->operands.push_back(compile(t->get_indexer()));
+            return closure;
+        }
+        case SyntaxKind::HoistedExpression:
+        {
+            Closure* closure = new Closure(run_hoisted, node);
+            closure->operands.push_back(compile(((HoistedExpressionSyntax*)node)->get_expression()));
+            return closure;
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            Closure* closure = new Closure(t->get_to_return() ? run_list : run_sequence, node);
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+                closure->operands.push_back(compile(t->get_node(i)));
+            return closure;
+        }
+        case SyntaxKind::VarDeclareExpression:
+        {
+            VarDeclareExpressionSyntax* t = (VarDeclareExpressionSyntax*)node;
+            Closure* closure = new Closure(pick_var_declare(SyntaxFacts::get_keyword_type(t->get_var_keyword()->kind())),
+                node);
+            closure->name = t->get_identifier()->get_text();
+            return closure;
+        }
+        case SyntaxKind::VarAssignExpression:
+        {
+            VarAssignExpressionSyntax* t = (VarAssignExpressionSyntax*)node;
+            Closure* closure = new Closure(t->is_type_checked() ? run_var_assign<true> : run_var_assign<false>, node);
+            closure->name = t->get_identifier()->get_text();
+            closure->operands.push_back(compile(t->get_value()));
+            return closure;
+        }
+        case SyntaxKind::VarAccessExpression:
+        {
+            Closure* closure = new Closure(run_var_access, node);
+            closure->name = ((VarAccessExpressionSyntax*)node)->get_identifier()->get_text();
+            return closure;
+        }
+        case SyntaxKind::ReturnExpression:
+        {
+            ReturnExpressionSyntax* t = (ReturnExpressionSyntax*)node;
+            Closure* closure = new Closure(run_return, node);
+            if (t->get_to_return() != nullptr) closure->operands.push_back(compile(t->get_to_return()));
+            return closure;
+        }
+        case SyntaxKind::BreakExpression:
+            return new Closure(run_break, node);
+        case SyntaxKind::ContinueExpression:
+            return new Closure(run_continue, node);
+        case SyntaxKind::WhileExpression:
+        {
+            WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            Closure* closure = new Closure(run_while, node);
+            closure->operands.push_back(compile(t->get_condition()));
+            closure->operands.push_back(compile(t->get_body()));
+            closure->scoped.push_back(t->is_scoped());
+            return compile_loop(closure, t->get_counted_loop());
+        }
+        case SyntaxKind::ForExpression:
+        {
+            ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            Closure* closure = new Closure(run_for, node);
+            closure->operands.push_back(compile(t->get_init()));
+            closure->operands.push_back(compile(t->get_condition()));
+            closure->operands.push_back(compile(t->get_update()));
+            closure->operands.push_back(compile(t->get_body()));
+            closure->scoped.push_back(t->is_scoped());
+            return compile_loop(closure, t->get_counted_loop());
+        }
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            Closure* closure = new Closure(run_if, node);
+            int n = t->get_size();
+            for (int i = 0; i < n; i++)
+            {
+                closure->operands.push_back(compile(t->get_condition(i)));
+                closure->operands.push_back(compile(t->get_body(i)));
+                closure->scoped.push_back(t->is_scoped(i));
+            }
+            if (t->get_else_body() != nullptr) closure->operands.push_back(compile(t->get_else_body()));
+            closure->scoped.push_back(t->is_else_scoped());
+            return closure;
+        }
+        case SyntaxKind::FuncDefineExpression:
+        {
+            FuncDefineExpressionSyntax* t = (FuncDefineExpressionSyntax*)node;
+            Closure* closure = new Closure(run_function_define, node);
+            closure->name = t->get_identifier()->get_text();
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                closure->arg_names.push_back(t->get_arg_name(i)->get_text());
+            return closure;
+        }
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            const BuiltIn* builtin = t->get_builtin();
+            Closure* closure = new Closure(run_function_call, node);
+            if (builtin != nullptr)
+                closure->run = builtin->arity == t->get_arg_size() ? run_builtin_call : run_bad_arguments;
+            closure->builtin = builtin;
+            closure->name = t->get_identifier()->get_text();
+            closure->is_copied = t->args_write();
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                closure->operands.push_back(compile(t->get_arg(i)));
+            return closure;
+        }
+        case SyntaxKind::InlinedCallExpression:
+        {
+            InlinedCallExpressionSyntax* t = (InlinedCallExpressionSyntax*)node;
+            Closure* closure = new Closure(run_inlined_call, node);
+            closure->name = t->get_call()->get_identifier()->get_text();
+            closure->operands.push_back(compile(t->get_call()));
+            closure->operands.push_back(compile(t->get_body()));
+            return closure;
+        }
+        case SyntaxKind::ParameterExpression:
+            return new Closure(run_parameter, node);
+        case SyntaxKind::NoneExpression:
+            return new Closure(run_none, node);
+        default:
+            return new Closure(run_unknown, node);
+    }
+}
+
+// The limit and the body statements of a counted loop come after the loop's own operands.
+Closure* ClosureCompiler::compile_loop(Closure* closure, CountedLoop* loop)
+{
+    if (loop == nullptr) return closure;
+
+    closure->counted_loop = loop;
+    closure->counted = closure->operands.size();
+    closure->operands.push_back(compile(loop->limit));
+    for (SyntaxNode* statement : loop->body)
+        closure->operands.push_back(compile(statement));
+    return closure;
+}
+
+Closure::Run ClosureCompiler::pick_unary(SyntaxKind op_kind)
+{
+    switch (op_kind)
+    {
+        case SyntaxKind::MinusToken:
+            return run_unary<SyntaxKind::MinusToken>;
+        case SyntaxKind::PlusToken:
+            return run_unary<SyntaxKind::PlusToken>;
+        case SyntaxKind::NotKeyword:
+        case SyntaxKind::BangToken:
+            return run_unary<SyntaxKind::NotKeyword>;
+        default:
+            return run_unary<SyntaxKind::BadToken>;
+    }
+}
+
+Closure::Run ClosureCompiler::pick_binary(SyntaxKind op_kind)
+{
+    switch (op_kind)
+    {
+        case SyntaxKind::PlusToken:
+            return run_binary<Operator::ADD>;
+        case SyntaxKind::MinusToken:
+            return run_binary<Operator::SUBTRACT>;
+        case SyntaxKind::StarToken:
+            return run_binary<Operator::MULTIPLY>;
+        case SyntaxKind::SlashToken:
+            return run_binary<Operator::DIVIDE>;
+        case SyntaxKind::ModuloToken:
+            return run_binary<Operator::MODULO>;
+        case SyntaxKind::PowerToken:
+            return run_binary<Operator::POWER>;
+        case SyntaxKind::AndKeyword:
+        case SyntaxKind::DAmpersandToken:
+            return run_logical<true>;
+        case SyntaxKind::OrKeyword:
+        case SyntaxKind::DPipeToken:
+            return run_logical<false>;
+        case SyntaxKind::XorKeyword:
+            return run_binary<Operator::XOR>;
+        case SyntaxKind::LessThanToken:
+            return run_binary<Operator::LESS>;
+        case SyntaxKind::GreaterThanToken:
+            return run_binary<Operator::GREATER>;
+        case SyntaxKind::LessEqualsToken:
+            return run_binary<Operator::LESS_EQUALS>;
+        case SyntaxKind::GreaterEqualsToken:
+            return run_binary<Operator::GREATER_EQUALS>;
+        case SyntaxKind::DEqualsToken:
+            return run_binary<Operator::EQUALS>;
+        case SyntaxKind::BangEqualsToken:
+            return run_binary<Operator::NOT_EQUALS>;
+        default:
+            return run_unknown_binary;
+    }
+}
+
+Closure::Run ClosureCompiler::pick_bound_binary(BoundBinaryOperator op)
+{
+    switch (op)
+    {
+        case BoundBinaryOperator::IntAdd:
+            return run_bound_binary<BoundBinaryOperator::IntAdd>;
+        case BoundBinaryOperator::IntSubtract:
+            return run_bound_binary<BoundBinaryOperator::IntSubtract>;
+        case BoundBinaryOperator::IntMultiply:
+            return run_bound_binary<BoundBinaryOperator::IntMultiply>;
+        case BoundBinaryOperator::IntDivide:
+            return run_bound_binary<BoundBinaryOperator::IntDivide>;
+        case BoundBinaryOperator::IntModulo:
+            return run_bound_binary<BoundBinaryOperator::IntModulo>;
+        case BoundBinaryOperator::IntLess:
+            return run_bound_binary<BoundBinaryOperator::IntLess>;
+        case BoundBinaryOperator::IntGreater:
+            return run_bound_binary<BoundBinaryOperator::IntGreater>;
+        case BoundBinaryOperator::IntLessEquals:
+            return run_bound_binary<BoundBinaryOperator::IntLessEquals>;
+        case BoundBinaryOperator::IntGreaterEquals:
+            return run_bound_binary<BoundBinaryOperator::IntGreaterEquals>;
+        case BoundBinaryOperator::IntEquals:
+            return run_bound_binary<BoundBinaryOperator::IntEquals>;
+        case BoundBinaryOperator::IntNotEquals:
+            return run_bound_binary<BoundBinaryOperator::IntNotEquals>;
+        case BoundBinaryOperator::DoubleAdd:
+            return run_bound_binary<BoundBinaryOperator::DoubleAdd>;
+        case BoundBinaryOperator::DoubleSubtract:
+            return run_bound_binary<BoundBinaryOperator::DoubleSubtract>;
+        case BoundBinaryOperator::DoubleMultiply:
+            return run_bound_binary<BoundBinaryOperator::DoubleMultiply>;
+        case BoundBinaryOperator::DoubleDivide:
+            return run_bound_binary<BoundBinaryOperator::DoubleDivide>;
+        case BoundBinaryOperator::DoubleLess:
+            return run_bound_binary<BoundBinaryOperator::DoubleLess>;
+        case BoundBinaryOperator::DoubleGreater:
+            return run_bound_binary<BoundBinaryOperator::DoubleGreater>;
+        case BoundBinaryOperator::DoubleLessEquals:
+            return run_bound_binary<BoundBinaryOperator::DoubleLessEquals>;
+        case BoundBinaryOperator::DoubleGreaterEquals:
+            return run_bound_binary<BoundBinaryOperator::DoubleGreaterEquals>;
+        case BoundBinaryOperator::DoubleEquals:
+            return run_bound_binary<BoundBinaryOperator::DoubleEquals>;
+        case BoundBinaryOperator::DoubleNotEquals:
+            return run_bound_binary<BoundBinaryOperator::DoubleNotEquals>;
+        case BoundBinaryOperator::BoolAnd:
+            return run_bound_logical<true>;
+        case BoundBinaryOperator::BoolOr:
+            return run_bound_logical<false>;
+        case BoundBinaryOperator::BoolXor:
+            return run_bound_binary<BoundBinaryOperator::BoolXor>;
+        case BoundBinaryOperator::BoolEquals:
+            return run_bound_binary<BoundBinaryOperator::BoolEquals>;
+        default:
+            return run_bound_binary<BoundBinaryOperator::BoolNotEquals>;
+    }
+}
+
+Closure::Run ClosureCompiler::pick_var_declare(Type type)
+{
+    switch (type)
+    {
+        case Type::BOOLEAN:
+            return run_var_declare<Type::BOOLEAN>;
+        case Type::INTEGER:
+            return run_var_declare<Type::INTEGER>;
+        case Type::DOUBLE:
+            return run_var_declare<Type::DOUBLE>;
+        case Type::STRING:
+            return run_var_declare<Type::STRING>;
+        case Type::LIST:
+            return run_var_declare<Type::LIST>;
+        case Type::FUNCTION:
+            return run_var_declare<Type::FUNCTION>;
+        default:
+            return run_var_declare<Type::NONE>;
+    }
+}
+
+Completion ClosureCompiler::run_literal(Closure* self, Context& context, bool is_used)
+{
+    return self->constant->copy();
+}
+
+template <SyntaxKind op_kind>
+Completion ClosureCompiler::run_unary(Closure* self, Context& context, bool is_used)
+{
+    Closure* operand_closure = self->operands[0];
+    Completion operand = operand_closure->run(operand_closure, context, true);
+    if (!operand.is_normal()) return operand;
+
+    Object* result = nullptr;
+    if constexpr (op_kind == SyntaxKind::MinusToken)
+        result = operand.value->negated();
+    else if constexpr (op_kind == SyntaxKind::PlusToken)
+        result = operand.value->posited();
+    else if constexpr (op_kind == SyntaxKind::NotKeyword)
+        result = operand.value->notted();
+    if (result == nullptr || result->type() == Type::NONE)
+    {
+        UnaryExpressionSyntax* node = (UnaryExpressionSyntax*)self->node;
+        DiagnosticBag::report_illegal_unary_operation(kind_to_string(node->get_op_token()->kind()),
+            type_to_string(operand.value->type()), node->get_pos());
+        delete operand.value;
+        delete result;
+        return CompletionType::Error;
+    }
+
+    delete operand.value;
+    return result;
+}
+
+template <Operator op>
+Completion ClosureCompiler::run_binary(Closure* self, Context& context, bool is_used)
+{
+    Closure* left_closure = self->operands[0];
+    Completion left = left_closure->run(left_closure, context, true);
+    if (!left.is_normal()) return left;
+
+    Closure* right_closure = self->operands[1];
+    Completion right = right_closure->run(right_closure, context, true);
+    if (!right.is_normal())
+    {
+        delete left.value;
+        return right;
+    }
+
+    Object* result = operate(op, left.value, right.value);
+    if (result == nullptr || result->type() == Type::NONE)
+    {
+        BinaryExpressionSyntax* node = (BinaryExpressionSyntax*)self->node;
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+            kind_to_string(node->get_op_token()->kind()), type_to_string(right.value->type()), node->get_pos());
+        delete left.value;
+        delete right.value;
+        delete result;
+        return CompletionType::Error;
+    }
+
+    delete left.value;
+    delete right.value;
+    return result;
+}
+
+// An operator no object has. It's still an error only once both operands are evaluated.
+Completion ClosureCompiler::run_unknown_binary(Closure* self, Context& context, bool is_used)
+{
+    Closure* left_closure = self->operands[0];
+    Completion left = left_closure->run(left_closure, context, true);
+    if (!left.is_normal()) return left;
+
+    Closure* right_closure = self->operands[1];
+    Completion right = right_closure->run(right_closure, context, true);
+    if (!right.is_normal())
+    {
+        delete left.value;
+        return right;
+    }
+
+    BinaryExpressionSyntax* node = (BinaryExpressionSyntax*)self->node;
+    DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+        kind_to_string(node->get_op_token()->kind()), type_to_string(right.value->type()), node->get_pos());
+    delete left.value;
+    delete right.value;
+    return CompletionType::Error;
+}
+
+// Refer to Evaluator::evaluate_logical.
+template <bool is_and>
+Completion ClosureCompiler::run_logical(Closure* self, Context& context, bool is_used)
+{
+    Closure* left_closure = self->operands[0];
+    Completion left = left_closure->run(left_closure, context, true);
+    if (!left.is_normal()) return left;
+    if (left.value->type() == Type::BOOLEAN && ((Boolean*)left.value)->get_value() != is_and) return left;
+
+    Closure* right_closure = self->operands[1];
+    Completion right = right_closure->run(right_closure, context, true);
+    if (!right.is_normal())
+    {
+        delete left.value;
+        return right;
+    }
+
+    Object* result = is_and ? left.value->and_with(right.value) : left.value->or_with(right.value);
+    if (result->type() == Type::NONE)
+    {
+        BinaryExpressionSyntax* node = (BinaryExpressionSyntax*)self->node;
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+            kind_to_string(node->get_op_token()->kind()), type_to_string(right.value->type()), node->get_pos());
+        delete left.value;
+        delete right.value;
+        delete result;
+        return CompletionType::Error;
+    }
+
+    delete left.value;
+    delete right.value;
+    return result;
+}
+
+template <BoundBinaryOperator op>
+Completion ClosureCompiler::run_bound_binary(Closure* self, Context& context, bool is_used)
+{
+    Closure* left_closure = self->operands[0];
+    Completion left = left_closure->run(left_closure, context, true);
+    if (!left.is_normal()) return left;
+
+    Closure* right_closure = self->operands[1];
+    Completion right = right_closure->run(right_closure, context, true);
+    if (!right.is_normal())
+    {
+        delete left.value;
+        return right;
+    }
+
+    Object* result = bound_operation<op>(left.value, right.value);
+    if (result == nullptr)
+    {
+        BoundBinaryExpressionSyntax* node = (BoundBinaryExpressionSyntax*)self->node;
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+            kind_to_string(node->get_op_token()->kind()), type_to_string(right.value->type()), node->get_pos());
+        delete left.value;
+        delete right.value;
+        return CompletionType::Error;
+    }
+
+    delete left.value;
+    delete right.value;
+    return result;
+}
+
+// Refer to Evaluator::evaluate_bound_binary.
+template <bool is_and>
+Completion ClosureCompiler::run_bound_logical(Closure* self, Context& context, bool is_used)
+{
+    Closure* left_closure = self->operands[0];
+    Completion left = left_closure->run(left_closure, context, true);
+    if (!left.is_normal()) return left;
+    if (((Boolean*)left.value)->get_value() != is_and) return left;
+    delete left.value;
+
+    Closure* right_closure = self->operands[1];
+    return right_closure->run(right_closure, context, true);
+}
+
+static long long get_integer(Object* object)
+{
+    return ((Integer*)object)->get_value();
+}
+
+static long double get_number(Object* object)
+{
+    if (object->type() == Type::INTEGER) return ((Integer*)object)->get_value();
+    return ((Double*)object)->get_value();
+}
+
+static bool get_boolean(Object* object)
+{
+    return ((Boolean*)object)->get_value();
+}
+
+// Each operation of Evaluator::apply_bound_binary on its own. Returns nullptr when it fails for these values.
+template <BoundBinaryOperator op>
+Object* ClosureCompiler::bound_operation(Object* left, Object* right)
+{
+    if constexpr (op == BoundBinaryOperator::IntAdd)
+        return Integer::make(get_integer(left) + get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntSubtract)
+        return Integer::make(get_integer(left) - get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntMultiply)
+        return Integer::make(get_integer(left) * get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntDivide)
+        return get_integer(right) == 0 ? nullptr : Integer::make(get_integer(left) / get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntModulo)
+        return get_integer(right) == 0 ? nullptr : Integer::make(get_integer(left) % get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntLess)
+        return Boolean::make(get_integer(left) < get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntGreater)
+        return Boolean::make(get_integer(left) > get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntLessEquals)
+        return Boolean::make(get_integer(left) <= get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntGreaterEquals)
+        return Boolean::make(get_integer(left) >= get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntEquals)
+        return Boolean::make(get_integer(left) == get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::IntNotEquals)
+        return Boolean::make(get_integer(left) != get_integer(right));
+    else if constexpr (op == BoundBinaryOperator::DoubleAdd)
+        return new Double(get_number(left) + get_number(right));
+    else if constexpr (op == BoundBinaryOperator::DoubleSubtract)
+        return new Double(get_number(left) - get_number(right));
+    else if constexpr (op == BoundBinaryOperator::DoubleMultiply)
+        return new Double(get_number(left) * get_number(right));
+    else if constexpr (op == BoundBinaryOperator::DoubleDivide)
+        return get_number(right) == 0 ? nullptr : new Double(get_number(left) / get_number(right));
+    else if constexpr (op == BoundBinaryOperator::DoubleLess)
+        return Boolean::make(get_number(left) < get_number(right));
+    else if constexpr (op == BoundBinaryOperator::DoubleGreater)
+        return Boolean::make(get_number(left) > get_number(right));
+    else if constexpr (op == BoundBinaryOperator::DoubleLessEquals)
+        return Boolean::make(!(get_number(left) > get_number(right)));
+    else if constexpr (op == BoundBinaryOperator::DoubleGreaterEquals)
+        return Boolean::make(!(get_number(left) < get_number(right)));
+    else if constexpr (op == BoundBinaryOperator::DoubleEquals)
+        return Boolean::make(get_number(left) == get_number(right));
+    else if constexpr (op == BoundBinaryOperator::DoubleNotEquals)
+        return Boolean::make(!(get_number(left) == get_number(right)));
+    else if constexpr (op == BoundBinaryOperator::BoolXor)
+        return Boolean::make(get_boolean(left) ^ get_boolean(right));
+    else if constexpr (op == BoundBinaryOperator::BoolEquals)
+        return Boolean::make(get_boolean(left) == get_boolean(right));
+    else if constexpr (op == BoundBinaryOperator::BoolNotEquals)
+        return Boolean::make(get_boolean(left) != get_boolean(right));
+    else
+        return nullptr;
+}
+
+Completion ClosureCompiler::run_index(Closure* self, Context& context, bool is_used)
+{
+    Closure* left_closure = self->operands[0];
+    Completion left = left_closure->run(left_closure, context, true);
+    if (!left.is_normal()) return left;
+
+    Closure* right_closure = self->operands[1];
+    Completion right = right_closure->run(right_closure, context, true);
+    if (!right.is_normal())
+    {
+        delete left.value;
+        return right;
+    }
+
+    Object* result = left.value->accessed_by(right.value);
+    if (result->type() == Type::NONE)
+    {
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+            kind_to_string(SyntaxKind::IndexExpression), type_to_string(right.value->type()), self->node->get_pos());
+        delete left.value;
+        delete right.value;
+        delete result;
+        return CompletionType::Error;
+    }
+
+    delete left.value;
+    delete right.value;
+    return result;
+}
+
+// Refer to Evaluator::evaluate_hoisted.
+Completion ClosureCompiler::run_hoisted(Closure* self, Context& context, bool is_used)
+{
+    HoistedExpressionSyntax* node = (HoistedExpressionSyntax*)self->node;
+    if (node->get_value() == nullptr)
+    {
+        Closure* expression = self->operands[0];
+        Completion value = expression->run(expression, context, true);
+        if (!value.is_normal()) return value;
+        node->set_value(value.value);
+    }
+    return node->get_value()->copy();
+}
+
+Completion ClosureCompiler::run_list(Closure* self, Context& context, bool is_used)
+{
+    std::vector<Object*> elements;
+    for (Closure* element : self->operands)
+    {
+        Completion obj = element->run(element, context, true);
+        if (!obj.is_normal())
+        {
+            for (auto &o : elements)
+                delete o;
+            return obj;
+        }
+        elements.push_back(obj.value);
+    }
+    return new List(elements);
+}
+
+Completion ClosureCompiler::run_sequence(Closure* self, Context& context, bool is_used)
+{
+    for (Closure* statement : self->operands)
+    {
+        Completion obj = statement->run(statement, context, false);
+        if (!obj.is_normal()) return obj;
+        delete obj.value;
+    }
+    if (!is_used) return nullptr;
+    return None::make();
+}
+
+template <Type type>
+Completion ClosureCompiler::run_var_declare(Closure* self, Context& context, bool is_used)
+{
+    Object* value;
+    if constexpr (type == Type::BOOLEAN)
+        value = Boolean::make(false);
+    else if constexpr (type == Type::INTEGER)
+        value = Integer::make(0);
+    else if constexpr (type == Type::DOUBLE)
+        value = new Double(0);
+    else if constexpr (type == Type::STRING)
+        value = new String("");
+    else if constexpr (type == Type::LIST)
+    {
+        std::vector<Object*> elems;
+        value = new List(elems);
+    }
+    else if constexpr (type == Type::FUNCTION)
+    {
+        std::vector<std::string> arg_names;
+        value = new Function("<uninitialized>", arg_names, nullptr);
+    }
+    else
+    {
+        DiagnosticBag::report_unreachable_code("invalid type declaration", self->node->get_pos());
+        return CompletionType::Error;
+    }
+
+    context.get_symbol_table()->declare_object(self->name, value);
+    if (!is_used) return nullptr;
+    return value->copy();
+}
+
+// Refer to Evaluator::evaluate_var_assign.
+template <bool is_checked>
+Completion ClosureCompiler::run_var_assign(Closure* self, Context& context, bool is_used)
+{
+    Closure* value_closure = self->operands[0];
+    Completion value = value_closure->run(value_closure, context, true);
+    if (!value.is_normal()) return value;
+
+    ObjectSymbol obj_sym = context.get_symbol_table()->get_object(self->name);
+    Object* orig_value = obj_sym.object;
+    if (!is_checked && (obj_sym.symbol == nullptr || orig_value->type() != value.value->type()))
+    {
+        DiagnosticBag::report_invalid_assign(type_to_string(value.value->type()), type_to_string(orig_value->type()),
+            self->node->get_pos());
+        if (obj_sym.symbol == nullptr) delete orig_value;
+        delete value.value;
+        return CompletionType::Error;
+    }
+
+    delete orig_value;
+    obj_sym.symbol->set_object(self->name, value.value);
+    if (!is_used) return nullptr;
+    return value.value->copy();
+}
+
+Completion ClosureCompiler::run_var_access(Closure* self, Context& context, bool is_used)
+{
+    Object* result = context.get_symbol_table()->get_object(self->name).object->copy();
+    if (result->type() == Type::NONE)
+    {
+        VarAccessExpressionSyntax* node = (VarAccessExpressionSyntax*)self->node;
+        DiagnosticBag::report_undeclared_identifier(self->name, node->get_identifier()->get_pos());
+        delete result;
+        return CompletionType::Error;
+    }
+    return result;
+}
+
+// Evaluates a condition. Returns false when the loop or the if-statement has to end with 'completion'.
+bool ClosureCompiler::is_condition(Closure* condition, Context& context, bool& is_true, Completion& completion)
+{
+    completion = condition->run(condition, context, true);
+    if (!completion.is_normal()) return false;
+
+    if (completion.value->type() != Type::BOOLEAN)
+    {
+        DiagnosticBag::report_unexpected_type(type_to_string(completion.value->type()),
+            type_to_string(Type::BOOLEAN), condition->node->get_pos());
+        delete completion.value;
+        completion = CompletionType::Error;
+        return false;
+    }
+
+    is_true = ((Boolean*)completion.value)->get_value();
+    delete completion.value;
+    return true;
+}
+
+// Refer to Evaluator::evaluate_while.
+Completion ClosureCompiler::run_while(Closure* self, Context& context, bool is_used)
+{
+    WhileExpressionSyntax* node = (WhileExpressionSyntax*)self->node;
+    if (!self->scoped[0])
+    {
+        Completion result = loop_while(self, context, context);
+        node->forget_invariants();
+        return result;
+    }
+
+    Context* exec_ctx = ContextPool::acquire("while-loop", &context);
+    Completion result = loop_while(self, context, *exec_ctx);
+    ContextPool::release(exec_ctx);
+    node->forget_invariants();
+    return result;
+}
+
+Completion ClosureCompiler::loop_while(Closure* self, Context& context, Context& exec_ctx)
+{
+    if (self->counted_loop != nullptr) return loop_counted(self, context, exec_ctx);
+
+    Closure* condition = self->operands[0];
+    Closure* body_closure = self->operands[1];
+    while (true)
+    {
+        bool is_true;
+        Completion completion = CompletionType::Normal;
+        if (!is_condition(condition, context, is_true, completion)) return completion;
+        if (!is_true) break;
+
+        Completion body = body_closure->run(body_closure, exec_ctx, false);
+        if (body.type == CompletionType::Break) break;
+        if (body.type != CompletionType::Continue)
+        {
+            if (!body.is_normal()) return body;
+            delete body.value;
+        }
+
+        if (TraceJit::run(exec_ctx, self->node) == TraceExit::Finished) break;
+    }
+    return None::make();
+}
+
+// Refer to Evaluator::evaluate_for.
+Completion ClosureCompiler::run_for(Closure* self, Context& context, bool is_used)
+{
+    ForExpressionSyntax* node = (ForExpressionSyntax*)self->node;
+    if (!self->scoped[0])
+    {
+        Completion result = loop_for(self, context);
+        node->forget_invariants();
+        return result;
+    }
+
+    Context* exec_ctx = ContextPool::acquire("for-loop", &context);
+    Completion result = loop_for(self, *exec_ctx);
+    ContextPool::release(exec_ctx);
+    node->forget_invariants();
+    return result;
+}
+
+Completion ClosureCompiler::loop_for(Closure* self, Context& exec_ctx)
+{
+    Closure* init_closure = self->operands[0];
+    Completion init = init_closure->run(init_closure, exec_ctx, false);
+    if (!init.is_normal()) return init;
+    delete init.value;
+
+    if (self->counted_loop != nullptr) return loop_counted(self, exec_ctx, exec_ctx);
+
+    Closure* condition = self->operands[1];
+    Closure* update_closure = self->operands[2];
+    Closure* body_closure = self->operands[3];
+    while (true)
+    {
+        bool is_true;
+        Completion completion = CompletionType::Normal;
+        if (!is_condition(condition, exec_ctx, is_true, completion)) return completion;
+        if (!is_true) break;
+
+        Completion body = body_closure->run(body_closure, exec_ctx, false);
+        if (body.type == CompletionType::Break) break;
+        if (body.type != CompletionType::Continue)
+        {
+            if (!body.is_normal()) return body;
+            delete body.value;
+        }
+
+        Completion update = update_closure->run(update_closure, exec_ctx, false);
+        if (!update.is_normal()) return update;
+        delete update.value;
+
+        if (TraceJit::run(exec_ctx, self->node) == TraceExit::Finished) break;
+    }
+    return None::make();
+}
+
+// Refer to Evaluator::evaluate_counted_loop.
+Completion ClosureCompiler::loop_counted(Closure* self, Context& context, Context& exec_ctx)
+{
+    CountedLoop* loop = self->counted_loop;
+    Closure* limit_closure = self->operands[self->counted];
+    Completion limit_obj = limit_closure->run(limit_closure, context, true);
+    if (!limit_obj.is_normal()) return limit_obj;
+    long long limit = ((Integer*)limit_obj.value)->get_value();
+    delete limit_obj.value;
+
+    Integer* counter = Evaluator::get_counter(context, loop->variable);
+    long long i = counter->get_value();
+    int n = self->operands.size();
+    while (Evaluator::compare_counter(loop->compare, i, limit))
+    {
+        if (loop->is_read) counter->set_value(i);
+        for (int k = self->counted+1; k < n; k++)
+        {
+            Closure* statement = self->operands[k];
+            Completion completion = statement->run(statement, exec_ctx, false);
+            if (completion.is_normal())
+            {
+                delete completion.value;
+                continue;
+            }
+
+            if (completion.type == CompletionType::Continue) break;
+
+            counter->set_value(i);
+            if (completion.type == CompletionType::Break) return None::make();
+            return completion;
+        }
+        i += loop->step;
+
+        counter->set_value(i);
+        TraceExit exit = TraceJit::run(exec_ctx, self->node);
+        if (exit == TraceExit::Finished) return None::make();
+        if (exit == TraceExit::NotEntered) continue;
+        counter = Evaluator::get_counter(context, loop->variable);
+        i = counter->get_value();
+    }
+
+    counter->set_value(i);
+    return None::make();
+}
+
+// The conditions and the bodies take turns in the operands, and the else body comes last.
+Completion ClosureCompiler::run_if(Closure* self, Context& context, bool is_used)
+{
+    int n = self->operands.size()/2;
+    for (int i = 0; i < n; i++)
+    {
+        bool is_true;
+        Completion completion = CompletionType::Normal;
+        if (!is_condition(self->operands[2*i], context, is_true, completion)) return completion;
+        if (is_true) return run_scoped(self->operands[2*i+1], context, "if-statement", self->scoped[i], is_used);
+    }
+
+    if (self->operands.size() % 2)
+        return run_scoped(self->operands.back(), context, "if-statement", self->scoped[n], is_used);
+
+    if (!is_used) return nullptr;
+    return None::make();
+}
+
+Completion ClosureCompiler::run_scoped(Closure* self, Context& context, const char* name, bool is_scoped, bool is_used)
+{
+    if (!is_scoped) return self->run(self, context, is_used);
+
+    Context* exec_ctx = ContextPool::acquire(name, &context);
+    Completion result = self->run(self, *exec_ctx, is_used);
+    ContextPool::release(exec_ctx);
+    return result;
+}
+
+Completion ClosureCompiler::run_return(Closure* self, Context& context, bool is_used)
+{
+    if (self->operands.empty()) return Completion(CompletionType::Return, None::make());
+
+    Closure* value_closure = self->operands[0];
+    Completion result = value_closure->run(value_closure, context, true);
+    if (!result.is_normal()) return result;
+    return Completion(CompletionType::Return, result.value);
+}
+
+Completion ClosureCompiler::run_break(Closure* self, Context& context, bool is_used)
+{
+    return CompletionType::Break;
+}
+
+Completion ClosureCompiler::run_continue(Closure* self, Context& context, bool is_used)
+{
+    return CompletionType::Continue;
+}
+
+// The function keeps pointing to its syntax node, the same as the evaluator's, so the two can share it.
+Completion ClosureCompiler::run_function_define(Closure* self, Context& context, bool is_used)
+{
+    Object* val = new Function(self->name, self->arg_names, ((FuncDefineExpressionSyntax*)self->node)->get_body());
+    context.get_symbol_table()->declare_object(self->name, val);
+    if (!is_used) return nullptr;
+    return val->copy();
+}
+
+// The compiled body of a function. A call usually runs the same function every time, so it remembers the last one.
+Closure* ClosureCompiler::find_body(Closure* self, SyntaxNode* body)
+{
+    if (self->body == body) return self->compiled_body;
+
+    auto it = _bodies.find(body);
+    Closure* compiled = it != _bodies.end() ? it->second : (_bodies[body] = compile(body));
+    self->body = body;
+    self->compiled_body = compiled;
+    return compiled;
+}
+
+// Refer to Evaluator::evaluate_function_call.
+Completion ClosureCompiler::run_function_call(Closure* self, Context& context, bool is_used)
+{
+    FuncCallExpressionSyntax* node = (FuncCallExpressionSyntax*)self->node;
+    ObjectSymbol obj_sym = context.get_symbol_table()->get_object(self->name);
+    if (obj_sym.object->type() != Type::FUNCTION)
+    {
+        DiagnosticBag::report_unexpected_type(type_to_string(obj_sym.object->type()), type_to_string(Type::FUNCTION),
+            node->get_identifier()->get_pos());
+        if (obj_sym.symbol == nullptr) delete obj_sym.object;
+        return CompletionType::Error;
+    }
+
+    Function* func = (Function*)obj_sym.object;
+    int n = func->get_argument_size();
+    if (n != (int)self->operands.size())
+    {
+        Evaluator::report_illegal_arguments(node, n, func->get_name());
+        return CompletionType::Error;
+    }
+
+    SyntaxNode* func_body = (SyntaxNode*)(func->get_body());
+    if (func_body != nullptr && func_body->kind() == SyntaxKind::LazyBodyExpression &&
+        !Evaluator::compile_body((LazyBodyExpressionSyntax*)func_body, func->get_argument_names()))
+        return CompletionType::Error;
+
+    if (self->is_copied) func = (Function*)func->copy();
+
+    std::vector<Object*> args;
+    args.reserve(n);
+    for (Closure* arg_closure : self->operands)
+    {
+        Completion arg = arg_closure->run(arg_closure, context, true);
+        if (!arg.is_normal())
+        {
+            for (auto &o : args)
+                delete o;
+            if (self->is_copied) delete func;
+            return arg;
+        }
+        args.push_back(arg.value);
+    }
+
+    Context* exec_ctx = ContextPool::acquire(func->get_name(), &context);
+    for (int i = 0; i < n; i++)
+        exec_ctx->get_symbol_table()->set_object(func->get_argument_name(i), args[i]);
+
+    func_body = (SyntaxNode*)(func->get_body());
+    if (self->is_copied) delete func;
+    if (func_body == nullptr)
+    {
+        ContextPool::release(exec_ctx);
+        return None::make();
+    }
+    if (func_body->kind() == SyntaxKind::LazyBodyExpression)
+        func_body = ((LazyBodyExpressionSyntax*)func_body)->get_body();
+
+    Closure* body_closure = find_body(self, func_body);
+    Completion body = body_closure->run(body_closure, *exec_ctx, false);
+    ContextPool::release(exec_ctx);
+
+    if (body.type == CompletionType::Return) return body.value;
+    if (!body.is_normal()) return body;
+    delete body.value;
+    return None::make();
+}
+
+// Refer to Evaluator::evaluate_inlined_call. The call is compiled too, and its arguments are used from there.
+Completion ClosureCompiler::run_inlined_call(Closure* self, Context& context, bool is_used)
+{
+    InlinedCallExpressionSyntax* node = (InlinedCallExpressionSyntax*)self->node;
+    Closure* call = self->operands[0];
+    ObjectSymbol obj_sym = context.get_symbol_table()->get_object(self->name);
+    if (obj_sym.object->type() != Type::FUNCTION ||
+        ((Function*)obj_sym.object)->get_body() != node->get_function()->get_body())
+    {
+        if (obj_sym.symbol == nullptr) delete obj_sym.object;
+        return call->run(call, context, is_used);
+    }
+
+    std::vector<Object*> args;
+    args.reserve(call->operands.size());
+    for (Closure* arg_closure : call->operands)
+    {
+        Completion arg = arg_closure->run(arg_closure, context, true);
+        if (!arg.is_normal())
+        {
+            for (auto &o : args)
+                delete o;
+            return arg;
+        }
+        args.push_back(arg.value);
+    }
+
+    node->set_arguments(args);
+    Closure* body = self->operands[1];
+    Completion result = body->run(body, context, true);
+    node->clear_arguments();
+    return result;
+}
+
+Completion ClosureCompiler::run_parameter(Closure* self, Context& context, bool is_used)
+{
+    return ((ParameterExpressionSyntax*)self->node)->get_argument()->copy();
+}
+
+// Refer to Evaluator::evaluate_builtin_call. The number of arguments was checked when it was compiled.
+Completion ClosureCompiler::run_builtin_call(Closure* self, Context& context, bool is_used)
+{
+    const BuiltIn* builtin = self->builtin;
+    int n = builtin->arity;
+    Object* args[BuiltInFunctions::MAX_ARITY];
+    for (int i = 0; i < n; i++)
+    {
+        Closure* arg_closure = self->operands[i];
+        Completion arg = arg_closure->run(arg_closure, context, true);
+        if (!arg.is_normal())
+        {
+            for (int j = 0; j < i; j++)
+                delete args[j];
+            return arg;
+        }
+        args[i] = arg.value;
+    }
+
+    Object* result = builtin->function(args);
+    for (int i = 0; i < n; i++)
+        delete args[i];
+
+    if (DiagnosticBag::size())
+    {
+        delete result;
+        return CompletionType::Error;
+    }
+    return result;
+}
+
+Completion ClosureCompiler::run_bad_arguments(Closure* self, Context& context, bool is_used)
+{
+    Evaluator::report_illegal_arguments((FuncCallExpressionSyntax*)self->node, self->builtin->arity,
+        self->builtin->name);
+    return CompletionType::Error;
+}
+
+Completion ClosureCompiler::run_none(Closure* self, Context& context, bool is_used)
+{
+    return None::make();
+}
+
+Completion ClosureCompiler::run_unknown(Closure* self, Context& context, bool is_used)
+{
+    DiagnosticBag::report_unknown_syntax(kind_to_string(self->node->kind()), self->node->get_pos());
+    return CompletionType::Error;
+}
@@ -0,0 +1,403 @@
+#pragma once
+
+#include "../Evaluators/evaluator.h"
+
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace Compilers
+{
+    // Refer to runtime.cpp.
+    class Runtime final
+    {
+    public:
+        // Thrown once an error is reported, it ends the program.
+        struct Error {};
+
+        // What a compiled function body is, Function objects point to one of these instead of a syntax node.
+        typedef Evaluators::Completion (*Body)(Contexts::Context& context);
+
+        // A context from the pool for a scoped body, given back when it goes out of scope.
+        class Scope final
+        {
+        private:
+            Contexts::Context* _context;
+        public:
+            Scope(Contexts::Context& parent, const char* name);
+            ~Scope();
+            Contexts::Context& get();
+        };
+
+        static int run(std::string_view script, Body program);
+
+        [[noreturn]] static void fail_binary(Objects::Type left, Syntax::SyntaxKind op_kind, Objects::Type right,
+            Diagnostics::Position pos);
+        [[noreturn]] static void fail_arguments(int actual, int expected, const std::string& name,
+            Diagnostics::Position pos);
+        static void check_assign(Objects::Object* value, Objects::Type type, Diagnostics::Position pos);
+
+        static long long take_integer(Objects::Object* value);
+        static long double take_number(Objects::Object* value);
+        static bool take_boolean(Objects::Object* value);
+        static long long divide(long long left, long long right, Syntax::SyntaxKind op_kind, Diagnostics::Position pos);
+        static long long modulo(long long left, long long right, Syntax::SyntaxKind op_kind, Diagnostics::Position pos);
+        static long double divide(long double left, long double right, Objects::Type left_type,
+            Objects::Type right_type, Syntax::SyntaxKind op_kind, Diagnostics::Position pos);
+
+        static Objects::Object* unary(Syntax::SyntaxKind op_kind, Objects::Object* operand, Diagnostics::Position pos);
+        static Objects::Object* binary(Syntax::SyntaxKind op_kind, Objects::Object* left, Objects::Object* right,
+            Diagnostics::Position pos);
+        static bool is_decided(Objects::Object* left, bool is_and);
+        static Objects::Object* logical(Syntax::SyntaxKind op_kind, Objects::Object* left, Objects::Object* right,
+            Diagnostics::Position pos);
+        static Objects::Object* index(Objects::Object* left, Objects::Object* right, Diagnostics::Position pos);
+        static bool condition(Objects::Object* value, Diagnostics::Position pos);
+
+        static Objects::Object* declare(Contexts::Context& context, const std::string& name, Objects::Type type,
+            bool is_used);
+        static Objects::Object* assign(Contexts::Context& context, const std::string& name, Objects::Object* value,
+            bool is_checked, bool is_used, Diagnostics::Position pos);
+        static Objects::Object* access(Contexts::Context& context, const std::string& name, Diagnostics::Position pos);
+
+        static Objects::Object* define(Contexts::Context& context, const std::string& name,
+            std::vector<std::string> arg_names, const Body* body, bool is_used);
+        static Objects::Function* find_function(Contexts::Context& context, const std::string& name, int arg_size,
+            Diagnostics::Position identifier, Diagnostics::Position args);
+        static Evaluators::Completion invoke(Contexts::Context& context, Objects::Function* function,
+            std::vector<Objects::Object*>& args, bool is_copied);
+        static Objects::Object* finish_builtin(Objects::Object* result, Objects::Object** args, int n);
+    };
+
+    // Refer to trace-jit.cpp.
+    struct Trace
+    {
+        union Cell
+        {
+            long long integer;
+            long double number;
+        };
+
+        struct Slot
+        {
+            std::string name;
+            Objects::Type type;
+            int cell;
+            bool is_written;
+        };
+
+        struct Constant
+        {
+            int cell;
+            Objects::Type type;
+            long long integer;
+            long double number;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<Constant> constants;
+        int cells;
+        int counter;
+        int (*code)(void* cells);
+        size_t size;
+
+        ~Trace();
+    };
+
+    // What a loop does after a back-edge.
+    enum class TraceExit
+    {
+        NotEntered,
+        Finished,
+        SideExit,
+    };
+
+    // Refer to trace-jit.cpp.
+    class TraceJit final
+    {
+    private:
+        enum class Step
+        {
+            Copy,
+            Unary,
+            Binary,
+            Guard,
+            LoopGuard,
+        };
+
+        struct Instruction
+        {
+            Step step;
+            Syntax::BoundUnaryOperator unary_op;
+            Syntax::BoundBinaryOperator op;
+            int dest;
+            int left;
+            int right;
+            Objects::Type left_type;
+            Objects::Type right_type;
+            bool expected;
+        };
+
+        struct Value
+        {
+            int cell;
+            Objects::Type type;
+            long long integer;
+            long double number;
+        };
+
+        enum class Recording
+        {
+            Recorded,
+            NotNow,
+            Untraceable,
+        };
+
+        Contexts::Context& _context;
+        Trace* _trace;
+        std::map<std::string, int> _slot_ids;
+        std::vector<Value> _values;
+        std::vector<Instruction> _instructions;
+        std::vector<unsigned char> _code;
+
+        int new_cell();
+        int find_slot(const std::string& name);
+        bool make_constant(Objects::Object* object, Value& value);
+        void add(Step step, int dest, int left, int right=-1);
+
+        Recording record_loop(Syntax::SyntaxNode* condition, Syntax::SyntaxNode* body, Syntax::SyntaxNode* update);
+        bool record(Syntax::SyntaxNode* node, Value* value);
+        bool record_unary(Syntax::UnaryExpressionSyntax* node, Value* value);
+        bool record_binary(Syntax::SyntaxNode* left_node, Syntax::SyntaxToken* op_token, Syntax::SyntaxNode* right_node,
+            Value* value);
+        bool record_logical(Syntax::SyntaxNode* left_node, bool is_and, Syntax::SyntaxNode* right_node, Value* value);
+        bool record_if(Syntax::IfExpressionSyntax* node);
+        static bool compute(Syntax::BoundBinaryOperator op, const Value& left, const Value& right, Value& result);
+        static long double get_number(const Value& value);
+
+        void emit(std::initializer_list<unsigned char> bytes);
+        void emit_cell(std::initializer_list<unsigned char> bytes, int cell);
+        void emit_jump(std::initializer_list<unsigned char> bytes, std::vector<size_t>& jumps);
+        void emit_push(int cell, Objects::Type type);
+        void emit_compare(int left, int right, unsigned char set);
+        void emit_unary(const Instruction& instruction);
+        void emit_binary(const Instruction& instruction, std::vector<size_t>& side_exits);
+        bool assemble();
+
+        static TraceExit enter(Contexts::Context& context, Trace* trace, Syntax::LoopHeat* heat);
+    public:
+        TraceJit(Contexts::Context& context);
+        ~TraceJit();
+        static TraceExit run(Contexts::Context& context, Syntax::SyntaxNode* loop);
+    };
+
+    // Refer to closure-compiler.cpp.
+    struct Closure
+    {
+        typedef Evaluators::Completion (*Run)(Closure* self, Contexts::Context& context, bool is_used);
+
+        Run run;
+        Syntax::SyntaxNode* node;
+        std::vector<Closure*> operands;
+        std::vector<bool> scoped;
+        Objects::Object* constant;
+        std::string name;
+        std::vector<std::string> arg_names;
+        const Evaluators::BuiltIn* builtin;
+        Syntax::CountedLoop* counted_loop;
+        int counted;
+        bool is_copied;
+        Syntax::SyntaxNode* body;
+        Closure* compiled_body;
+
+        Closure(Run _run, Syntax::SyntaxNode* _node);
+        ~Closure();
+    };
+
+    // Refer to closure-compiler.cpp.
+    class ClosureCompiler final
+    {
+    private:
+        static std::unordered_map<Syntax::SyntaxNode*, Closure*> _bodies;
+
+        static Closure* compile_loop(Closure* closure, Syntax::CountedLoop* loop);
+        static Closure::Run pick_unary(Syntax::SyntaxKind op_kind);
+        static Closure::Run pick_binary(Syntax::SyntaxKind op_kind);
+        static Closure::Run pick_bound_binary(Syntax::BoundBinaryOperator op);
+        static Closure::Run pick_var_declare(Objects::Type type);
+        static Closure* find_body(Closure* self, Syntax::SyntaxNode* body);
+
+        static Evaluators::Completion run_literal(Closure* self, Contexts::Context& context, bool is_used);
+        template <Syntax::SyntaxKind op_kind>
+        static Evaluators::Completion run_unary(Closure* self, Contexts::Context& context, bool is_used);
+        template <Objects::Operator op>
+        static Evaluators::Completion run_binary(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_unknown_binary(Closure* self, Contexts::Context& context, bool is_used);
+        template <bool is_and>
+        static Evaluators::Completion run_logical(Closure* self, Contexts::Context& context, bool is_used);
+        template <Syntax::BoundBinaryOperator op>
+        static Evaluators::Completion run_bound_binary(Closure* self, Contexts::Context& context, bool is_used);
+        template <bool is_and>
+        static Evaluators::Completion run_bound_logical(Closure* self, Contexts::Context& context, bool is_used);
+        template <Syntax::BoundBinaryOperator op>
+        static Objects::Object* bound_operation(Objects::Object* left, Objects::Object* right);
+        static Evaluators::Completion run_index(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_hoisted(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_list(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_sequence(Closure* self, Contexts::Context& context, bool is_used);
+        template <Objects::Type type>
+        static Evaluators::Completion run_var_declare(Closure* self, Contexts::Context& context, bool is_used);
+        template <bool is_checked>
+        static Evaluators::Completion run_var_assign(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_var_access(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_while(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion loop_while(Closure* self, Contexts::Context& context, Contexts::Context& exec_ctx);
+        static Evaluators::Completion run_for(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion loop_for(Closure* self, Contexts::Context& exec_ctx);
+        static Evaluators::Completion loop_counted(Closure* self, Contexts::Context& context,
+            Contexts::Context& exec_ctx);
+        static bool is_condition(Closure* condition, Contexts::Context& context, bool& is_true,
+            Evaluators::Completion& completion);
+        static Evaluators::Completion run_if(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_scoped(Closure* self, Contexts::Context& context, const char* name,
+            bool is_scoped, bool is_used);
+        static Evaluators::Completion run_return(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_break(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_continue(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_function_define(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_function_call(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_builtin_call(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_bad_arguments(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_inlined_call(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_parameter(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_none(Closure* self, Contexts::Context& context, bool is_used);
+        static Evaluators::Completion run_unknown(Closure* self, Contexts::Context& context, bool is_used);
+    public:
+        static Closure* compile(Syntax::SyntaxNode* node);
+        static Evaluators::Completion run(Contexts::Context& context, Syntax::SyntaxNode* root);
+        static void clear();
+    };
+
+    // Refer to cpp-emitter.cpp.
+    class CppEmitter final
+    {
+    private:
+        enum class ValueKind
+        {
+            Nothing,
+            Object,
+            Integer,
+            Double,
+            Boolean,
+        };
+
+        struct Value
+        {
+            ValueKind kind;
+            std::string code;
+        };
+
+        struct Declaration
+        {
+            Syntax::VarDeclareExpressionSyntax* node;
+            int unit;
+            int region;
+            bool is_direct;
+        };
+
+        struct Reference
+        {
+            int unit;
+            int region;
+            int start;
+        };
+
+        struct Usage
+        {
+            std::vector<Declaration> declarations;
+            std::vector<Reference> references;
+            bool is_excluded = false;
+        };
+
+        struct Native
+        {
+            ValueKind kind;
+            std::string name;
+        };
+
+        struct Loop
+        {
+            int id;
+            bool is_broken;
+            bool is_continued;
+        };
+
+        std::string_view _script;
+        std::string _filename;
+
+        std::map<std::string, Usage> _usages;
+        std::vector<int> _region_parents;
+        int _unit;
+        int _region;
+
+        std::map<std::string, Native> _natives;
+        std::map<std::string, std::string> _names;
+        std::ostringstream _constants;
+        std::ostringstream _prototypes;
+        std::ostringstream _functions;
+        std::ostringstream* _out;
+        int _indent;
+        int _temps;
+        int _bodies;
+        std::string _context;
+        std::vector<Loop> _loops;
+
+        void analyze(Syntax::SyntaxNode* node, bool is_direct);
+        int push_region();
+        void refer(const std::string& name, Syntax::SyntaxToken* identifier);
+        bool is_inside(int region, int outer) const;
+        void find_natives();
+
+        void line(const std::string& text);
+        std::string temp();
+        std::string name(const std::string& text);
+        static std::string quote(const std::string& text);
+        static std::string position(Diagnostics::Position pos);
+        static std::string native_type(ValueKind kind);
+        std::string type_code(const Value& value);
+        std::string box(const Value& value);
+        std::string to_native(const Value& value, ValueKind kind);
+        std::string to_condition(const Value& value, Syntax::SyntaxNode* node);
+        void discard(const Value& value);
+        void propagate(const std::string& completion);
+
+        static std::string native_constant(Objects::Object* object);
+        std::string emit_constant(Objects::Object* object);
+        std::string emit_body(Syntax::SyntaxNode* body, const std::string& name);
+        void emit_scoped(Syntax::SyntaxNode* node, const char* name, bool is_scoped);
+        Value emit(Syntax::SyntaxNode* node, bool is_used=true);
+        Value emit_literal(Syntax::LiteralExpressionSyntax* node);
+        Value emit_unary(Syntax::UnaryExpressionSyntax* node);
+        Value emit_binary(Syntax::BinaryExpressionSyntax* node);
+        Value emit_logical(Syntax::BinaryExpressionSyntax* node);
+        Value emit_bound_binary(Syntax::BoundBinaryExpressionSyntax* node);
+        Value emit_bound_operation(Syntax::BoundBinaryOperator op, const Value& left, const Value& right,
+            Syntax::SyntaxKind op_kind, Diagnostics::Position pos);
+        Value emit_sequence(Syntax::SequenceExpressionSyntax* node, bool is_used);
+        Value emit_index(Syntax::IndexExpressionSyntax* node);
+        Value emit_var_declare(Syntax::VarDeclareExpressionSyntax* node, bool is_used);
+        Value emit_var_assign(Syntax::VarAssignExpressionSyntax* node, bool is_used);
+        Value emit_var_access(Syntax::VarAccessExpressionSyntax* node);
+        Value emit_if(Syntax::IfExpressionSyntax* node, bool is_used);
+        Value emit_while(Syntax::WhileExpressionSyntax* node);
+        Value emit_for(Syntax::ForExpressionSyntax* node);
+        Value emit_function_define(Syntax::FuncDefineExpressionSyntax* node, bool is_used);
+        Value emit_function_call(Syntax::FuncCallExpressionSyntax* node);
+        Value emit_builtin_call(Syntax::FuncCallExpressionSyntax* node, const Evaluators::BuiltIn* builtin);
+        Value emit_return(Syntax::ReturnExpressionSyntax* node);
+        Value emit_jump(bool is_break);
+    public:
+        CppEmitter(std::string_view script, const std::string& filename);
+        std::string emit_program(Syntax::SyntaxNode* root);
+    };
+}
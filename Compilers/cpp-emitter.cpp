@@ -0,0 +1,1186 @@
+#include "compilers.h"
+#include "../Binding/binding.h"
+
+#include <climits>
+#include <cmath>
+#include <iomanip>
+
+using namespace Syntax;
+using namespace Diagnostics;
+using namespace Objects;
+using namespace Evaluators;
+using namespace Compilers;
+
+// This writes a bound program out as C++, which is built against the rest of the interpreter into its own binary.
+// Every expression becomes a few statements that keep their result in a temporary, so they still run in the
+// same order, and each error is reported the same way and ends the program. Refer to runtime.cpp.
+// Variables stay in the contexts, since a function sees the variables of whoever called it. The ones that can't
+// be seen from anywhere else become native locals instead, refer to find_natives.
+CppEmitter::CppEmitter(std::string_view script, const std::string& filename)
+    : _script(script), _filename(filename), _region_parents({-1}), _unit(0), _region(0), _out(nullptr), _indent(0),
+    _temps(0), _bodies(0) {}
+
+// A region is the part of the program a context is made for: the program, a function body, the body of an if or
+// a while, and a whole for-loop. Returns the region it was in.
+int CppEmitter::push_region()
+{
+    int region = _region;
+    _region_parents.push_back(_region);
+    _region = _region_parents.size()-1;
+    return region;
+}
+
+bool CppEmitter::is_inside(int region, int outer) const
+{
+    for (; region != -1; region = _region_parents[region])
+        if (region == outer) return true;
+    return false;
+}
+
+void CppEmitter::refer(const std::string& name, SyntaxToken* identifier)
+{
+    _usages[name].references.push_back({_unit, _region, identifier->get_pos().start});
+}
+
+// Finds where each variable is declared and used. A declaration is direct when it's a statement of its region,
+// so it runs every time the region does.
+void CppEmitter::analyze(SyntaxNode* node, bool is_direct)
+{
+    if (node == nullptr) return;
+
+    switch (node->kind())
+    {
+        case SyntaxKind::UnaryExpression:
+            analyze(((UnaryExpressionSyntax*)node)->get_operand(), false);
+            break;
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            analyze(t->get_left(), false);
+            analyze(t->get_right(), false);
+            break;
+        }
+        case SyntaxKind::BoundBinaryExpression:
+        {
+            BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)node;
+            analyze(t->get_left(), false);
+            analyze(t->get_right(), false);
+            break;
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            analyze(t->get_to_access(), false);
+            analyze(t->get_indexer(), false);
+            break;
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+                analyze(t->get_node(i), is_direct && !t->get_to_return());
+            break;
+        }
+        case SyntaxKind::VarDeclareExpression:
+        {
+            VarDeclareExpressionSyntax* t = (VarDeclareExpressionSyntax*)node;
+            _usages[t->get_identifier()->get_text()].declarations.push_back({t, _unit, _region, is_direct});
+            break;
+        }
+        case SyntaxKind::VarAssignExpression:
+        {
+            VarAssignExpressionSyntax* t = (VarAssignExpressionSyntax*)node;
+            refer(t->get_identifier()->get_text(), t->get_identifier());
+            analyze(t->get_value(), false);
+            break;
+        }
+        case SyntaxKind::VarAccessExpression:
+        {
+            VarAccessExpressionSyntax* t = (VarAccessExpressionSyntax*)node;
+            refer(t->get_identifier()->get_text(), t->get_identifier());
+            break;
+        }
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            int n = t->get_size();
+            for (int i = 0; i < n; i++)
+            {
+                analyze(t->get_condition(i), false);
+                int region = push_region();
+                analyze(t->get_body(i), true);
+                _region = region;
+            }
+            int region = push_region();
+            analyze(t->get_else_body(), true);
+            _region = region;
+            break;
+        }
+        case SyntaxKind::WhileExpression:
+        {
+            WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            analyze(t->get_condition(), false);
+            int region = push_region();
+            analyze(t->get_body(), true);
+            _region = region;
+            break;
+        }
+        case SyntaxKind::ForExpression:
+        {
+            ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            int region = push_region();
+            analyze(t->get_init(), true);
+            analyze(t->get_condition(), false);
+            analyze(t->get_update(), false);
+            analyze(t->get_body(), true);
+            _region = region;
+            break;
+        }
+        case SyntaxKind::FuncDefineExpression:
+        {
+            FuncDefineExpressionSyntax* t = (FuncDefineExpressionSyntax*)node;
+            _usages[t->get_identifier()->get_text()].is_excluded = true;
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                _usages[t->get_arg_name(i)->get_text()].is_excluded = true;
+
+            int unit = _unit;
+            int region = push_region();
+            _unit = _region;
+            analyze(t->get_body(), true);
+            _region = region;
+            _unit = unit;
+            break;
+        }
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            if (t->get_builtin() == nullptr) _usages[t->get_identifier()->get_text()].is_excluded = true;
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                analyze(t->get_arg(i), false);
+            break;
+        }
+        case SyntaxKind::ReturnExpression:
+            analyze(((ReturnExpressionSyntax*)node)->get_to_return(), false);
+            break;
+        case SyntaxKind::LazyBodyExpression:
+            analyze(((LazyBodyExpressionSyntax*)node)->get_body(), is_direct);
+            break;
+        default:
+            break;
+    }
+}
+
+// A boolean, integer or double variable is kept in a native local when nothing could tell the difference:
+// it's declared once in the whole program, by a statement of its region, and it's only ever used after that
+// in the same region of the same function. Nothing called from there can see it then, and it's never a function
+// or an argument.
+void CppEmitter::find_natives()
+{
+    for (auto& [name, usage] : _usages)
+    {
+        if (usage.is_excluded || usage.declarations.size() != 1 || !usage.declarations[0].is_direct) continue;
+
+        Declaration& declaration = usage.declarations[0];
+        ValueKind kind;
+        switch (SyntaxFacts::get_keyword_type(declaration.node->get_var_keyword()->kind()))
+        {
+            case Type::INTEGER:
+                kind = ValueKind::Integer;
+                break;
+            case Type::DOUBLE:
+                kind = ValueKind::Double;
+                break;
+            case Type::BOOLEAN:
+                kind = ValueKind::Boolean;
+                break;
+            default:
+                continue;
+        }
+
+        int start = declaration.node->get_identifier()->get_pos().start;
+        bool is_native = true;
+        for (Reference& reference : usage.references)
+        {
+            if (reference.unit != declaration.unit || !is_inside(reference.region, declaration.region) ||
+                reference.start < start)
+            {
+                is_native = false;
+                break;
+            }
+        }
+        if (!is_native) continue;
+
+        // The name is only kept when it can't be mistaken for anything else in C++.
+        std::string local = "v" + std::to_string(_natives.size());
+        bool is_plain = true;
+        for (char c : name)
+            is_plain &= (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        if (is_plain) local += "_" + name;
+        _natives[name] = {kind, local};
+    }
+}
+
+void CppEmitter::line(const std::string& text)
+{
+    *_out << std::string(_indent*4, ' ') << text << "\n";
+}
+
+std::string CppEmitter::temp()
+{
+    return "t" + std::to_string(++_temps);
+}
+
+// Each variable name is made into a string once, when the program starts.
+std::string CppEmitter::name(const std::string& text)
+{
+    auto it = _names.find(text);
+    if (it != _names.end()) return it->second;
+
+    std::string constant = "n" + std::to_string(_names.size());
+    _constants << "static const std::string " << constant << " = " << quote(text) << ";\n";
+    _names[text] = constant;
+    return constant;
+}
+
+std::string CppEmitter::quote(const std::string& text)
+{
+    std::string result = "\"";
+    for (unsigned char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+        }
+        else if (c >= 32 && c < 127 && c != '?')
+            result += c;
+        else
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\%03o", c);
+            result += escaped;
+        }
+    }
+    return result + "\"";
+}
+
+std::string CppEmitter::position(Position pos)
+{
+    return "Position(" + std::to_string(pos.start) + ", " + std::to_string(pos.end) + ")";
+}
+
+std::string CppEmitter::native_type(ValueKind kind)
+{
+    switch (kind)
+    {
+        case ValueKind::Integer:
+            return "long long";
+        case ValueKind::Double:
+            return "long double";
+        case ValueKind::Boolean:
+            return "bool";
+        default:
+            return "Object*";
+    }
+}
+
+// The type of a value as it would be an object. An object has to be asked before it's read.
+std::string CppEmitter::type_code(const Value& value)
+{
+    switch (value.kind)
+    {
+        case ValueKind::Integer:
+            return "Type::INTEGER";
+        case ValueKind::Double:
+            return "Type::DOUBLE";
+        case ValueKind::Boolean:
+            return "Type::BOOLEAN";
+        case ValueKind::Nothing:
+            return "Type::NONE";
+        default:
+        {
+            std::string t = temp();
+            line("Type " + t + " = " + value.code + "->type();");
+            return t;
+        }
+    }
+}
+
+std::string CppEmitter::box(const Value& value)
+{
+    switch (value.kind)
+    {
+        case ValueKind::Nothing:
+            return "None::make()";
+        case ValueKind::Integer:
+            return "Integer::make(" + value.code + ")";
+        case ValueKind::Double:
+            return "Double::make(" + value.code + ")";
+        case ValueKind::Boolean:
+            return "Boolean::make(" + value.code + ")";
+        default:
+            return value.code;
+    }
+}
+
+// Only for values the binder knows the type of.
+std::string CppEmitter::to_native(const Value& value, ValueKind kind)
+{
+    if (value.kind == kind) return value.code;
+    if (value.kind != ValueKind::Object) return "(" + native_type(kind) + ")" + value.code;
+
+    switch (kind)
+    {
+        case ValueKind::Integer:
+            return "Runtime::take_integer(" + value.code + ")";
+        case ValueKind::Double:
+            return "Runtime::take_number(" + value.code + ")";
+        default:
+            return "Runtime::take_boolean(" + value.code + ")";
+    }
+}
+
+std::string CppEmitter::to_condition(const Value& value, SyntaxNode* node)
+{
+    if (value.kind == ValueKind::Boolean) return value.code;
+    return "Runtime::condition(" + box(value) + ", " + position(node->get_pos()) + ")";
+}
+
+void CppEmitter::discard(const Value& value)
+{
+    if (value.kind == ValueKind::Object) line("delete " + value.code + ";");
+}
+
+// A 'break' or 'continue' that comes back from a call goes to the loop around it, or further up.
+void CppEmitter::propagate(const std::string& completion)
+{
+    if (_loops.empty())
+    {
+        line("if (!" + completion + ".is_normal()) return " + completion + ";");
+        return;
+    }
+
+    Loop& loop = _loops.back();
+    loop.is_broken = loop.is_continued = true;
+    line("if (" + completion + ".type == CompletionType::Break) goto break_" + std::to_string(loop.id) + ";");
+    line("if (" + completion + ".type == CompletionType::Continue) goto continue_" + std::to_string(loop.id) + ";");
+}
+
+std::string CppEmitter::emit_program(SyntaxNode* root)
+{
+    analyze(root, true);
+    find_natives();
+
+    std::ostringstream program;
+    _out = &program;
+    _indent = 1;
+    _context = "c0";
+    discard(emit(root, false));
+    line("return Completion(nullptr);");
+
+    std::ostringstream os;
+    os << "// Written by 'kalman --emit-cpp " << _filename << "'. Save it as script.cpp, since the interpreter\n";
+    os << "// has a program.cpp of its own, and build it in the interpreter's directory with:\n";
+    os << "//     make libkalman.a\n";
+    os << "//     g++ -O2 -std=c++17 -I. script.cpp libkalman.a -o script\n\n";
+    os << "#include \"Compilers/compilers.h\"\n\n";
+    os << "using namespace Objects;\nusing namespace Contexts;\nusing namespace Evaluators;\n";
+    os << "using namespace Compilers;\nusing Diagnostics::Position;\nusing Syntax::SyntaxKind;\n\n";
+
+    // The script is only there so the diagnostics can show where they happened.
+    os << "static const char SCRIPT[] =\n";
+    size_t start = 0;
+    while (start < _script.size())
+    {
+        size_t end = _script.find('\n', start);
+        end = end == std::string_view::npos ? _script.size() : end+1;
+        os << "    " << quote(std::string(_script.substr(start, end-start))) << "\n";
+        start = end;
+    }
+    os << "    \"\";\n\n";
+
+    os << _constants.str() << "\n" << _prototypes.str() << "\n" << _functions.str();
+    os << "static Completion program(Context& c0)\n{\n" << program.str() << "}\n\n";
+    os << "int main()\n{\n    return Runtime::run(std::string_view(SCRIPT, sizeof(SCRIPT)-1), program);\n}\n";
+    return os.str();
+}
+
+// Writes a function body as its own C++ function. Returns the name of what the Function object points to.
+std::string CppEmitter::emit_body(SyntaxNode* body, const std::string& name)
+{
+    std::string id = std::to_string(++_bodies);
+    std::ostringstream function;
+    std::ostringstream* out = _out;
+    int indent = _indent;
+    std::string context = _context;
+    std::vector<Loop> loops;
+    loops.swap(_loops);
+
+    _out = &function;
+    _indent = 1;
+    _context = "c0";
+    if (body->kind() == SyntaxKind::LazyBodyExpression) body = ((LazyBodyExpressionSyntax*)body)->get_body();
+    if (body != nullptr) discard(emit(body, false));
+    line("return Completion(nullptr);");
+
+    _out = out;
+    _indent = indent;
+    _context = context;
+    loops.swap(_loops);
+
+    _prototypes << "static Completion f" << id << "(Context& c0);\n";
+    _prototypes << "static const Runtime::Body body" << id << " = f" << id << ";\n";
+    _functions << "// " << name << "\nstatic Completion f" << id << "(Context& c0)\n{\n" << function.str() << "}\n\n";
+    return "body" + id;
+}
+
+// The body of an if, in a context of its own when it declares anything.
+void CppEmitter::emit_scoped(SyntaxNode* node, const char* name, bool is_scoped)
+{
+    line("{");
+    _indent++;
+    std::string context = _context;
+    if (is_scoped)
+    {
+        std::string scope = temp();
+        line("Runtime::Scope " + scope + "(" + _context + ", \"" + name + "\");");
+        _context = "c" + std::to_string(_temps);
+        line("Context& " + _context + " = " + scope + ".get();");
+    }
+    discard(emit(node, false));
+    _context = context;
+    _indent--;
+    line("}");
+}
+
+// Emits the statements of a node and returns where its value is. The value is a temporary, or a constant,
+// and the caller owns it when it's an object. Nothing stands for none, and for a value that isn't used.
+CppEmitter::Value CppEmitter::emit(SyntaxNode* node, bool is_used)
+{
+    switch (node->kind())
+    {
+        case SyntaxKind::LiteralExpression:
+            return emit_literal((LiteralExpressionSyntax*)node);
+        case SyntaxKind::UnaryExpression:
+            return emit_unary((UnaryExpressionSyntax*)node);
+        case SyntaxKind::BinaryExpression:
+            return emit_binary((BinaryExpressionSyntax*)node);
+        case SyntaxKind::BoundBinaryExpression:
+            return emit_bound_binary((BoundBinaryExpressionSyntax*)node);
+        case SyntaxKind::IndexExpression:
+            return emit_index((IndexExpressionSyntax*)node);
+        case SyntaxKind::SequenceExpression:
+            return emit_sequence((SequenceExpressionSyntax*)node, is_used);
+        case SyntaxKind::VarDeclareExpression:
+            return emit_var_declare((VarDeclareExpressionSyntax*)node, is_used);
+        case SyntaxKind::VarAssignExpression:
+            return emit_var_assign((VarAssignExpressionSyntax*)node, is_used);
+        case SyntaxKind::VarAccessExpression:
+            return emit_var_access((VarAccessExpressionSyntax*)node);
+        case SyntaxKind::ReturnExpression:
+            return emit_return((ReturnExpressionSyntax*)node);
+        case SyntaxKind::BreakExpression:
+            return emit_jump(true);
+        case SyntaxKind::ContinueExpression:
+            return emit_jump(false);
+        case SyntaxKind::WhileExpression:
+            return emit_while((WhileExpressionSyntax*)node);
+        case SyntaxKind::IfExpression:
+            return emit_if((IfExpressionSyntax*)node, is_used);
+        case SyntaxKind::ForExpression:
+            return emit_for((ForExpressionSyntax*)node);
+        case SyntaxKind::FuncDefineExpression:
+            return emit_function_define((FuncDefineExpressionSyntax*)node, is_used);
+        case SyntaxKind::FuncCallExpression:
+            return emit_function_call((FuncCallExpressionSyntax*)node);
+        default:
+            return {ValueKind::Nothing, ""};
+    }
+}
+
+// The C++ for an integer, a double or a boolean. Doubles are written in hex so they come back exactly.
+std::string CppEmitter::native_constant(Object* object)
+{
+    switch (object->type())
+    {
+        case Type::INTEGER:
+        {
+            long long value = ((Integer*)object)->get_value();
+            if (value == LLONG_MIN) return "(-9223372036854775807LL-1)";
+            return std::to_string(value) + "LL";
+        }
+        case Type::DOUBLE:
+        {
+            long double value = ((Double*)object)->get_value();
+            if (std::isnan(value)) return "std::numeric_limits<long double>::quiet_NaN()";
+            if (std::isinf(value))
+                return std::string(value < 0 ? "-" : "") + "std::numeric_limits<long double>::infinity()";
+            std::ostringstream os;
+            os << std::hexfloat << value << "L";
+            return os.str();
+        }
+        default:
+            return ((Boolean*)object)->get_value() ? "true" : "false";
+    }
+}
+
+// A constant object, built again every time like the evaluator copies it.
+std::string CppEmitter::emit_constant(Object* object)
+{
+    switch (object->type())
+    {
+        case Type::INTEGER:
+            return "Integer::make(" + native_constant(object) + ")";
+        case Type::DOUBLE:
+            return "Double::make(" + native_constant(object) + ")";
+        case Type::BOOLEAN:
+            return "Boolean::make(" + native_constant(object) + ")";
+        case Type::STRING:
+        {
+            std::string value = ((String*)object)->get_value();
+            return "new String(std::string(" + quote(value) + ", " + std::to_string(value.size()) + "))";
+        }
+        case Type::LIST:
+        {
+            std::vector<std::string> elements;
+            for (Object* element : ((List*)object)->get_values())
+                elements.push_back(emit_constant(element));
+
+            std::string t = temp();
+            std::string code = "std::vector<Object*> " + t + " = {";
+            for (size_t i = 0; i < elements.size(); i++)
+                code += (i ? ", " : "") + elements[i];
+            line(code + "};");
+            return "new List(" + t + ")";
+        }
+        default:
+            return "None::make()";
+    }
+}
+
+CppEmitter::Value CppEmitter::emit_literal(LiteralExpressionSyntax* node)
+{
+    Object* object = node->get_object();
+    switch (object->type())
+    {
+        case Type::INTEGER:
+            return {ValueKind::Integer, native_constant(object)};
+        case Type::DOUBLE:
+            return {ValueKind::Double, native_constant(object)};
+        case Type::BOOLEAN:
+            return {ValueKind::Boolean, native_constant(object)};
+        default:
+            return {ValueKind::Object, emit_constant(object)};
+    }
+}
+
+// A native operand gets the specialized operation for its type, anything else goes through the objects.
+CppEmitter::Value CppEmitter::emit_unary(UnaryExpressionSyntax* node)
+{
+    Value operand = emit(node->get_operand());
+    SyntaxKind op_kind = node->get_op_token()->kind();
+
+    BoundUnaryOperator op;
+    if (operand.kind != ValueKind::Object && operand.kind != ValueKind::Nothing)
+    {
+        Type type = operand.kind == ValueKind::Integer ? Type::INTEGER :
+            operand.kind == ValueKind::Double ? Type::DOUBLE : Type::BOOLEAN;
+        if (Binding::OperatorTypes::get_bound_unary_operator(op_kind, Binding::BoundType(type), op))
+        {
+            std::string code;
+            switch (op)
+            {
+                case BoundUnaryOperator::IntNegate:
+                case BoundUnaryOperator::DoubleNegate:
+                    code = "-" + operand.code;
+                    break;
+                case BoundUnaryOperator::BoolNot:
+                    code = "!" + operand.code;
+                    break;
+                default:
+                    code = operand.code;
+                    break;
+            }
+            std::string t = temp();
+            line(native_type(operand.kind) + " " + t + " = " + code + ";");
+            return {operand.kind, t};
+        }
+    }
+
+    std::string t = temp();
+    line("Object* " + t + " = Runtime::unary(" + kind_to_string(op_kind) + ", " + box(operand) + ", " +
+        position(node->get_pos()) + ");");
+    return {ValueKind::Object, t};
+}
+
+CppEmitter::Value CppEmitter::emit_binary(BinaryExpressionSyntax* node)
+{
+    SyntaxKind op_kind = node->get_op_token()->kind();
+    switch (op_kind)
+    {
+        case SyntaxKind::AndKeyword:
+        case SyntaxKind::DAmpersandToken:
+        case SyntaxKind::OrKeyword:
+        case SyntaxKind::DPipeToken:
+            return emit_logical(node);
+        default:
+            break;
+    }
+
+    Value left = emit(node->get_left());
+    Value right = emit(node->get_right());
+
+    auto get_type = [](const Value& value)
+    {
+        switch (value.kind)
+        {
+            case ValueKind::Integer:
+                return Binding::BoundType(Type::INTEGER);
+            case ValueKind::Double:
+                return Binding::BoundType(Type::DOUBLE);
+            case ValueKind::Boolean:
+                return Binding::BoundType(Type::BOOLEAN);
+            default:
+                return Binding::BoundType();
+        }
+    };
+    BoundBinaryOperator op;
+    if (Binding::OperatorTypes::get_bound_operator(op_kind, get_type(left), get_type(right), op))
+        return emit_bound_operation(op, left, right, op_kind, node->get_pos());
+
+    std::string t = temp();
+    line("Object* " + t + " = Runtime::binary(" + kind_to_string(op_kind) + ", " + box(left) + ", " + box(right) +
+        ", " + position(node->get_pos()) + ");");
+    return {ValueKind::Object, t};
+}
+
+// The right operand only runs when the left one doesn't decide it. Refer to evaluate_logical in evaluator.cpp.
+CppEmitter::Value CppEmitter::emit_logical(BinaryExpressionSyntax* node)
+{
+    SyntaxKind op_kind = node->get_op_token()->kind();
+    bool is_and = op_kind == SyntaxKind::AndKeyword || op_kind == SyntaxKind::DAmpersandToken;
+
+    Value left = emit(node->get_left());
+    std::string t = temp();
+    line("Object* " + t + " = " + box(left) + ";");
+    line("if (!Runtime::is_decided(" + t + ", " + (is_and ? "true" : "false") + "))");
+    line("{");
+    _indent++;
+    Value right = emit(node->get_right());
+    line(t + " = Runtime::logical(" + kind_to_string(op_kind) + ", " + t + ", " + box(right) + ", " +
+        position(node->get_pos()) + ");");
+    _indent--;
+    line("}");
+    return {ValueKind::Object, t};
+}
+
+CppEmitter::Value CppEmitter::emit_bound_binary(BoundBinaryExpressionSyntax* node)
+{
+    BoundBinaryOperator op = node->get_op();
+    if (op == BoundBinaryOperator::BoolAnd || op == BoundBinaryOperator::BoolOr)
+    {
+        Value left = emit(node->get_left());
+        std::string t = temp();
+        line("bool " + t + " = " + to_native(left, ValueKind::Boolean) + ";");
+        line(op == BoundBinaryOperator::BoolAnd ? "if (" + t + ")" : "if (!" + t + ")");
+        line("{");
+        _indent++;
+        Value right = emit(node->get_right());
+        line(t + " = " + to_native(right, ValueKind::Boolean) + ";");
+        _indent--;
+        line("}");
+        return {ValueKind::Boolean, t};
+    }
+
+    Value left = emit(node->get_left());
+    Value right = emit(node->get_right());
+    return emit_bound_operation(op, left, right, node->get_op_token()->kind(), node->get_pos());
+}
+
+// Computes a specialized operation on native values. Refer to apply_bound_binary in evaluator.cpp.
+CppEmitter::Value CppEmitter::emit_bound_operation(BoundBinaryOperator op, const Value& left, const Value& right,
+    SyntaxKind op_kind, Position pos)
+{
+    ValueKind operands;
+    switch (op)
+    {
+        case BoundBinaryOperator::IntAdd:
+        case BoundBinaryOperator::IntSubtract:
+        case BoundBinaryOperator::IntMultiply:
+        case BoundBinaryOperator::IntDivide:
+        case BoundBinaryOperator::IntModulo:
+        case BoundBinaryOperator::IntLess:
+        case BoundBinaryOperator::IntGreater:
+        case BoundBinaryOperator::IntLessEquals:
+        case BoundBinaryOperator::IntGreaterEquals:
+        case BoundBinaryOperator::IntEquals:
+        case BoundBinaryOperator::IntNotEquals:
+            operands = ValueKind::Integer;
+            break;
+        case BoundBinaryOperator::BoolAnd:
+        case BoundBinaryOperator::BoolOr:
+        case BoundBinaryOperator::BoolXor:
+        case BoundBinaryOperator::BoolEquals:
+        case BoundBinaryOperator::BoolNotEquals:
+            operands = ValueKind::Boolean;
+            break;
+        default:
+            operands = ValueKind::Double;
+            break;
+    }
+
+    // A division by zero reports the types of the operands, so they're read before the operands are.
+    std::string left_type, right_type;
+    if (op == BoundBinaryOperator::DoubleDivide)
+    {
+        left_type = type_code(left);
+        right_type = type_code(right);
+    }
+
+    std::string a = to_native(left, operands);
+    std::string b = to_native(right, operands);
+    std::string kind = kind_to_string(op_kind);
+    ValueKind result = ValueKind::Boolean;
+    std::string code;
+    switch (op)
+    {
+        case BoundBinaryOperator::IntAdd:
+        case BoundBinaryOperator::DoubleAdd:
+            code = a + " + " + b;
+            result = operands;
+            break;
+        case BoundBinaryOperator::IntSubtract:
+        case BoundBinaryOperator::DoubleSubtract:
+            code = a + " - " + b;
+            result = operands;
+            break;
+        case BoundBinaryOperator::IntMultiply:
+        case BoundBinaryOperator::DoubleMultiply:
+            code = a + " * " + b;
+            result = operands;
+            break;
+        case BoundBinaryOperator::IntDivide:
+            code = "Runtime::divide(" + a + ", " + b + ", " + kind + ", " + position(pos) + ")";
+            result = operands;
+            break;
+        case BoundBinaryOperator::IntModulo:
+            code = "Runtime::modulo(" + a + ", " + b + ", " + kind + ", " + position(pos) + ")";
+            result = operands;
+            break;
+        case BoundBinaryOperator::DoubleDivide:
+            code = "Runtime::divide(" + a + ", " + b + ", " + left_type + ", " + right_type + ", " + kind + ", " +
+                position(pos) + ")";
+            result = operands;
+            break;
+        case BoundBinaryOperator::IntLess:
+        case BoundBinaryOperator::DoubleLess:
+            code = a + " < " + b;
+            break;
+        case BoundBinaryOperator::IntGreater:
+        case BoundBinaryOperator::DoubleGreater:
+            code = a + " > " + b;
+            break;
+        case BoundBinaryOperator::IntLessEquals:
+            code = a + " <= " + b;
+            break;
+        case BoundBinaryOperator::IntGreaterEquals:
+            code = a + " >= " + b;
+            break;
+
+        // The same negated comparisons the objects use, so NaN compares the same.
+        case BoundBinaryOperator::DoubleLessEquals:
+            code = "!(" + a + " > " + b + ")";
+            break;
+        case BoundBinaryOperator::DoubleGreaterEquals:
+            code = "!(" + a + " < " + b + ")";
+            break;
+        case BoundBinaryOperator::DoubleNotEquals:
+            code = "!(" + a + " == " + b + ")";
+            break;
+        case BoundBinaryOperator::IntEquals:
+        case BoundBinaryOperator::DoubleEquals:
+        case BoundBinaryOperator::BoolEquals:
+            code = a + " == " + b;
+            break;
+        default:
+            code = a + " != " + b;
+            break;
+    }
+
+    std::string t = temp();
+    line(native_type(result) + " " + t + " = " + code + ";");
+    return {result, t};
+}
+
+CppEmitter::Value CppEmitter::emit_sequence(SequenceExpressionSyntax* node, bool is_used)
+{
+    int n = node->get_nodes_size();
+    if (node->get_to_return())
+    {
+        std::vector<std::string> elements;
+        for (int i = 0; i < n; i++)
+            elements.push_back(box(emit(node->get_node(i))));
+
+        std::string t = temp();
+        std::string code = "std::vector<Object*> " + t + "_elements = {";
+        for (int i = 0; i < n; i++)
+            code += (i ? ", " : "") + elements[i];
+        line(code + "};");
+        line("Object* " + t + " = new List(" + t + "_elements);");
+        return {ValueKind::Object, t};
+    }
+
+    for (int i = 0; i < n; i++)
+        discard(emit(node->get_node(i), false));
+    return {ValueKind::Nothing, ""};
+}
+
+CppEmitter::Value CppEmitter::emit_index(IndexExpressionSyntax* node)
+{
+    Value left = emit(node->get_to_access());
+    Value right = emit(node->get_indexer());
+    std::string t = temp();
+    line("Object* " + t + " = Runtime::index(" + box(left) + ", " + box(right) + ", " + position(node->get_pos()) +
+        ");");
+    return {ValueKind::Object, t};
+}
+
+CppEmitter::Value CppEmitter::emit_var_declare(VarDeclareExpressionSyntax* node, bool is_used)
+{
+    const std::string& text = node->get_identifier()->get_text();
+    auto it = _natives.find(text);
+    if (it != _natives.end())
+    {
+        Native& native = it->second;
+        std::string zero = native.kind == ValueKind::Boolean ? "false" : "0";
+        line(native_type(native.kind) + " " + native.name + " = " + zero + ";");
+        if (!is_used) return {ValueKind::Nothing, ""};
+        return {native.kind, zero};
+    }
+
+    std::string type = type_to_string(SyntaxFacts::get_keyword_type(node->get_var_keyword()->kind()));
+    std::string call = "Runtime::declare(" + _context + ", " + name(text) + ", " + type + ", " +
+        (is_used ? "true" : "false") + ");";
+    if (!is_used)
+    {
+        line(call);
+        return {ValueKind::Nothing, ""};
+    }
+    std::string t = temp();
+    line("Object* " + t + " = " + call);
+    return {ValueKind::Object, t};
+}
+
+CppEmitter::Value CppEmitter::emit_var_assign(VarAssignExpressionSyntax* node, bool is_used)
+{
+    Value value = emit(node->get_value());
+    const std::string& text = node->get_identifier()->get_text();
+    std::string pos = position(node->get_pos());
+
+    auto it = _natives.find(text);
+    if (it != _natives.end())
+    {
+        Native& native = it->second;
+        std::string type = native.kind == ValueKind::Integer ? "Type::INTEGER" :
+            native.kind == ValueKind::Double ? "Type::DOUBLE" : "Type::BOOLEAN";
+        if (value.kind == ValueKind::Object)
+        {
+            if (!node->is_type_checked()) line("Runtime::check_assign(" + value.code + ", " + type + ", " + pos + ");");
+            line(native.name + " = " + to_native(value, native.kind) + ";");
+        }
+        else if (value.kind == native.kind)
+            line(native.name + " = " + value.code + ";");
+        else
+        {
+            // The binder reports this before the program runs, it's only here to fail the same way.
+            line("Runtime::check_assign(" + box(value) + ", " + type + ", " + pos + ");");
+        }
+
+        if (!is_used) return {ValueKind::Nothing, ""};
+        std::string t = temp();
+        line(native_type(native.kind) + " " + t + " = " + native.name + ";");
+        return {native.kind, t};
+    }
+
+    std::string call = "Runtime::assign(" + _context + ", " + name(text) + ", " + box(value) + ", " +
+        (node->is_type_checked() ? "true" : "false") + ", " + (is_used ? "true" : "false") + ", " + pos + ");";
+    if (!is_used)
+    {
+        line(call);
+        return {ValueKind::Nothing, ""};
+    }
+    std::string t = temp();
+    line("Object* " + t + " = " + call);
+    return {ValueKind::Object, t};
+}
+
+// A native is copied, since an assignment later in the same expression would change it.
+CppEmitter::Value CppEmitter::emit_var_access(VarAccessExpressionSyntax* node)
+{
+    const std::string& text = node->get_identifier()->get_text();
+    std::string t = temp();
+    auto it = _natives.find(text);
+    if (it != _natives.end())
+    {
+        line(native_type(it->second.kind) + " " + t + " = " + it->second.name + ";");
+        return {it->second.kind, t};
+    }
+
+    line("Object* " + t + " = Runtime::access(" + _context + ", " + name(text) + ", " +
+        position(node->get_identifier()->get_pos()) + ");");
+    return {ValueKind::Object, t};
+}
+
+// Each condition only runs when the ones before it were false, so every 'elif' goes in the 'else' before it.
+CppEmitter::Value CppEmitter::emit_if(IfExpressionSyntax* node, bool is_used)
+{
+    int n = node->get_size();
+    int opened = 0;
+    for (int i = 0; i < n; i++)
+    {
+        Value condition = emit(node->get_condition(i));
+        line("if (" + to_condition(condition, node->get_condition(i)) + ")");
+        emit_scoped(node->get_body(i), "if-statement", node->is_scoped(i));
+        if (i+1 == n && node->get_else_body() == nullptr) break;
+
+        line("else");
+        line("{");
+        _indent++;
+        opened++;
+    }
+
+    if (node->get_else_body() != nullptr)
+        emit_scoped(node->get_else_body(), "if-statement", node->is_else_scoped());
+    for (; opened > 0; opened--)
+    {
+        _indent--;
+        line("}");
+    }
+    return {ValueKind::Nothing, ""};
+}
+
+// The condition runs in the context around the loop, and the body in the loop's own one.
+// A 'continue' goes to the end of the body, and a 'break' to right after the loop.
+CppEmitter::Value CppEmitter::emit_while(WhileExpressionSyntax* node)
+{
+    line("{");
+    _indent++;
+    std::string context = _context;
+    std::string exec_ctx = _context;
+    if (node->is_scoped())
+    {
+        std::string scope = temp();
+        line("Runtime::Scope " + scope + "(" + _context + ", \"while-loop\");");
+        exec_ctx = "c" + std::to_string(_temps);
+        line("Context& " + exec_ctx + " = " + scope + ".get();");
+    }
+
+    line("while (true)");
+    line("{");
+    _indent++;
+    Value condition = emit(node->get_condition());
+    line("if (!(" + to_condition(condition, node->get_condition()) + ")) break;");
+
+    _loops.push_back({++_temps, false, false});
+    _context = exec_ctx;
+    line("{");
+    _indent++;
+    discard(emit(node->get_body(), false));
+    _indent--;
+    line("}");
+    _context = context;
+    Loop loop = _loops.back();
+    _loops.pop_back();
+
+    if (loop.is_continued) line("continue_" + std::to_string(loop.id) + ": ;");
+    _indent--;
+    line("}");
+    if (loop.is_broken) line("break_" + std::to_string(loop.id) + ": ;");
+    _indent--;
+    line("}");
+    return {ValueKind::Nothing, ""};
+}
+
+// All of a for-loop runs in its context. A 'continue' still runs the update.
+CppEmitter::Value CppEmitter::emit_for(ForExpressionSyntax* node)
+{
+    line("{");
+    _indent++;
+    std::string context = _context;
+    if (node->is_scoped())
+    {
+        std::string scope = temp();
+        line("Runtime::Scope " + scope + "(" + _context + ", \"for-loop\");");
+        _context = "c" + std::to_string(_temps);
+        line("Context& " + _context + " = " + scope + ".get();");
+    }
+    discard(emit(node->get_init(), false));
+
+    line("while (true)");
+    line("{");
+    _indent++;
+    Value condition = emit(node->get_condition());
+    line("if (!(" + to_condition(condition, node->get_condition()) + ")) break;");
+
+    _loops.push_back({++_temps, false, false});
+    line("{");
+    _indent++;
+    discard(emit(node->get_body(), false));
+    _indent--;
+    line("}");
+    Loop loop = _loops.back();
+    _loops.pop_back();
+
+    if (loop.is_continued) line("continue_" + std::to_string(loop.id) + ": ;");
+    discard(emit(node->get_update(), false));
+    _indent--;
+    line("}");
+    if (loop.is_broken) line("break_" + std::to_string(loop.id) + ": ;");
+    _context = context;
+    _indent--;
+    line("}");
+    return {ValueKind::Nothing, ""};
+}
+
+CppEmitter::Value CppEmitter::emit_function_define(FuncDefineExpressionSyntax* node, bool is_used)
+{
+    const std::string& text = node->get_identifier()->get_text();
+    std::string body = emit_body(node->get_body(), text);
+
+    std::string arg_names = "{";
+    int n = node->get_arg_size();
+    for (int i = 0; i < n; i++)
+        arg_names += (i ? ", " : "") + quote(node->get_arg_name(i)->get_text());
+    arg_names += "}";
+
+    std::string call = "Runtime::define(" + _context + ", " + name(text) + ", " + arg_names + ", &" + body + ", " +
+        (is_used ? "true" : "false") + ");";
+    if (!is_used)
+    {
+        line(call);
+        return {ValueKind::Nothing, ""};
+    }
+    std::string t = temp();
+    line("Object* " + t + " = " + call);
+    return {ValueKind::Object, t};
+}
+
+// The function is looked up and checked before the arguments run, like in evaluate_function_call.
+CppEmitter::Value CppEmitter::emit_function_call(FuncCallExpressionSyntax* node)
+{
+    const BuiltIn* builtin = node->get_builtin();
+    if (builtin) return emit_builtin_call(node, builtin);
+
+    int m = node->get_arg_size();
+    std::string args_pos = m == 0 ? "Position()" :
+        position(Position(node->get_arg(0)->get_pos().start, node->get_arg(m-1)->get_pos().end));
+    std::string function = temp();
+    line("Function* " + function + " = Runtime::find_function(" + _context + ", " +
+        name(node->get_identifier()->get_text()) + ", " + std::to_string(m) + ", " +
+        position(node->get_identifier()->get_pos()) + ", " + args_pos + ");");
+    if (node->args_write()) line(function + " = (Function*)" + function + "->copy();");
+
+    std::vector<std::string> args;
+    for (int i = 0; i < m; i++)
+        args.push_back(box(emit(node->get_arg(i))));
+
+    std::string t = temp();
+    std::string code = "std::vector<Object*> " + t + "_args = {";
+    for (int i = 0; i < m; i++)
+        code += (i ? ", " : "") + args[i];
+    line(code + "};");
+    line("Completion " + t + " = Runtime::invoke(" + _context + ", " + function + ", " + t + "_args, " +
+        (node->args_write() ? "true" : "false") + ");");
+    propagate(t);
+    return {ValueKind::Object, t + ".value"};
+}
+
+// Builtins are called directly, with the arguments as objects.
+CppEmitter::Value CppEmitter::emit_builtin_call(FuncCallExpressionSyntax* node, const BuiltIn* builtin)
+{
+    int n = builtin->arity;
+    int m = node->get_arg_size();
+    if (n != m)
+    {
+        Position args_pos = m == 0 ? Position() :
+            Position(node->get_arg(0)->get_pos().start, node->get_arg(m-1)->get_pos().end);
+        line("Runtime::fail_arguments(" + std::to_string(m) + ", " + std::to_string(n) + ", " +
+            quote(builtin->name) + ", " + (m == 0 ? "Position()" : position(args_pos)) + ");");
+        return {ValueKind::Nothing, ""};
+    }
+
+    std::string function;
+    switch (node->get_identifier()->kind())
+    {
+        case SyntaxKind::PrintFunction:
+            function = "PRINT";
+            break;
+        case SyntaxKind::InputFunction:
+            function = "INPUT";
+            break;
+        case SyntaxKind::SplitFunction:
+            function = "SPLIT";
+            break;
+        case SyntaxKind::SizeFunction:
+            function = "SIZE";
+            break;
+        case SyntaxKind::TypeFunction:
+            function = "TYPE";
+            break;
+        case SyntaxKind::ToBoolFunction:
+            function = "TO_BOOL";
+            break;
+        case SyntaxKind::ToIntFunction:
+            function = "TO_INT";
+            break;
+        case SyntaxKind::ToDoubleFunction:
+            function = "TO_DOUBLE";
+            break;
+        case SyntaxKind::ToStringFunction:
+            function = "TO_STRING";
+            break;
+        default:
+            function = "SET_INDEX";
+            break;
+    }
+
+    std::vector<std::string> args;
+    for (int i = 0; i < n; i++)
+        args.push_back(box(emit(node->get_arg(i))));
+
+    std::string t = temp();
+    std::string code = "Object* " + t + "_args[" + std::to_string(n ? n : 1) + "] = {";
+    for (int i = 0; i < n; i++)
+        code += (i ? ", " : "") + args[i];
+    line(code + "};");
+    line("Object* " + t + " = Runtime::finish_builtin(BuiltInFunctions::" + function + "(" + t + "_args), " + t +
+        "_args, " + std::to_string(n) + ");");
+    return {ValueKind::Object, t};
+}
+
+CppEmitter::Value CppEmitter::emit_return(ReturnExpressionSyntax* node)
+{
+    std::string value = node->get_to_return() == nullptr ? "None::make()" : box(emit(node->get_to_return()));
+    line("return Completion(CompletionType::Return, " + value + ");");
+    return {ValueKind::Nothing, ""};
+}
+
+// Outside of a loop, the completion goes up to whoever called the function, or ends the program.
+CppEmitter::Value CppEmitter::emit_jump(bool is_break)
+{
+    const char* type = is_break ? "Break" : "Continue";
+    if (_loops.empty())
+    {
+        line(std::string("return Completion(CompletionType::") + type + ");");
+        return {ValueKind::Nothing, ""};
+    }
+
+    Loop& loop = _loops.back();
+    if (is_break) loop.is_broken = true;
+    else loop.is_continued = true;
+    line((is_break ? "goto break_" : "goto continue_") + std::to_string(loop.id) + ";");
+    return {ValueKind::Nothing, ""};
+}
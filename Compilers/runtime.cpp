@@ -0,0 +1,286 @@
+#include "compilers.h"
+
+using namespace Syntax;
+using namespace Contexts;
+using namespace Diagnostics;
+using namespace Objects;
+using namespace Evaluators;
+using namespace Compilers;
+
+// What the programs written by the CppEmitter link against. Each of these does what the evaluator does for the
+// same node, reports the same errors, and throws instead of returning an error completion.
+
+Runtime::Scope::Scope(Context& parent, const char* name) : _context(ContextPool::acquire(name, &parent)) {}
+
+Runtime::Scope::~Scope()
+{
+    ContextPool::release(_context);
+}
+
+Context& Runtime::Scope::get()
+{
+    return *_context;
+}
+
+// Runs the program the same way Evaluators::run does. The script is only kept for the diagnostics.
+int Runtime::run(std::string_view script, Body program)
+{
+    DiagnosticBag::set_script(script);
+    Context context("<program>", nullptr, SymbolTable(nullptr));
+    try
+    {
+        // A 'break', 'continue' or 'return' outside of where it belongs just ends the program.
+        Completion completion = program(context);
+        delete completion.value;
+    }
+    catch (const Error&) {}
+
+    DiagnosticBag::print();
+    DiagnosticBag::clear();
+    return 0;
+}
+
+void Runtime::fail_binary(Type left, SyntaxKind op_kind, Type right, Position pos)
+{
+    DiagnosticBag::report_illegal_binary_operation(type_to_string(left), kind_to_string(op_kind),
+        type_to_string(right), pos);
+    throw Error();
+}
+
+void Runtime::fail_arguments(int actual, int expected, const std::string& name, Position pos)
+{
+    DiagnosticBag::report_illegal_arguments(actual, expected, name, pos);
+    throw Error();
+}
+
+// A value going into a native variable whose assignment the binder couldn't check.
+void Runtime::check_assign(Object* value, Type type, Position pos)
+{
+    if (value->type() == type) return;
+    DiagnosticBag::report_invalid_assign(type_to_string(value->type()), type_to_string(type), pos);
+    delete value;
+    throw Error();
+}
+
+// These read a value the binder already knows the type of, and delete it.
+long long Runtime::take_integer(Object* value)
+{
+    long long result = ((Integer*)value)->get_value();
+    delete value;
+    return result;
+}
+
+long double Runtime::take_number(Object* value)
+{
+    long double result = value->type() == Type::INTEGER ? ((Integer*)value)->get_value() :
+        ((Double*)value)->get_value();
+    delete value;
+    return result;
+}
+
+bool Runtime::take_boolean(Object* value)
+{
+    bool result = ((Boolean*)value)->get_value();
+    delete value;
+    return result;
+}
+
+long long Runtime::divide(long long left, long long right, SyntaxKind op_kind, Position pos)
+{
+    if (right == 0) fail_binary(Type::INTEGER, op_kind, Type::INTEGER, pos);
+    return left / right;
+}
+
+long long Runtime::modulo(long long left, long long right, SyntaxKind op_kind, Position pos)
+{
+    if (right == 0) fail_binary(Type::INTEGER, op_kind, Type::INTEGER, pos);
+    return left % right;
+}
+
+long double Runtime::divide(long double left, long double right, Type left_type, Type right_type, SyntaxKind op_kind,
+    Position pos)
+{
+    if (right == 0) fail_binary(left_type, op_kind, right_type, pos);
+    return left / right;
+}
+
+Object* Runtime::unary(SyntaxKind op_kind, Object* operand, Position pos)
+{
+    Object* result = Evaluator::apply_unary(op_kind, operand);
+    if (result == nullptr || result->type() == Type::NONE)
+    {
+        DiagnosticBag::report_illegal_unary_operation(kind_to_string(op_kind), type_to_string(operand->type()), pos);
+        throw Error();
+    }
+    delete operand;
+    return result;
+}
+
+Object* Runtime::binary(SyntaxKind op_kind, Object* left, Object* right, Position pos)
+{
+    Object* result = Evaluator::apply_binary(op_kind, left, right);
+    if (result == nullptr || result->type() == Type::NONE) fail_binary(left->type(), op_kind, right->type(), pos);
+    delete left;
+    delete right;
+    return result;
+}
+
+// Whether the left operand of an 'and' or an 'or' decides it, so the right one isn't evaluated.
+bool Runtime::is_decided(Object* left, bool is_and)
+{
+    return left->type() == Type::BOOLEAN && ((Boolean*)left)->get_value() != is_and;
+}
+
+Object* Runtime::logical(SyntaxKind op_kind, Object* left, Object* right, Position pos)
+{
+    bool is_and = op_kind == SyntaxKind::AndKeyword || op_kind == SyntaxKind::DAmpersandToken;
+    Object* result = is_and ? left->and_with(right) : left->or_with(right);
+    if (result->type() == Type::NONE) fail_binary(left->type(), op_kind, right->type(), pos);
+    delete left;
+    delete right;
+    return result;
+}
+
+Object* Runtime::index(Object* left, Object* right, Position pos)
+{
+    Object* result = left->accessed_by(right);
+    if (result->type() == Type::NONE) fail_binary(left->type(), SyntaxKind::IndexExpression, right->type(), pos);
+    delete left;
+    delete right;
+    return result;
+}
+
+bool Runtime::condition(Object* value, Position pos)
+{
+    if (value->type() != Type::BOOLEAN)
+    {
+        DiagnosticBag::report_unexpected_type(type_to_string(value->type()), type_to_string(Type::BOOLEAN), pos);
+        throw Error();
+    }
+    return take_boolean(value);
+}
+
+Object* Runtime::declare(Context& context, const std::string& name, Type type, bool is_used)
+{
+    Object* value;
+    switch (type)
+    {
+        case Type::BOOLEAN:
+            value = Boolean::make(false);
+            break;
+        case Type::INTEGER:
+            value = Integer::make(0);
+            break;
+        case Type::DOUBLE:
+            value = new Double(0);
+            break;
+        case Type::STRING:
+            value = new String("");
+            break;
+        case Type::LIST:
+        {
+            std::vector<Object*> elems;
+            value = new List(elems);
+            break;
+        }
+        default:
+        {
+            std::vector<std::string> arg_names;
+            value = new Function("<uninitialized>", arg_names, nullptr);
+            break;
+        }
+    }
+
+    context.get_symbol_table()->declare_object(name, value);
+    if (!is_used) return nullptr;
+    return value->copy();
+}
+
+Object* Runtime::assign(Context& context, const std::string& name, Object* value, bool is_checked, bool is_used,
+    Position pos)
+{
+    ObjectSymbol obj_sym = context.get_symbol_table()->get_object(name);
+    if (!is_checked && (obj_sym.symbol == nullptr || obj_sym.object->type() != value->type()))
+    {
+        DiagnosticBag::report_invalid_assign(type_to_string(value->type()), type_to_string(obj_sym.object->type()),
+            pos);
+        throw Error();
+    }
+
+    delete obj_sym.object;
+    obj_sym.symbol->set_object(name, value);
+    if (!is_used) return nullptr;
+    return value->copy();
+}
+
+Object* Runtime::access(Context& context, const std::string& name, Position pos)
+{
+    Object* result = context.get_symbol_table()->get_object(name).object->copy();
+    if (result->type() == Type::NONE)
+    {
+        DiagnosticBag::report_undeclared_identifier(name, pos);
+        throw Error();
+    }
+    return result;
+}
+
+Object* Runtime::define(Context& context, const std::string& name, std::vector<std::string> arg_names,
+    const Body* body, bool is_used)
+{
+    Object* value = new Function(name, arg_names, (void*)body);
+    context.get_symbol_table()->declare_object(name, value);
+    if (!is_used) return nullptr;
+    return value->copy();
+}
+
+// The function being called, where it's stored. It's checked before any of the arguments are evaluated.
+Function* Runtime::find_function(Context& context, const std::string& name, int arg_size, Position identifier,
+    Position args)
+{
+    Object* object = context.get_symbol_table()->get_object(name).object;
+    if (object->type() != Type::FUNCTION)
+    {
+        DiagnosticBag::report_unexpected_type(type_to_string(object->type()), type_to_string(Type::FUNCTION),
+            identifier);
+        throw Error();
+    }
+
+    Function* function = (Function*)object;
+    if (function->get_argument_size() != arg_size)
+        fail_arguments(arg_size, function->get_argument_size(), function->get_name(), args);
+    return function;
+}
+
+// Calls a compiled function in a context whose parent is the caller's. A 'return' ends here, and a 'break'
+// or 'continue' goes on to the caller's loop.
+Completion Runtime::invoke(Context& context, Function* function, std::vector<Object*>& args, bool is_copied)
+{
+    Context* exec_ctx = ContextPool::acquire(function->get_name(), &context);
+    int n = args.size();
+    for (int i = 0; i < n; i++)
+        exec_ctx->get_symbol_table()->set_object(function->get_argument_name(i), args[i]);
+
+    const Body* body = (const Body*)function->get_body();
+    if (is_copied) delete function;
+    if (body == nullptr)
+    {
+        ContextPool::release(exec_ctx);
+        return None::make();
+    }
+
+    Completion result = (*body)(*exec_ctx);
+    ContextPool::release(exec_ctx);
+    if (result.type == CompletionType::Return) return result.value;
+    if (!result.is_normal()) return result;
+    delete result.value;
+    return None::make();
+}
+
+// Builtins report their own errors.
+Object* Runtime::finish_builtin(Object* result, Object** args, int n)
+{
+    for (int i = 0; i < n; i++)
+        delete args[i];
+    if (DiagnosticBag::size()) throw Error();
+    return result;
+}
@@ -0,0 +1,749 @@
+#include "compilers.h"
+#include "../Binding/binding.h"
+#include <cstring>
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+using namespace Syntax;
+using namespace Contexts;
+using namespace Objects;
+using namespace Evaluators;
+using namespace Compilers;
+
+// A tracing JIT for hot loops. Every loop counts its back-edges, and once it has gone around often enough the
+// next iteration is recorded: the recorder follows it on the current values of the variables without changing
+// any of them, and writes down each operation with the types it saw and which way each branch went. The trace
+// is then assembled into x86-64 code, which runs the loop on native values until its condition is false.
+// Only integers, booleans and doubles, arithmetic, comparisons, assignments and if-statements are traced.
+// Anything else leaves the loop with the evaluator for good.
+//
+// Every branch, and every divisor, has a guard that checks it goes the way it did in the recording. When one
+// fails the trace leaves, and since the variables are only written at the end of an iteration, the evaluator
+// runs that iteration again by itself. The loop gets back into the trace on its next back-edge.
+//
+// Each value has a cell of its own, where integers and booleans are 64-bit integers and doubles are the 80-bit
+// long doubles the objects hold, so the results are the same as the evaluator's.
+
+// How many back-edges a loop takes before it's traced.
+const long long HOT_BACK_EDGES = 64;
+
+// A trace that leaves after fewer iterations than this isn't worth much. After too many of those, the loop
+// stays with the evaluator.
+const long long MIN_TRACE_ITERATIONS = 16;
+const int MAX_BAD_EXITS = 8;
+
+const size_t MAX_TRACE_SIZE = 4096;
+
+TraceJit::TraceJit(Context& context) : _context(context), _trace(new Trace{{}, {}, 0, 0, nullptr, 0}) {}
+
+TraceJit::~TraceJit()
+{
+    delete _trace;
+}
+
+// The code is unmapped along with the trace, which its loop deletes.
+Trace::~Trace()
+{
+#if defined(__x86_64__) && !defined(_WIN32)
+    if (code != nullptr) munmap((void*)code, size);
+#endif
+}
+
+// Called on every back-edge of a loop. A trace is kept for as long as its loop is.
+TraceExit TraceJit::run(Context& context, SyntaxNode* loop)
+{
+    LoopHeat* heat;
+    SyntaxNode* condition;
+    SyntaxNode* body;
+    SyntaxNode* update = nullptr;
+    if (loop->kind() == SyntaxKind::WhileExpression)
+    {
+        WhileExpressionSyntax* t = (WhileExpressionSyntax*)loop;
+        heat = t->get_heat();
+        condition = t->get_condition();
+        body = t->get_body();
+
+        // The condition is evaluated outside of the body's context.
+        if (t->is_scoped()) heat->is_failed = true;
+    }
+    else
+    {
+        ForExpressionSyntax* t = (ForExpressionSyntax*)loop;
+        heat = t->get_heat();
+        condition = t->get_condition();
+        body = t->get_body();
+        update = t->get_update();
+    }
+    if (heat->is_failed || ++heat->back_edges < HOT_BACK_EDGES) return TraceExit::NotEntered;
+
+    if (heat->trace == nullptr)
+    {
+        TraceJit recorder(context);
+        Recording recording = recorder.record_loop(condition, body, update);
+        if (recording == Recording::NotNow) return TraceExit::NotEntered;
+        if (recording == Recording::Untraceable || !recorder.assemble())
+        {
+            heat->is_failed = true;
+            return TraceExit::NotEntered;
+        }
+        heat->trace = recorder._trace;
+        recorder._trace = nullptr;
+    }
+    return enter(context, heat->trace, heat);
+}
+
+// The variables are looked up every time, and have to hold the types the trace was recorded with.
+TraceExit TraceJit::enter(Context& context, Trace* trace, LoopHeat* heat)
+{
+    std::vector<ObjectSymbol> symbols;
+    std::vector<Trace::Cell> cells(trace->cells);
+    for (const Trace::Slot& slot : trace->slots)
+    {
+        ObjectSymbol obj_sym = context.get_symbol_table()->get_object(slot.name);
+        if (obj_sym.symbol == nullptr || obj_sym.object->type() != slot.type)
+        {
+            if (++heat->bad_exits > MAX_BAD_EXITS) heat->is_failed = true;
+            return TraceExit::NotEntered;
+        }
+
+        if (slot.type == Type::INTEGER)
+            cells[slot.cell].integer = ((Integer*)obj_sym.object)->get_value();
+        else if (slot.type == Type::BOOLEAN)
+            cells[slot.cell].integer = ((Boolean*)obj_sym.object)->get_value();
+        else
+            cells[slot.cell].number = ((Double*)obj_sym.object)->get_value();
+        symbols.push_back(obj_sym);
+    }
+    for (const Trace::Constant& constant : trace->constants)
+    {
+        if (constant.type == Type::DOUBLE)
+            cells[constant.cell].number = constant.number;
+        else
+            cells[constant.cell].integer = constant.integer;
+    }
+    cells[trace->counter].integer = 0;
+
+    int exit = trace->code(cells.data());
+
+    int n = trace->slots.size();
+    for (int i = 0; i < n; i++)
+    {
+        const Trace::Slot& slot = trace->slots[i];
+        if (!slot.is_written) continue;
+
+        Object* value;
+        if (slot.type == Type::INTEGER)
+            value = Integer::make(cells[slot.cell].integer);
+        else if (slot.type == Type::BOOLEAN)
+            value = Boolean::make(cells[slot.cell].integer);
+        else
+            value = new Double(cells[slot.cell].number);
+        delete symbols[i].object;
+        symbols[i].symbol->set_object(slot.name, value);
+    }
+
+    if (exit == 0) return TraceExit::Finished;
+    if (cells[trace->counter].integer < MIN_TRACE_ITERATIONS && ++heat->bad_exits > MAX_BAD_EXITS)
+        heat->is_failed = true;
+    return TraceExit::SideExit;
+}
+
+int TraceJit::new_cell()
+{
+    return _trace->cells++;
+}
+
+// The slot of a variable, found the first time the trace uses it. Returns -1 if it can't be traced.
+int TraceJit::find_slot(const std::string& name)
+{
+    auto it = _slot_ids.find(name);
+    if (it != _slot_ids.end()) return it->second;
+
+    ObjectSymbol obj_sym = _context.get_symbol_table()->get_object(name);
+    Type type = obj_sym.object->type();
+    if (obj_sym.symbol == nullptr || (type != Type::INTEGER && type != Type::BOOLEAN && type != Type::DOUBLE))
+        return -1;
+
+    Value value = {new_cell(), type, 0, 0};
+    if (type == Type::INTEGER)
+        value.integer = ((Integer*)obj_sym.object)->get_value();
+    else if (type == Type::BOOLEAN)
+        value.integer = ((Boolean*)obj_sym.object)->get_value();
+    else
+        value.number = ((Double*)obj_sym.object)->get_value();
+
+    int slot = _trace->slots.size();
+    _trace->slots.push_back({name, type, value.cell, false});
+    _values.push_back(value);
+    _slot_ids[name] = slot;
+    return slot;
+}
+
+bool TraceJit::make_constant(Object* object, Value& value)
+{
+    Type type = object->type();
+    value = {new_cell(), type, 0, 0};
+    if (type == Type::INTEGER)
+        value.integer = ((Integer*)object)->get_value();
+    else if (type == Type::BOOLEAN)
+        value.integer = ((Boolean*)object)->get_value();
+    else if (type == Type::DOUBLE)
+        value.number = ((Double*)object)->get_value();
+    else
+        return false;
+
+    _trace->constants.push_back({value.cell, type, value.integer, value.number});
+    return true;
+}
+
+void TraceJit::add(Step step, int dest, int left, int right)
+{
+    Instruction instruction = {step, BoundUnaryOperator::IntIdentity, BoundBinaryOperator::IntAdd, dest, left, right,
+        Type::NONE, Type::NONE, false};
+    _instructions.push_back(instruction);
+}
+
+// One iteration: the condition, the body and the update of a for-loop. It's only worth recording when the
+// condition is true.
+TraceJit::Recording TraceJit::record_loop(SyntaxNode* condition, SyntaxNode* body, SyntaxNode* update)
+{
+    _trace->counter = new_cell();
+
+    Value value;
+    if (!record(condition, &value) || value.type != Type::BOOLEAN) return Recording::Untraceable;
+    if (!value.integer) return Recording::NotNow;
+    add(Step::LoopGuard, -1, value.cell);
+
+    if (!record(body, nullptr)) return Recording::Untraceable;
+    if (update != nullptr && !record(update, nullptr)) return Recording::Untraceable;
+
+    // The variables are written at the end. One that gets another's old value has it copied first, in case
+    // the other one is written before it.
+    int n = _trace->slots.size();
+    std::vector<int> sources(n);
+    for (int i = 0; i < n; i++)
+    {
+        sources[i] = _values[i].cell;
+        if (!_trace->slots[i].is_written || sources[i] == _trace->slots[i].cell) continue;
+        for (const Trace::Slot& slot : _trace->slots)
+        {
+            if (slot.cell != sources[i]) continue;
+            sources[i] = new_cell();
+            add(Step::Copy, sources[i], slot.cell);
+            break;
+        }
+    }
+    for (int i = 0; i < n; i++)
+    {
+        if (_trace->slots[i].is_written && sources[i] != _trace->slots[i].cell)
+            add(Step::Copy, _trace->slots[i].cell, sources[i]);
+    }
+
+    if (_instructions.size() > MAX_TRACE_SIZE) return Recording::Untraceable;
+    return Recording::Recorded;
+}
+
+// Records a node, and gives its value when it's used. Returns false when the node can't be traced.
+bool TraceJit::record(SyntaxNode* node, Value* value)
+{
+    switch (node->kind())
+    {
+        case SyntaxKind::LiteralExpression:
+        {
+            Value constant;
+            if (!make_constant(((LiteralExpressionSyntax*)node)->get_object(), constant)) return false;
+            if (value != nullptr) *value = constant;
+            return true;
+        }
+        case SyntaxKind::UnaryExpression:
+            return record_unary((UnaryExpressionSyntax*)node, value);
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            SyntaxKind op_kind = t->get_op_token()->kind();
+            if (op_kind == SyntaxKind::AndKeyword || op_kind == SyntaxKind::DAmpersandToken)
+                return record_logical(t->get_left(), true, t->get_right(), value);
+            if (op_kind == SyntaxKind::OrKeyword || op_kind == SyntaxKind::DPipeToken)
+                return record_logical(t->get_left(), false, t->get_right(), value);
+            return record_binary(t->get_left(), t->get_op_token(), t->get_right(), value);
+        }
+        case SyntaxKind::BoundBinaryExpression:
+        {
+            BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)node;
+            if (t->get_op() == BoundBinaryOperator::BoolAnd)
+                return record_logical(t->get_left(), true, t->get_right(), value);
+            if (t->get_op() == BoundBinaryOperator::BoolOr)
+                return record_logical(t->get_left(), false, t->get_right(), value);
+            return record_binary(t->get_left(), t->get_op_token(), t->get_right(), value);
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            if (t->get_to_return() || value != nullptr) return false;
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+            {
+                if (!record(t->get_node(i), nullptr)) return false;
+            }
+            return true;
+        }
+        case SyntaxKind::VarAssignExpression:
+        {
+            VarAssignExpressionSyntax* t = (VarAssignExpressionSyntax*)node;
+            Value result;
+            if (!record(t->get_value(), &result)) return false;
+
+            int slot = find_slot(t->get_identifier()->get_text());
+            if (slot < 0 || result.type != _trace->slots[slot].type) return false;
+            _values[slot] = result;
+            _trace->slots[slot].is_written = true;
+            if (value != nullptr) *value = result;
+            return true;
+        }
+        case SyntaxKind::VarAccessExpression:
+        {
+            int slot = find_slot(((VarAccessExpressionSyntax*)node)->get_identifier()->get_text());
+            if (slot < 0) return false;
+            if (value != nullptr) *value = _values[slot];
+            return true;
+        }
+        case SyntaxKind::HoistedExpression:
+            // It's cheap enough to compute again in native code, and its variables are in the trace either way.
+            return record(((HoistedExpressionSyntax*)node)->get_expression(), value);
+        case SyntaxKind::IfExpression:
+            return value == nullptr && record_if((IfExpressionSyntax*)node);
+        case SyntaxKind::NoneExpression:
+            return value == nullptr;
+        default:
+            return false;
+    }
+}
+
+bool TraceJit::record_unary(UnaryExpressionSyntax* node, Value* value)
+{
+    Value operand;
+    if (!record(node->get_operand(), &operand)) return false;
+
+    BoundUnaryOperator op;
+    if (!Binding::OperatorTypes::get_bound_unary_operator(node->get_op_token()->kind(),
+        Binding::BoundType(operand.type), op))
+        return false;
+
+    Value result = {new_cell(), operand.type, operand.integer, operand.number};
+    if (op == BoundUnaryOperator::IntNegate)
+        result.integer = (long long)(0ULL - (unsigned long long)operand.integer);
+    else if (op == BoundUnaryOperator::DoubleNegate)
+        result.number = -operand.number;
+    else if (op == BoundUnaryOperator::BoolNot)
+        result.integer = !operand.integer;
+
+    add(Step::Unary, result.cell, operand.cell);
+    _instructions.back().unary_op = op;
+    _instructions.back().left_type = operand.type;
+    if (value != nullptr) *value = result;
+    return true;
+}
+
+bool TraceJit::record_binary(SyntaxNode* left_node, SyntaxToken* op_token, SyntaxNode* right_node, Value* value)
+{
+    Value left;
+    Value right;
+    if (!record(left_node, &left) || !record(right_node, &right)) return false;
+
+    BoundBinaryOperator op;
+    if (!Binding::OperatorTypes::get_bound_operator(op_token->kind(), Binding::BoundType(left.type),
+        Binding::BoundType(right.type), op))
+        return false;
+
+    // Whatever goes wrong here is for the evaluator to report.
+    Value result;
+    if (!compute(op, left, right, result)) return false;
+    result.cell = new_cell();
+
+    add(Step::Binary, result.cell, left.cell, right.cell);
+    _instructions.back().op = op;
+    _instructions.back().left_type = left.type;
+    _instructions.back().right_type = right.type;
+    if (value != nullptr) *value = result;
+    return true;
+}
+
+// The left operand is guarded, so the right one is only in the trace when the recording evaluated it.
+bool TraceJit::record_logical(SyntaxNode* left_node, bool is_and, SyntaxNode* right_node, Value* value)
+{
+    Value left;
+    if (!record(left_node, &left) || left.type != Type::BOOLEAN) return false;
+    add(Step::Guard, -1, left.cell);
+    _instructions.back().expected = left.integer;
+
+    if ((left.integer != 0) != is_and)
+    {
+        if (value != nullptr) *value = left;
+        return true;
+    }
+
+    Value right;
+    if (!record(right_node, &right) || right.type != Type::BOOLEAN) return false;
+    if (value != nullptr) *value = right;
+    return true;
+}
+
+// Only the branch the recording took is in the trace.
+bool TraceJit::record_if(IfExpressionSyntax* node)
+{
+    int n = node->get_size();
+    for (int i = 0; i < n; i++)
+    {
+        Value condition;
+        if (!record(node->get_condition(i), &condition) || condition.type != Type::BOOLEAN) return false;
+        add(Step::Guard, -1, condition.cell);
+        _instructions.back().expected = condition.integer;
+        if (condition.integer) return !node->is_scoped(i) && record(node->get_body(i), nullptr);
+    }
+
+    if (node->get_else_body() == nullptr) return true;
+    return !node->is_else_scoped() && record(node->get_else_body(), nullptr);
+}
+
+// Does what Evaluator::apply_bound_binary does. Returns false when the operation fails for these values.
+bool TraceJit::compute(BoundBinaryOperator op, const Value& left, const Value& right, Value& result)
+{
+    unsigned long long a = left.integer;
+    unsigned long long b = right.integer;
+    result = {-1, Type::BOOLEAN, 0, 0};
+    switch (op)
+    {
+        case BoundBinaryOperator::IntAdd:
+            result = {-1, Type::INTEGER, (long long)(a + b), 0};
+            return true;
+        case BoundBinaryOperator::IntSubtract:
+            result = {-1, Type::INTEGER, (long long)(a - b), 0};
+            return true;
+        case BoundBinaryOperator::IntMultiply:
+            result = {-1, Type::INTEGER, (long long)(a * b), 0};
+            return true;
+        case BoundBinaryOperator::IntDivide:
+            if (right.integer == 0) return false;
+            result = {-1, Type::INTEGER, left.integer / right.integer, 0};
+            return true;
+        case BoundBinaryOperator::IntModulo:
+            if (right.integer == 0) return false;
+            result = {-1, Type::INTEGER, left.integer % right.integer, 0};
+            return true;
+        case BoundBinaryOperator::IntLess:
+            result.integer = left.integer < right.integer;
+            return true;
+        case BoundBinaryOperator::IntGreater:
+            result.integer = left.integer > right.integer;
+            return true;
+        case BoundBinaryOperator::IntLessEquals:
+            result.integer = left.integer <= right.integer;
+            return true;
+        case BoundBinaryOperator::IntGreaterEquals:
+            result.integer = left.integer >= right.integer;
+            return true;
+        case BoundBinaryOperator::IntEquals:
+        case BoundBinaryOperator::BoolEquals:
+            result.integer = left.integer == right.integer;
+            return true;
+        case BoundBinaryOperator::IntNotEquals:
+        case BoundBinaryOperator::BoolNotEquals:
+        case BoundBinaryOperator::BoolXor:
+            result.integer = left.integer != right.integer;
+            return true;
+
+        case BoundBinaryOperator::DoubleAdd:
+            result = {-1, Type::DOUBLE, 0, get_number(left) + get_number(right)};
+            return true;
+        case BoundBinaryOperator::DoubleSubtract:
+            result = {-1, Type::DOUBLE, 0, get_number(left) - get_number(right)};
+            return true;
+        case BoundBinaryOperator::DoubleMultiply:
+            result = {-1, Type::DOUBLE, 0, get_number(left) * get_number(right)};
+            return true;
+        case BoundBinaryOperator::DoubleDivide:
+            if (get_number(right) == 0) return false;
+            result = {-1, Type::DOUBLE, 0, get_number(left) / get_number(right)};
+            return true;
+        case BoundBinaryOperator::DoubleLess:
+            result.integer = get_number(left) < get_number(right);
+            return true;
+        case BoundBinaryOperator::DoubleGreater:
+            result.integer = get_number(left) > get_number(right);
+            return true;
+        case BoundBinaryOperator::DoubleLessEquals:
+            result.integer = !(get_number(left) > get_number(right));
+            return true;
+        case BoundBinaryOperator::DoubleGreaterEquals:
+            result.integer = !(get_number(left) < get_number(right));
+            return true;
+        case BoundBinaryOperator::DoubleEquals:
+            result.integer = get_number(left) == get_number(right);
+            return true;
+        case BoundBinaryOperator::DoubleNotEquals:
+            result.integer = !(get_number(left) == get_number(right));
+            return true;
+        default:
+            return false;
+    }
+}
+
+long double TraceJit::get_number(const Value& value)
+{
+    if (value.type == Type::INTEGER) return value.integer;
+    return value.number;
+}
+
+// The machine code. The trace is called as 'int code(Trace::Cell* cells)', so the cells are addressed from rdi.
+// It only uses rax, rcx, rdx, xmm0 and the x87 stack, which it leaves empty, so it needs no prologue.
+void TraceJit::emit(std::initializer_list<unsigned char> bytes)
+{
+    _code.insert(_code.end(), bytes);
+}
+
+// An instruction whose operand is [rdi + disp32].
+void TraceJit::emit_cell(std::initializer_list<unsigned char> bytes, int cell)
+{
+    emit(bytes);
+    int disp = cell*sizeof(Trace::Cell);
+    for (int i = 0; i < 4; i++)
+        _code.push_back((disp >> (i*8)) & 0xFF);
+}
+
+// A jump whose rel32 is filled in once its target is known.
+void TraceJit::emit_jump(std::initializer_list<unsigned char> bytes, std::vector<size_t>& jumps)
+{
+    emit(bytes);
+    jumps.push_back(_code.size());
+    emit({0, 0, 0, 0});
+}
+
+// Loads a number onto the x87 stack. Integers are converted the same way as in get_number.
+void TraceJit::emit_push(int cell, Type type)
+{
+    if (type == Type::INTEGER)
+        emit_cell({0xDF, 0xAF}, cell);  // fild qword
+    else
+        emit_cell({0xDB, 0xAF}, cell);  // fld tword
+}
+
+void TraceJit::emit_compare(int left, int right, unsigned char set)
+{
+    emit_cell({0x48, 0x8B, 0x87}, left);    // mov rax, left
+    emit_cell({0x48, 0x8B, 0x8F}, right);   // mov rcx, right
+    emit({0x48, 0x39, 0xC8});               // cmp rax, rcx
+    emit({0x0F, set, 0xC0});                // setcc al
+}
+
+void TraceJit::emit_unary(const Instruction& instruction)
+{
+    switch (instruction.unary_op)
+    {
+        case BoundUnaryOperator::IntNegate:
+            emit_cell({0x48, 0x8B, 0x87}, instruction.left);
+            emit({0x48, 0xF7, 0xD8});               // neg rax
+            emit_cell({0x48, 0x89, 0x87}, instruction.dest);
+            break;
+        case BoundUnaryOperator::DoubleNegate:
+            emit_cell({0xDB, 0xAF}, instruction.left);
+            emit({0xD9, 0xE0});                     // fchs
+            emit_cell({0xDB, 0xBF}, instruction.dest);
+            break;
+        case BoundUnaryOperator::BoolNot:
+            emit_cell({0x48, 0x8B, 0x87}, instruction.left);
+            emit({0x48, 0x83, 0xF0, 0x01});         // xor rax, 1
+            emit_cell({0x48, 0x89, 0x87}, instruction.dest);
+            break;
+        default:
+            emit_cell({0x0F, 0x10, 0x87}, instruction.left);
+            emit_cell({0x0F, 0x11, 0x87}, instruction.dest);
+            break;
+    }
+}
+
+void TraceJit::emit_binary(const Instruction& instruction, std::vector<size_t>& side_exits)
+{
+    int left = instruction.left;
+    int right = instruction.right;
+    Type left_type = instruction.left_type;
+    Type right_type = instruction.right_type;
+    switch (instruction.op)
+    {
+        case BoundBinaryOperator::IntAdd:
+        case BoundBinaryOperator::IntSubtract:
+        case BoundBinaryOperator::IntMultiply:
+        case BoundBinaryOperator::BoolXor:
+            emit_cell({0x48, 0x8B, 0x87}, left);
+            emit_cell({0x48, 0x8B, 0x8F}, right);
+            if (instruction.op == BoundBinaryOperator::IntAdd)
+                emit({0x48, 0x01, 0xC8});           // add rax, rcx
+            else if (instruction.op == BoundBinaryOperator::IntSubtract)
+                emit({0x48, 0x29, 0xC8});           // sub rax, rcx
+            else if (instruction.op == BoundBinaryOperator::IntMultiply)
+                emit({0x48, 0x0F, 0xAF, 0xC1});     // imul rax, rcx
+            else
+                emit({0x48, 0x31, 0xC8});           // xor rax, rcx
+            emit_cell({0x48, 0x89, 0x87}, instruction.dest);
+            return;
+        case BoundBinaryOperator::IntDivide:
+        case BoundBinaryOperator::IntModulo:
+            emit_cell({0x48, 0x8B, 0x8F}, right);
+            emit({0x48, 0x85, 0xC9});               // test rcx, rcx
+            emit_jump({0x0F, 0x84}, side_exits);    // jz
+            emit_cell({0x48, 0x8B, 0x87}, left);
+            emit({0x48, 0x99});                     // cqo
+            emit({0x48, 0xF7, 0xF9});               // idiv rcx
+            if (instruction.op == BoundBinaryOperator::IntDivide)
+                emit_cell({0x48, 0x89, 0x87}, instruction.dest);
+            else
+                emit_cell({0x48, 0x89, 0x97}, instruction.dest);
+            return;
+
+        case BoundBinaryOperator::IntLess:
+            emit_compare(left, right, 0x9C);        // setl
+            break;
+        case BoundBinaryOperator::IntGreater:
+            emit_compare(left, right, 0x9F);        // setg
+            break;
+        case BoundBinaryOperator::IntLessEquals:
+            emit_compare(left, right, 0x9E);        // setle
+            break;
+        case BoundBinaryOperator::IntGreaterEquals:
+            emit_compare(left, right, 0x9D);        // setge
+            break;
+        case BoundBinaryOperator::IntEquals:
+        case BoundBinaryOperator::BoolEquals:
+            emit_compare(left, right, 0x94);        // sete
+            break;
+        case BoundBinaryOperator::IntNotEquals:
+        case BoundBinaryOperator::BoolNotEquals:
+            emit_compare(left, right, 0x95);        // setne
+            break;
+
+        case BoundBinaryOperator::DoubleAdd:
+        case BoundBinaryOperator::DoubleSubtract:
+        case BoundBinaryOperator::DoubleMultiply:
+        case BoundBinaryOperator::DoubleDivide:
+            if (instruction.op == BoundBinaryOperator::DoubleDivide)
+            {
+                emit_push(right, right_type);
+                emit({0xD9, 0xEE});                 // fldz
+                emit({0xDF, 0xF1});                 // fcomip st, st(1)
+                emit({0xDD, 0xD8});                 // fstp st(0)
+                emit({0x7A, 0x06});                 // jp over the jz, NaN isn't zero
+                emit_jump({0x0F, 0x84}, side_exits);
+            }
+            emit_push(left, left_type);
+            emit_push(right, right_type);
+            if (instruction.op == BoundBinaryOperator::DoubleAdd)
+                emit({0xDE, 0xC1});                 // faddp
+            else if (instruction.op == BoundBinaryOperator::DoubleSubtract)
+                emit({0xDE, 0xE9});                 // fsubp, st(1) - st
+            else if (instruction.op == BoundBinaryOperator::DoubleMultiply)
+                emit({0xDE, 0xC9});                 // fmulp
+            else
+                emit({0xDE, 0xF9});                 // fdivp, st(1) / st
+            emit_cell({0xDB, 0xBF}, instruction.dest);
+            return;
+
+        // fcomip sets the flags as if st were compared to st(1), and seta is false when either is NaN, so every
+        // comparison is made into an 'above', or its negation the same way the objects negate them.
+        default:
+        {
+            BoundBinaryOperator op = instruction.op;
+            bool is_swapped = op == BoundBinaryOperator::DoubleGreater || op == BoundBinaryOperator::DoubleLessEquals;
+            emit_push(is_swapped ? right : left, is_swapped ? right_type : left_type);
+            emit_push(is_swapped ? left : right, is_swapped ? left_type : right_type);
+            emit({0xDF, 0xF1});                     // fcomip st, st(1)
+            emit({0xDD, 0xD8});                     // fstp st(0)
+            if (op == BoundBinaryOperator::DoubleLess || op == BoundBinaryOperator::DoubleGreater)
+                emit({0x0F, 0x97, 0xC0});           // seta al
+            else if (op == BoundBinaryOperator::DoubleLessEquals || op == BoundBinaryOperator::DoubleGreaterEquals)
+                emit({0x0F, 0x96, 0xC0});           // setbe al
+            else
+            {
+                emit({0x0F, 0x94, 0xC0});           // sete al
+                emit({0x0F, 0x9B, 0xC1});           // setnp cl
+                emit({0x20, 0xC8});                 // and al, cl
+                if (op == BoundBinaryOperator::DoubleNotEquals)
+                    emit({0x34, 0x01});             // xor al, 1
+            }
+            break;
+        }
+    }
+
+    emit({0x0F, 0xB6, 0xC0});                       // movzx eax, al
+    emit_cell({0x48, 0x89, 0x87}, instruction.dest);
+}
+
+// Assembles the trace into executable memory. The iteration loops back to the start, and the two ways out
+// return 0 when the condition is false and 1 when a guard fails.
+bool TraceJit::assemble()
+{
+#if defined(__x86_64__) && !defined(_WIN32)
+    std::vector<size_t> finished;
+    std::vector<size_t> side_exits;
+    for (const Instruction& instruction : _instructions)
+    {
+        switch (instruction.step)
+        {
+            case Step::Copy:
+                emit_cell({0x0F, 0x10, 0x87}, instruction.left);    // movups xmm0, left
+                emit_cell({0x0F, 0x11, 0x87}, instruction.dest);    // movups dest, xmm0
+                break;
+            case Step::Unary:
+                emit_unary(instruction);
+                break;
+            case Step::Binary:
+                emit_binary(instruction, side_exits);
+                break;
+            case Step::Guard:
+            case Step::LoopGuard:
+                emit_cell({0x48, 0x8B, 0x87}, instruction.left);
+                emit({0x48, 0x85, 0xC0});                           // test rax, rax
+                if (instruction.step == Step::LoopGuard)
+                    emit_jump({0x0F, 0x84}, finished);
+                else
+                    emit_jump({0x0F, (unsigned char)(instruction.expected ? 0x84 : 0x85)}, side_exits);
+                break;
+        }
+    }
+    emit_cell({0x48, 0xFF, 0x87}, _trace->counter);                 // inc qword counter
+    emit({0xE9});                                                   // jmp to the start
+    int back = -(int)(_code.size() + 4);
+    for (int i = 0; i < 4; i++)
+        _code.push_back((back >> (i*8)) & 0xFF);
+
+    auto patch = [&](std::vector<size_t>& jumps)
+    {
+        int target = _code.size();
+        for (size_t at : jumps)
+        {
+            int rel = target - (int)(at + 4);
+            for (int i = 0; i < 4; i++)
+                _code[at+i] = (rel >> (i*8)) & 0xFF;
+        }
+    };
+    patch(finished);
+    emit({0x31, 0xC0, 0xC3});                                       // xor eax, eax; ret
+    patch(side_exits);
+    emit({0xB8, 0x01, 0x00, 0x00, 0x00, 0xC3});                     // mov eax, 1; ret
+
+    // Written first, then made executable.
+    void* memory = mmap(nullptr, _code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) return false;
+    std::memcpy(memory, _code.data(), _code.size());
+    if (mprotect(memory, _code.size(), PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(memory, _code.size());
+        return false;
+    }
+    _trace->code = (int (*)(void*))memory;
+    _trace->size = _code.size();
+    return true;
+#else
+    return false;
+#endif
+}
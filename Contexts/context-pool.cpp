@@ -0,0 +1,24 @@
+#include "context.h"
+
+using namespace Contexts;
+
+// Loops, conditionals and function calls all need a short-lived context. Instead of building a new one
+// every time, they borrow one from here and give it back when they're done, latest first.
+std::vector<Context*> ContextPool::_free;
+
+Context* ContextPool::acquire(const std::string& name, Context* parent)
+{
+    if (_free.empty()) return new Context(name, parent, SymbolTable(parent->get_symbol_table()));
+
+    Context* context = _free.back();
+    _free.pop_back();
+    context->reset(name, parent);
+    return context;
+}
+
+// The variables are deleted right away, like they would be when a context goes out of scope.
+void ContextPool::release(Context* context)
+{
+    context->get_symbol_table()->clear();
+    _free.push_back(context);
+}
@@ -19,4 +19,13 @@ Context* Context::get_parent() const
 SymbolTable* Context::get_symbol_table()
 {
     return &_symbol_table;
+}
+
+// Turns this into a fresh child of 'parent'. Only for contexts from the pool.
+void Context::reset(const std::string& name, Context* parent)
+{
+    _name = name;
+    _parent = parent;
+    _symbol_table.clear();
+    _symbol_table.set_parent(parent->get_symbol_table());
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "../Objects/object.h"
 #include <map>
+#include <vector>
 
 namespace Contexts
 {
@@ -25,10 +26,13 @@ namespace Contexts
         SymbolTable(SymbolTable* parent);
         ~SymbolTable();
         
-        ObjectSymbol get_object(const std::string name);
-        void set_object(const std::string name, Objects::Object* object);
+        ObjectSymbol get_object(const std::string& name);
+        void set_object(const std::string& name, Objects::Object* object);
+        void declare_object(const std::string& name, Objects::Object* object);
+        void clear();
 
         SymbolTable* get_parent() const;
+        void set_parent(SymbolTable* parent);
     };
 
     // Refer to context.cpp.
@@ -44,5 +48,16 @@ namespace Contexts
         std::string get_name() const;
         Context* get_parent() const;
         SymbolTable* get_symbol_table();
+        void reset(const std::string& name, Context* parent);
+    };
+
+    // Refer to context-pool.cpp.
+    class ContextPool final
+    {
+    private:
+        static std::vector<Context*> _free;
+    public:
+        static Context* acquire(const std::string& name, Context* parent);
+        static void release(Context* context);
     };
 }
\ No newline at end of file
@@ -17,19 +17,46 @@ SymbolTable::~SymbolTable()
 }
 
 // Grabs objects from parent symbol table if it doesn't exist.
-ObjectSymbol SymbolTable::get_object(const std::string name)
+ObjectSymbol SymbolTable::get_object(const std::string& name)
 {
-    if (_table.count(name) > 0) return ObjectSymbol(_table.at(name), this);
+    auto it = _table.find(name);
+    if (it != _table.end()) return ObjectSymbol(it->second, this);
     if (_parent) return _parent->get_object(name);
-    return ObjectSymbol(new None(), NULL);
+    return ObjectSymbol(None::make(), NULL);
 }
 
-void SymbolTable::set_object(const std::string name, Object* object)
+void SymbolTable::set_object(const std::string& name, Object* object)
 {
     _table[name] = object;
 }
 
+// Declaring only replaces a variable in this table. A variable with the same name further out is shadowed.
+void SymbolTable::declare_object(const std::string& name, Object* object)
+{
+    auto it = _table.find(name);
+    if (it != _table.end()) 
+    {
+        delete it->second;
+        it->second = object;
+        return;
+    }
+    _table[name] = object;
+}
+
+// Deletes every variable so the table can be used again.
+void SymbolTable::clear()
+{
+    for (auto &it : _table)
+        delete it.second;
+    _table.clear();
+}
+
 SymbolTable* SymbolTable::get_parent() const
 {
     return _parent;
+}
+
+void SymbolTable::set_parent(SymbolTable* parent)
+{
+    _parent = parent;
 }
\ No newline at end of file
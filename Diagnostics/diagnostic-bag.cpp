@@ -2,17 +2,51 @@
 
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 using namespace Diagnostics;
 
-// The current script that's being interpreted.
-std::string DiagnosticBag::script = "";
+// The current script that's being interpreted. It's a view of the buffer the script was read into,
+// which stays alive until the run is over.
+std::string_view DiagnosticBag::_script;
+
+// Where each line of the script starts. It's only built once a diagnostic needs a line and column.
+std::vector<int> DiagnosticBag::_line_starts;
 
 // I made this static so I just have one bag for the entire program.
 std::vector<Diagnostic> DiagnosticBag::_diagnostics = std::vector<Diagnostic>(); 
 
+// Where the errors reported on this thread go. It's the bag, except on a thread that parses part of a script.
+thread_local std::vector<Diagnostic>* DiagnosticBag::_reports = &DiagnosticBag::_diagnostics;
+
 DiagnosticBag::DiagnosticBag() {}
 
+void DiagnosticBag::set_script(std::string_view script)
+{
+    _script = script;
+    _line_starts.clear();
+}
+
+std::string_view DiagnosticBag::get_script()
+{
+    return _script;
+}
+
+// Both start at 0. An offset past the end of the script counts from the last line.
+void DiagnosticBag::get_line_col(int offset, int& ln, int& col)
+{
+    if (_line_starts.empty())
+    {
+        _line_starts.push_back(0);
+        for (size_t i = 0; i < _script.size(); i++)
+            if (_script[i] == '\n') _line_starts.push_back(i+1);
+    }
+
+    auto it = std::upper_bound(_line_starts.begin(), _line_starts.end(), offset);
+    ln = (it - _line_starts.begin()) - 1;
+    col = offset - _line_starts[ln];
+}
+
 int DiagnosticBag::size()
 {
     return _diagnostics.size();
@@ -31,16 +65,28 @@ std::vector<Diagnostic> DiagnosticBag::diagnostics()
 // Adds an error to the bag.
 void DiagnosticBag::report(std::string message, Position pos)
 {
-    _diagnostics.push_back(Diagnostic(message, pos));
+    _reports->push_back(Diagnostic(message, pos));
+}
+
+// Sends the errors reported on this thread somewhere else, or back to the bag when it's given nothing.
+// Refer to parallel-parser.cpp.
+void DiagnosticBag::collect_into(std::vector<Diagnostic>* reports)
+{
+    _reports = reports != nullptr ? reports : &_diagnostics;
+}
+
+void DiagnosticBag::add(const std::vector<Diagnostic>& diagnostics)
+{
+    _diagnostics.insert(_diagnostics.end(), diagnostics.begin(), diagnostics.end());
 }
 
-// Prints all the errors.
-void DiagnosticBag::print()
+// Prints all the errors, to the standard output unless another stream is given.
+void DiagnosticBag::print(std::ostream& out)
 {
     int n = _diagnostics.size();
     for (int i = 0; i < n; i++)
-        std::cout << _diagnostics[i].get_message() << std::endl;
-    if (n) std::cout << std::endl;
+        out << _diagnostics[i].get_message() << std::endl;
+    if (n) out << std::endl;
 }
 
 // Resets everything.
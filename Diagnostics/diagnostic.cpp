@@ -8,12 +8,17 @@ Diagnostic::Diagnostic(std::string& message, Position pos) : _message(message),
 std::string Diagnostic::get_message() const
 {
     std::ostringstream os;
-    if (_pos.ln != -1) os << "In line " << _pos.ln+1 << ", col " << _pos.col+1 << " ";
+    if (_pos.start != -1)
+    {
+        int ln, col;
+        DiagnosticBag::get_line_col(_pos.start, ln, col);
+        os << "In line " << ln+1 << ", col " << col+1 << " ";
+    }
     os << _message;
 
     if (_pos.start == -1) return os.str();
     
-    std::string text = DiagnosticBag::script.substr(_pos.start, _pos.end-_pos.start);
+    std::string text(DiagnosticBag::get_script().substr(_pos.start, _pos.end-_pos.start));
     if (!text.empty()) os << "\n\n   " << text << "\n";
     return os.str();
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <iostream>
 
 #include "position.h"
 
@@ -23,16 +25,25 @@ namespace Diagnostics
     {
     private:
         static std::vector<Diagnostic> _diagnostics;
+        static thread_local std::vector<Diagnostic>* _reports;
+        static std::string_view _script;
+        static std::vector<int> _line_starts;
         static void report(std::string message, Position pos);
     public:
         DiagnosticBag();
-        static std::string script;
+
+        static void set_script(std::string_view script);
+        static std::string_view get_script();
+        static void get_line_col(int offset, int& ln, int& col);
 
         static int size();
         static Diagnostic diagnostic(int i);
         static std::vector<Diagnostic> diagnostics();
-        static void print();
+        static void print(std::ostream& out = std::cout);
         static void clear();
+
+        static void collect_into(std::vector<Diagnostic>* reports);
+        static void add(const std::vector<Diagnostic>& diagnostics);
         
         static void report_bad_character(char c, Position pos);
         static void report_invalid_type(std::string text, std::string type, Position pos);
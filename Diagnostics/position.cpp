@@ -2,8 +2,10 @@
 
 using Diagnostics::Position;
 
-Position::Position(int _ln, int _col, int _start, int _end)
-    : ln(_ln), col(_col), start(_start), end(_end) {}
+// A position is where the text starts and ends in the script. The line and column are only worked out
+// when a diagnostic gets printed. Refer to diagnostic-bag.cpp.
+Position::Position(int _start, int _end)
+    : start(_start), end(_end) {}
 
 Position::Position()
-    : ln(-1), col(-1), start(-1), end(-1) {}
\ No newline at end of file
+    : start(-1), end(-1) {}
\ No newline at end of file
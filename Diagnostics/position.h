@@ -6,9 +6,9 @@ namespace Diagnostics
 {
     struct Position
     {
-        int ln, col, start, end;
+        int start, end;
 
-        Position(int _ln, int _col, int _start, int _end);
+        Position(int _start, int _end);
         Position();
     };
 }
\ No newline at end of file
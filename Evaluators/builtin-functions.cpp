@@ -6,20 +6,45 @@
 
 using namespace Objects;
 using namespace Diagnostics;
-using namespace Contexts;
 using namespace Evaluators;
 using namespace Syntax;
 
+// The registry is indexed by the builtin's SyntaxKind, so the order here must follow the enum in syntax.h.
+// The return type is the type of the result when the call doesn't fail. A pure builtin only depends on its
+// arguments and does nothing else, so the same arguments always give the same result.
+const BuiltIn BuiltInFunctions::_registry[] =
+{
+    {BI_PRINT,      1, Type::NONE,      false,  BuiltInFunctions::PRINT},
+    {BI_INPUT,      0, Type::STRING,    false,  BuiltInFunctions::INPUT},
+    {BI_SPLIT,      2, Type::LIST,      true,   BuiltInFunctions::SPLIT},
+    {BI_SIZE,       1, Type::INTEGER,   true,   BuiltInFunctions::SIZE},
+    {BI_TYPE,       1, Type::STRING,    true,   BuiltInFunctions::TYPE},
+    {BI_TO_BOOL,    1, Type::BOOLEAN,   true,   BuiltInFunctions::TO_BOOL},
+    {BI_TO_INT,     1, Type::INTEGER,   true,   BuiltInFunctions::TO_INT},
+    {BI_TO_DOUBLE,  1, Type::DOUBLE,    true,   BuiltInFunctions::TO_DOUBLE},
+    {BI_TO_STRING,  1, Type::STRING,    true,   BuiltInFunctions::TO_STRING},
+    {BI_SET_INDEX,  3, Type::LIST,      true,   BuiltInFunctions::SET_INDEX}
+};
+
+// Returns nullptr when the kind is not a builtin function.
+const BuiltIn* BuiltInFunctions::get_builtin(SyntaxKind kind)
+{
+    int i = (int)kind - (int)SyntaxKind::PrintFunction;
+    int n = sizeof(_registry)/sizeof(_registry[0]);
+    if (i < 0 || i >= n) return nullptr;
+    return &_registry[i];
+}
+
 // Prints to the screen.
-Object* BuiltInFunctions::PRINT(Context& context)
+Object* BuiltInFunctions::PRINT(Object** args)
 {
-    Object* obj = context.get_symbol_table()->get_object("value").object;
+    Object* obj = args[0];
     std::cout << obj->to_string() << std::endl;
-    return new None();
+    return None::make();
 }
 
 // Reads a line as a string.
-Object* BuiltInFunctions::INPUT(Context& context)
+Object* BuiltInFunctions::INPUT(Object** args)
 {
     std::string val;
     getline(std::cin, val);
@@ -27,10 +52,10 @@ Object* BuiltInFunctions::INPUT(Context& context)
 }
 
 // Splits the string into a list of words
-Object* BuiltInFunctions::SPLIT(Context& context)
+Object* BuiltInFunctions::SPLIT(Object** args)
 {
-    Object* obj = context.get_symbol_table()->get_object("value").object;
-    Object* delimiter = context.get_symbol_table()->get_object("delimiter").object;
+    Object* obj = args[0];
+    Object* delimiter = args[1];
 
     switch(obj->type())
     {
@@ -39,7 +64,7 @@ Object* BuiltInFunctions::SPLIT(Context& context)
             if (delimiter->type() != Type::STRING)
             {
                 DiagnosticBag::report_invalid_builtin_arguments(BI_SPLIT, 2, type_to_string(delimiter->type()), Position());
-                return new None();
+                return None::make();
             }
             std::string sep = ((String*)delimiter)->get_value();
             if (sep.size() == 0) sep = " ";
@@ -56,57 +81,57 @@ Object* BuiltInFunctions::SPLIT(Context& context)
         }
         default:
             DiagnosticBag::report_invalid_builtin_arguments(BI_SPLIT, 1, type_to_string(obj->type()), Position());
-            return new None();
+            return None::make();
     }    
 }
 
 // Returns the size of the list or string.
-Object* BuiltInFunctions::SIZE(Context& context)
+Object* BuiltInFunctions::SIZE(Object** args)
 {
-    Object* obj = context.get_symbol_table()->get_object("value").object;
+    Object* obj = args[0];
     switch(obj->type())
     {
         case Type::STRING:
-            return new Integer(((String*)obj)->get_size());
+            return Integer::make(((String*)obj)->get_size());
         case Type::LIST:
-            return new Integer(((List*)obj)->get_size());
+            return Integer::make(((List*)obj)->get_size());
         default:
             DiagnosticBag::report_invalid_builtin_arguments(BI_SIZE, 1, type_to_string(obj->type()), Position());
-            return new None();        
+            return None::make();        
     }
 }
 
 // Returns the type of the value
-Object* BuiltInFunctions::TYPE(Context& context)
+Object* BuiltInFunctions::TYPE(Object** args)
 {
-    Object* obj = context.get_symbol_table()->get_object("value").object;
+    Object* obj = args[0];
     return new String(type_to_string(obj->type()));
 }
 
 // Converts the value to a bool.
-Object* BuiltInFunctions::TO_BOOL(Context& context)
+Object* BuiltInFunctions::TO_BOOL(Object** args)
 {
-    Object* obj = context.get_symbol_table()->get_object("value").object;
+    Object* obj = args[0];
     switch(obj->type())
     {
         case Type::BOOLEAN:
-            return new Boolean(((Boolean*)obj)->get_value());
+            return Boolean::make(((Boolean*)obj)->get_value());
         case Type::INTEGER:
-            return new Boolean(((Integer*)obj)->get_value() != 0);
+            return Boolean::make(((Integer*)obj)->get_value() != 0);
         case Type::DOUBLE:
-            return new Boolean(((Double*)obj)->get_value() != 0);
+            return Boolean::make(((Double*)obj)->get_value() != 0);
         case Type::STRING:
-            return new Boolean(((String*)obj)->get_value() != "");
+            return Boolean::make(((String*)obj)->get_value() != "");
         default:
             DiagnosticBag::report_invalid_builtin_arguments(BI_TO_BOOL, 1, type_to_string(obj->type()), Position());
-            return new None();        
+            return None::make();        
     }
 }
 
 // Converts the value to an integer.
-Object* BuiltInFunctions::TO_INT(Context& context)
+Object* BuiltInFunctions::TO_INT(Object** args)
 {
-    Object* obj = context.get_symbol_table()->get_object("value").object;
+    Object* obj = args[0];
     switch (obj->type())
     {
         case Type::STRING:
@@ -121,29 +146,30 @@ Object* BuiltInFunctions::TO_INT(Context& context)
             std::istringstream is(text);
             long long x;
             if (is >> x && is_valid) 
-                return  new Integer(x);
+                return Integer::make(x);
 
             DiagnosticBag::report_invalid_type(text, type_to_string(Type::INTEGER), Position());
-            return new None();
+            return None::make();
         }
         case Type::INTEGER:
-            return obj->copy();
+            args[0] = nullptr;
+            return obj;
         case Type::BOOLEAN:
-            return new Integer(((Boolean*)obj)->get_value());
+            return Integer::make(((Boolean*)obj)->get_value());
         case Type::DOUBLE:
-            return new Integer(((Double*)obj)->get_value());
+            return Integer::make(((Double*)obj)->get_value());
         default:
         {
             DiagnosticBag::report_invalid_builtin_arguments(BI_TO_INT, 1, type_to_string(obj->type()), Position());
-            return new None();
+            return None::make();
         }
     }
 }
 
 // Converts the value to a double.
-Object* BuiltInFunctions::TO_DOUBLE(Context& context)
+Object* BuiltInFunctions::TO_DOUBLE(Object** args)
 {
-    Object* obj = context.get_symbol_table()->get_object("value").object;
+    Object* obj = args[0];
     switch (obj->type())
     {
         case Type::STRING:
@@ -170,46 +196,50 @@ Object* BuiltInFunctions::TO_DOUBLE(Context& context)
                 return new Double(x);
 
             DiagnosticBag::report_invalid_type(text, type_to_string(Type::DOUBLE), Position());
-            return new None();
+            return None::make();
         }
         case Type::INTEGER:
             return new Double(((Integer*)obj)->get_value());
         case Type::BOOLEAN:
             return new Double(((Boolean*)obj)->get_value());
         case Type::DOUBLE:
-            return obj->copy();
+            args[0] = nullptr;
+            return obj;
         default:
         {
             DiagnosticBag::report_invalid_builtin_arguments(BI_TO_DOUBLE, 1, type_to_string(obj->type()), Position());
-            return new None();
+            return None::make();
         }
     }
 }
 
 // Converts the value to a string.
-Object* BuiltInFunctions::TO_STRING(Context& context)
+Object* BuiltInFunctions::TO_STRING(Object** args)
 {
-    Object* obj = context.get_symbol_table()->get_object("value").object;
-    if (obj->type() == Type::STRING) return obj->copy(); 
+    Object* obj = args[0];
+    if (obj->type() == Type::STRING) 
+    {
+        args[0] = nullptr;
+        return obj;
+    }
     return new String(obj->to_string());
 }
 
-// Changes the value of a list index.
-Object* BuiltInFunctions::SET_INDEX(Context& context)
+// Changes the value of a list index. The list and the value are taken over instead of copied.
+Object* BuiltInFunctions::SET_INDEX(Object** args)
 {
-    Object* collection = context.get_symbol_table()->get_object("collection").object;
-    Object* index = context.get_symbol_table()->get_object("index").object;
-    Object* value = context.get_symbol_table()->get_object("value").object;
+    Object* collection = args[0];
+    Object* index = args[1];
+    Object* value = args[2];
     switch (collection->type())
     {
         case Type::LIST:
         {
-            List* list = (List*)(collection->copy());
+            List* list = (List*)collection;
             if (index->type() != Type::INTEGER)
             {
                 DiagnosticBag::report_invalid_builtin_arguments(BI_SET_INDEX, 2, type_to_string(index->type()), Position());
-                delete list;
-                return new None();     
+                return None::make();     
             }
             long long idx = ((Integer*)index)->get_value();
             int n = list->get_size();
@@ -218,14 +248,15 @@ Object* BuiltInFunctions::SET_INDEX(Context& context)
             {
                 DiagnosticBag::report_illegal_binary_operation(type_to_string(list->type()),
                 kind_to_string(SyntaxKind::IndexExpression), type_to_string(index->type()), Position());
-                delete list;
-                return new None();
+                return None::make();
             }
-            list->set_value(idx, value->copy());
+            list->set_value(idx, value);
+            args[0] = nullptr;
+            args[2] = nullptr;
             return list;
         }
         default:
             DiagnosticBag::report_invalid_builtin_arguments(BI_SET_INDEX, 1, type_to_string(collection->type()), Position());
-            return new None();            
+            return None::make();            
     }
 }
\ No newline at end of file
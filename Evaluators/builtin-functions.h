@@ -2,24 +2,43 @@
 
 #include "../Diagnostics/diagnostic.h"
 #include "../Objects/object.h"
-#include "../Contexts/context.h"
+#include "../Syntax/syntax.h"
 
 namespace Evaluators
 {
+    // Builtins receive their evaluated arguments as a span of exactly 'arity' objects.
+    // The caller keeps ownership of the arguments, unless the builtin takes one over by setting it to nullptr.
+    typedef Objects::Object* (*NativeFunction)(Objects::Object** args);
+
+    // Refer to builtin-functions.cpp
+    struct BuiltIn
+    {
+        std::string name;
+        int arity;
+        Objects::Type return_type;
+        bool is_pure;
+        NativeFunction function;
+    };
+
     // Refer to builtin-functions.cpp
     class BuiltInFunctions
     {
     private:
-        static Objects::Object* PRINT(Contexts::Context& context);
-        static Objects::Object* INPUT(Contexts::Context& context);
-        static Objects::Object* SPLIT(Contexts::Context& context);
-        static Objects::Object* SIZE(Contexts::Context& context);
-        static Objects::Object* TYPE(Contexts::Context& context);
-        static Objects::Object* TO_BOOL(Contexts::Context& context);
-        static Objects::Object* TO_INT(Contexts::Context& context);
-        static Objects::Object* TO_DOUBLE(Contexts::Context& context);
-        static Objects::Object* TO_STRING(Contexts::Context& context);
-        static Objects::Object* SET_INDEX(Contexts::Context& context);
-        friend class Evaluator; 
+        static const BuiltIn _registry[];
+    public:
+        // Compiled programs call these directly. Refer to cpp-emitter.cpp.
+        static Objects::Object* PRINT(Objects::Object** args);
+        static Objects::Object* INPUT(Objects::Object** args);
+        static Objects::Object* SPLIT(Objects::Object** args);
+        static Objects::Object* SIZE(Objects::Object** args);
+        static Objects::Object* TYPE(Objects::Object** args);
+        static Objects::Object* TO_BOOL(Objects::Object** args);
+        static Objects::Object* TO_INT(Objects::Object** args);
+        static Objects::Object* TO_DOUBLE(Objects::Object** args);
+        static Objects::Object* TO_STRING(Objects::Object** args);
+        static Objects::Object* SET_INDEX(Objects::Object** args);
+
+        static const int MAX_ARITY = 3;
+        static const BuiltIn* get_builtin(Syntax::SyntaxKind kind);
     };
 }
@@ -1,5 +1,8 @@
 #include "evaluator.h"
 #include "builtin-functions.h"
+#include "../Binding/binding.h"
+#include "../Optimizers/optimizers.h"
+#include "../Compilers/compilers.h"
 
 #include <iostream>
 
@@ -9,27 +12,20 @@ using namespace Diagnostics;
 using namespace Objects;
 using namespace Evaluators;
 
-// These help in evaluation. 
-bool Evaluator::to_continue = false;
-bool Evaluator::to_break = false;
-Object* Evaluator::return_value = nullptr;
+// A normal completion carries the value of the expression, which the caller owns. A 'return' carries the
+// returned value, and the other completions don't carry anything.
+// When the caller evaluates a statement whose value it doesn't use, the value of a declaration, an assignment
+// or a statement that only returns none can be left out, so the normal completion carries nullptr instead.
+Completion::Completion(Object* _value) : type(CompletionType::Normal), value(_value) {}
+Completion::Completion(CompletionType _type, Object* _value) : type(_type), value(_value) {}
 
-void Evaluator::clear()
+bool Completion::is_normal() const
 {
-    to_continue = false;
-    to_break = false;
-    delete return_value;
-    return_value = nullptr;
-}
-
-// This signals the evaluator to stop propagating values.
-bool Evaluator::should_return()
-{
-    return DiagnosticBag::size() || to_break || to_continue || return_value;
+    return type == CompletionType::Normal;
 }
 
 // Picks the right function and casts the node appropriately.
-Object* Evaluator::evaluate(Context& context, SyntaxNode* node)
+Completion Evaluator::evaluate(Context& context, SyntaxNode* node, bool is_used)
 {
     switch (node->kind())
     {
@@ -39,14 +35,18 @@ Object* Evaluator::evaluate(Context& context, SyntaxNode* node)
             return evaluate_unary(context, (UnaryExpressionSyntax*)node);
         case SyntaxKind::BinaryExpression:
             return evaluate_binary(context, (BinaryExpressionSyntax*)node);
+        case SyntaxKind::BoundBinaryExpression:
+            return evaluate_bound_binary(context, (BoundBinaryExpressionSyntax*)node);
         case SyntaxKind::IndexExpression:
             return evaluate_index(context, (IndexExpressionSyntax*)node);
+        case SyntaxKind::HoistedExpression:
+            return evaluate_hoisted(context, (HoistedExpressionSyntax*)node);
         case SyntaxKind::SequenceExpression:
-            return evaluate_sequence(context, (SequenceExpressionSyntax*)node);
+            return evaluate_sequence(context, (SequenceExpressionSyntax*)node, is_used);
         case SyntaxKind::VarDeclareExpression:  
-            return evaluate_var_declare(context, (VarDeclareExpressionSyntax*)node);
+            return evaluate_var_declare(context, (VarDeclareExpressionSyntax*)node, is_used);
         case SyntaxKind::VarAssignExpression:
-            return evaluate_var_assign(context, (VarAssignExpressionSyntax*)node);
+            return evaluate_var_assign(context, (VarAssignExpressionSyntax*)node, is_used);
         case SyntaxKind::VarAccessExpression:  
             return evaluate_var_access(context, (VarAccessExpressionSyntax*)node);
         case SyntaxKind::ReturnExpression:  
@@ -58,160 +58,370 @@ Object* Evaluator::evaluate(Context& context, SyntaxNode* node)
         case SyntaxKind::WhileExpression:
             return evaluate_while(context, (WhileExpressionSyntax*)node);
         case SyntaxKind::IfExpression:  
-            return evaluate_if(context, (IfExpressionSyntax*)node);
+            return evaluate_if(context, (IfExpressionSyntax*)node, is_used);
         case SyntaxKind::ForExpression:
             return evaluate_for(context, (ForExpressionSyntax*)node);
         case SyntaxKind::FuncDefineExpression:
-            return evaluate_function_define(context, (FuncDefineExpressionSyntax*)node);
+            return evaluate_function_define(context, (FuncDefineExpressionSyntax*)node, is_used);
         case SyntaxKind::FuncCallExpression:  
             return evaluate_function_call(context, (FuncCallExpressionSyntax*)node);     
+        case SyntaxKind::InlinedCallExpression:
+            return evaluate_inlined_call(context, (InlinedCallExpressionSyntax*)node);
+        case SyntaxKind::ParameterExpression:
+            return evaluate_parameter(context, (ParameterExpressionSyntax*)node);
         case SyntaxKind::NoneExpression:  
-            return new None();    
+            return None::make();    
         default:
             break;   
     }
 
     DiagnosticBag::report_unknown_syntax(kind_to_string(node->kind()), node->get_pos());
-    return new None();
+    return CompletionType::Error;
 }
 
 // Literally just return the object.
-Object* Evaluator::evaluate_literal(Context& context, LiteralExpressionSyntax* node)
+Completion Evaluator::evaluate_literal(Context& context, LiteralExpressionSyntax* node)
 {
     return node->get_object()->copy();
 }
 
 // Unary operations.
-Object* Evaluator::evaluate_unary(Context& context, UnaryExpressionSyntax* node)
+Completion Evaluator::evaluate_unary(Context& context, UnaryExpressionSyntax* node)
 {
-    Object* result = nullptr;
-    Object* operand = evaluate(context, node->get_operand());
-    if (should_return()) 
+    Completion operand = evaluate(context, node->get_operand());
+    if (!operand.is_normal()) return operand;
+
+    // Refer to evaluate_binary.
+    UnaryFeedback* feedback = node->get_feedback();
+    Type operand_type = operand.value->type();
+    Object* result;
+    if (feedback->is_quickened && feedback->operand == operand_type)
     {
-        delete operand;
-        return new None();
+        feedback->hits++;
+        result = apply_bound_unary(feedback->op, operand.value);
     }
-
-    switch (node->get_op_token()->kind())
+    else
     {
-        case SyntaxKind::MinusToken:
-        {
-            Integer* minus_one = new Integer(-1);
-            result = operand->multiplied_by(minus_one);
-            delete minus_one;
-            break;
-        }
-        case SyntaxKind::PlusToken:
-        {
-            Integer* one = new Integer(1);
-            result = operand->multiplied_by(one);
-            delete one;
-            break;
-        }
-        case SyntaxKind::NotKeyword:
-        case SyntaxKind::BangToken:
-            result = operand->notted();    
-            break;
-        default:
-            break;
+        feedback->misses++;
+        quicken_unary(feedback, node->get_op_token()->kind(), operand_type);
+        result = apply_unary(node->get_op_token()->kind(), operand.value);
     }
-
     if (result == nullptr || result->type() == Type::NONE)
     {
         DiagnosticBag::report_illegal_unary_operation(kind_to_string(node->get_op_token()->kind()),
-            type_to_string(operand->type()), node->get_pos());
+            type_to_string(operand.value->type()), node->get_pos());
+        delete operand.value;
+        delete result;
+        return CompletionType::Error;
     } 
 
-    delete operand;
-    if (result != nullptr) return result;
-    else return new None();
+    delete operand.value;
+    return result;
 }
 
 // Binary operations.
-Object* Evaluator::evaluate_binary(Context& context, BinaryExpressionSyntax* node)
+Completion Evaluator::evaluate_binary(Context& context, BinaryExpressionSyntax* node)
 {
-    Object* left = evaluate(context, node->get_left());
+    switch (node->get_op_token()->kind())
+    {
+        case SyntaxKind::AndKeyword:
+        case SyntaxKind::DAmpersandToken:
+        case SyntaxKind::OrKeyword:
+        case SyntaxKind::DPipeToken:
+            return evaluate_logical(context, node);
+        default:
+            break;
+    }
+
+    Completion left = evaluate(context, node->get_left());
+    if (!left.is_normal()) return left;
 
-    if (should_return()) 
+    Completion right = evaluate(context, node->get_right());
+    if (!right.is_normal()) 
     {
-        delete left;
-        return new None();
+        delete left.value;
+        return right;
     }
 
-    Object* right = evaluate(context, node->get_right());
-    
-    if (should_return()) 
+    // The specialized operation only runs while the operand types match the ones it was picked for.
+    // Anything else goes through the objects and picks again.
+    BinaryFeedback* feedback = node->get_feedback();
+    Type left_type = left.value->type();
+    Type right_type = right.value->type();
+    Object* result;
+    if (feedback->is_quickened && feedback->left == left_type && feedback->right == right_type)
     {
-        delete left;
-        delete right;
-        return new None();
+        feedback->hits++;
+        result = apply_bound_binary(feedback->op, left.value, right.value);
     }
+    else
+    {
+        feedback->misses++;
+        quicken_binary(feedback, node->get_op_token()->kind(), left_type, right_type);
+        result = apply_binary(node->get_op_token()->kind(), left.value, right.value);
+    }
+    if (result == nullptr || result->type() == Type::NONE)
+    {
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+            kind_to_string(node->get_op_token()->kind()), type_to_string(right.value->type()), node->get_pos());
+        delete left.value;
+        delete right.value;
+        delete result;
+        return CompletionType::Error;
+    } 
 
-    Object* result = nullptr;
-    switch (node->get_op_token()->kind())
+    delete left.value;
+    delete right.value;
+    return result;
+}
+
+// Picks the object operation for a unary operator. Returns nullptr if the operator doesn't exist.
+Object* Evaluator::apply_unary(SyntaxKind op_kind, Object* operand)
+{
+    switch (op_kind)
     {
+        case SyntaxKind::MinusToken:
+            return operand->negated();
         case SyntaxKind::PlusToken:
-            result = left->added_by(right);
-            break;
+            return operand->posited();
+        case SyntaxKind::NotKeyword:
+        case SyntaxKind::BangToken:
+            return operand->notted();    
+        default:
+            return nullptr;
+    }
+}
+
+// Picks the entry of the operator table for a binary operator. Returns nullptr if the operator doesn't exist.
+// Note that this evaluates 'and' and 'or' eagerly, the short-circuiting is up to the caller.
+Object* Evaluator::apply_binary(SyntaxKind op_kind, Object* left, Object* right)
+{
+    switch (op_kind)
+    {
+        case SyntaxKind::PlusToken:
+            return operate(Operator::ADD, left, right);
         case SyntaxKind::MinusToken:
-            result = left->subtracted_by(right);
-            break;
+            return operate(Operator::SUBTRACT, left, right);
         case SyntaxKind::StarToken:
-            result = left->multiplied_by(right);
-            break;
+            return operate(Operator::MULTIPLY, left, right);
         case SyntaxKind::SlashToken:
-            result = left->divided_by(right);
-            break;
+            return operate(Operator::DIVIDE, left, right);
         case SyntaxKind::ModuloToken:
-            result = left->modded_by(right);
-            break;
+            return operate(Operator::MODULO, left, right);
         case SyntaxKind::PowerToken:
-            result = left->powered_by(right);
-            break;
+            return operate(Operator::POWER, left, right);
         case SyntaxKind::AndKeyword:
         case SyntaxKind::DAmpersandToken:
-            result = left->and_with(right);
-            break;
+            return operate(Operator::AND, left, right);
         case SyntaxKind::OrKeyword:
         case SyntaxKind::DPipeToken:
-            result = left->or_with(right);
-            break;
+            return operate(Operator::OR, left, right);
+        case SyntaxKind::XorKeyword:
+            return operate(Operator::XOR, left, right);
         case SyntaxKind::LessThanToken:
-            result = left->less_than(right);
-            break;
+            return operate(Operator::LESS, left, right);
         case SyntaxKind::GreaterThanToken:
-            result = left->greater_than(right);
-            break;
+            return operate(Operator::GREATER, left, right);
         case SyntaxKind::LessEqualsToken:
-            result = left->less_equals(right);
-            break;
+            return operate(Operator::LESS_EQUALS, left, right);
         case SyntaxKind::GreaterEqualsToken:
-            result = left->greater_equals(right);
-            break;
+            return operate(Operator::GREATER_EQUALS, left, right);
         case SyntaxKind::DEqualsToken:
-            result = left->equals(right);
-            break;
+            return operate(Operator::EQUALS, left, right);
         case SyntaxKind::BangEqualsToken:
-            result = left->not_equals(right);
-            break;
+            return operate(Operator::NOT_EQUALS, left, right);
         default:
-            break;
+            return nullptr;
     }
+}
 
-    if (result == nullptr || result->type() == Type::NONE)
+// Logical 'and' and 'or'. The right operand is only evaluated when the left one doesn't decide the result.
+// A non-boolean left operand still evaluates the right one, so the error reports both types like before.
+Completion Evaluator::evaluate_logical(Context& context, BinaryExpressionSyntax* node)
+{
+    Completion left = evaluate(context, node->get_left());
+    if (!left.is_normal()) return left;
+
+    SyntaxKind op_kind = node->get_op_token()->kind();
+    bool is_and = op_kind == SyntaxKind::AndKeyword || op_kind == SyntaxKind::DAmpersandToken;
+    if (left.value->type() == Type::BOOLEAN && ((Boolean*)left.value)->get_value() != is_and)
+        return left;
+
+    Completion right = evaluate(context, node->get_right());
+    if (!right.is_normal()) 
     {
-        DiagnosticBag::report_illegal_binary_operation(type_to_string(left->type()),
-            kind_to_string(node->get_op_token()->kind()), type_to_string(right->type()), node->get_pos());
+        delete left.value;
+        return right;
+    }
+
+    Object* result = is_and ? left.value->and_with(right.value) : left.value->or_with(right.value);
+    if (result->type() == Type::NONE)
+    {
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+            kind_to_string(op_kind), type_to_string(right.value->type()), node->get_pos());
+        delete left.value;
+        delete right.value;
+        delete result;
+        return CompletionType::Error;
     } 
 
-    delete left;
-    delete right;
-    if (result != nullptr) return result;
-    else return new None();
+    delete left.value;
+    delete right.value;
+    return result;
+}
+
+// Binary operations whose operand types were found by the binder, so the operands are cast directly.
+// The only errors left are the ones that depend on the values, like dividing by zero.
+Completion Evaluator::evaluate_bound_binary(Context& context, BoundBinaryExpressionSyntax* node)
+{
+    Completion left = evaluate(context, node->get_left());
+    if (!left.is_normal()) return left;
+
+    BoundBinaryOperator op = node->get_op();
+    if (op == BoundBinaryOperator::BoolAnd || op == BoundBinaryOperator::BoolOr)
+    {
+        if (((Boolean*)left.value)->get_value() != (op == BoundBinaryOperator::BoolAnd))
+            return left;
+        delete left.value;
+        return evaluate(context, node->get_right());
+    }
+
+    Completion right = evaluate(context, node->get_right());
+    if (!right.is_normal()) 
+    {
+        delete left.value;
+        return right;
+    }
+
+    Object* result = apply_bound_binary(op, left.value, right.value);
+    if (result == nullptr)
+    {
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+            kind_to_string(node->get_op_token()->kind()), type_to_string(right.value->type()), node->get_pos());
+        delete left.value;
+        delete right.value;
+        return CompletionType::Error;
+    }
+
+    delete left.value;
+    delete right.value;
+    return result;
+}
+
+// Returns nullptr when the operation fails for these values.
+Object* Evaluator::apply_bound_binary(BoundBinaryOperator op, Object* left, Object* right)
+{
+    switch (op)
+    {
+        case BoundBinaryOperator::IntAdd:
+            return Integer::make(((Integer*)left)->get_value() + ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntSubtract:
+            return Integer::make(((Integer*)left)->get_value() - ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntMultiply:
+            return Integer::make(((Integer*)left)->get_value() * ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntDivide:
+            if (((Integer*)right)->get_value() == 0) return nullptr;
+            return Integer::make(((Integer*)left)->get_value() / ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntModulo:
+            if (((Integer*)right)->get_value() == 0) return nullptr;
+            return Integer::make(((Integer*)left)->get_value() % ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntLess:
+            return Boolean::make(((Integer*)left)->get_value() < ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntGreater:
+            return Boolean::make(((Integer*)left)->get_value() > ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntLessEquals:
+            return Boolean::make(((Integer*)left)->get_value() <= ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntGreaterEquals:
+            return Boolean::make(((Integer*)left)->get_value() >= ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntEquals:
+            return Boolean::make(((Integer*)left)->get_value() == ((Integer*)right)->get_value());
+        case BoundBinaryOperator::IntNotEquals:
+            return Boolean::make(((Integer*)left)->get_value() != ((Integer*)right)->get_value());
+
+        // The comparisons are negated the same way the objects do it, so NaN compares the same.
+        case BoundBinaryOperator::DoubleAdd:
+            return new Double(get_number(left) + get_number(right));
+        case BoundBinaryOperator::DoubleSubtract:
+            return new Double(get_number(left) - get_number(right));
+        case BoundBinaryOperator::DoubleMultiply:
+            return new Double(get_number(left) * get_number(right));
+        case BoundBinaryOperator::DoubleDivide:
+            if (get_number(right) == 0) return nullptr;
+            return new Double(get_number(left) / get_number(right));
+        case BoundBinaryOperator::DoubleLess:
+            return Boolean::make(get_number(left) < get_number(right));
+        case BoundBinaryOperator::DoubleGreater:
+            return Boolean::make(get_number(left) > get_number(right));
+        case BoundBinaryOperator::DoubleLessEquals:
+            return Boolean::make(!(get_number(left) > get_number(right)));
+        case BoundBinaryOperator::DoubleGreaterEquals:
+            return Boolean::make(!(get_number(left) < get_number(right)));
+        case BoundBinaryOperator::DoubleEquals:
+            return Boolean::make(get_number(left) == get_number(right));
+        case BoundBinaryOperator::DoubleNotEquals:
+            return Boolean::make(!(get_number(left) == get_number(right)));
+
+        case BoundBinaryOperator::BoolXor:
+            return Boolean::make(((Boolean*)left)->get_value() ^ ((Boolean*)right)->get_value());
+        case BoundBinaryOperator::BoolEquals:
+            return Boolean::make(((Boolean*)left)->get_value() == ((Boolean*)right)->get_value());
+        case BoundBinaryOperator::BoolNotEquals:
+            return Boolean::make(((Boolean*)left)->get_value() != ((Boolean*)right)->get_value());
+        default:
+            return nullptr;
+    }
+}
+
+// Returns nullptr when the operation fails for this value.
+Object* Evaluator::apply_bound_unary(BoundUnaryOperator op, Object* operand)
+{
+    switch (op)
+    {
+        case BoundUnaryOperator::IntNegate:
+            return Integer::make(-((Integer*)operand)->get_value());
+        case BoundUnaryOperator::IntIdentity:
+            return Integer::make(((Integer*)operand)->get_value());
+        case BoundUnaryOperator::DoubleNegate:
+            return new Double(-((Double*)operand)->get_value());
+        case BoundUnaryOperator::DoubleIdentity:
+            return new Double(((Double*)operand)->get_value());
+        case BoundUnaryOperator::BoolNot:
+            return Boolean::make(!((Boolean*)operand)->get_value());
+        default:
+            return nullptr;
+    }
+}
+
+// A node whose operand types keep changing would pick a new operation every time,
+// so after this many misses it stays on the generic path.
+const long long MAX_FEEDBACK_MISSES = 8;
+
+// Picks the specialized operation for the operand types the node has just seen.
+void Evaluator::quicken_binary(BinaryFeedback* feedback, SyntaxKind op_kind, Type left, Type right)
+{
+    feedback->is_quickened = feedback->misses <= MAX_FEEDBACK_MISSES &&
+        Binding::OperatorTypes::get_bound_operator(op_kind, Binding::BoundType(left), Binding::BoundType(right),
+            feedback->op);
+    feedback->left = left;
+    feedback->right = right;
+}
+
+void Evaluator::quicken_unary(UnaryFeedback* feedback, SyntaxKind op_kind, Type operand)
+{
+    feedback->is_quickened = feedback->misses <= MAX_FEEDBACK_MISSES &&
+        Binding::OperatorTypes::get_bound_unary_operator(op_kind, Binding::BoundType(operand), feedback->op);
+    feedback->operand = operand;
+}
+
+// Reads an integer or a double the way the mixed number operations do.
+long double Evaluator::get_number(Object* obj)
+{
+    if (obj->type() == Type::INTEGER) return ((Integer*)obj)->get_value();
+    return ((Double*)obj)->get_value();
 }
 
 // Sequence/List expressions.
-Object* Evaluator::evaluate_sequence(Context& context, SequenceExpressionSyntax* node)
+Completion Evaluator::evaluate_sequence(Context& context, SequenceExpressionSyntax* node, bool is_used)
 {
     // List expression.
     if (node->get_to_return())
@@ -220,15 +430,14 @@ Object* Evaluator::evaluate_sequence(Context& context, SequenceExpressionSyntax*
         int n = node->get_nodes_size();
         for (int i = 0; i < n; i++)
         {
-            Object* obj = evaluate(context, node->get_node(i));
-            elements.push_back(obj->copy());
-            delete obj;
-            if (should_return()) 
+            Completion obj = evaluate(context, node->get_node(i));
+            if (!obj.is_normal()) 
             {
                 for (auto &o : elements)
                     delete o;
-                return new None();
+                return obj;
             }
+            elements.push_back(obj.value);
         }
         List* list_res = new List(elements);
         return list_res;
@@ -238,46 +447,59 @@ Object* Evaluator::evaluate_sequence(Context& context, SequenceExpressionSyntax*
     int n = node->get_nodes_size();
     for (int i = 0; i < n; i++)
     {
-        Object* obj = evaluate(context, node->get_node(i));
-        delete obj;
-        if (should_return()) return new None();
+        Completion obj = evaluate(context, node->get_node(i), false);
+        if (!obj.is_normal()) return obj;
+        delete obj.value;
     }
-    return new None();
+    if (!is_used) return nullptr;
+    return None::make();
 }
 
 // Index a list or a string.
-Object* Evaluator::evaluate_index(Context& context, IndexExpressionSyntax* node)
+Completion Evaluator::evaluate_index(Context& context, IndexExpressionSyntax* node)
 {
-    Object* left = evaluate(context, node->get_to_access());
-    if (should_return()) 
-    {
-        delete left;
-        return new None();    
-    }
+    Completion left = evaluate(context, node->get_to_access());
+    if (!left.is_normal()) return left;
   
-    Object* right = evaluate(context, node->get_indexer());
-    if (should_return())
+    Completion right = evaluate(context, node->get_indexer());
+    if (!right.is_normal())
     {
-        delete left;
-        delete right;
-        return new None();
+        delete left.value;
+        return right;
     }
 
-    Object* result = left->accessed_by(right);
+    Object* result = left.value->accessed_by(right.value);
 
     if (result->type() == Type::NONE)
     {
-        DiagnosticBag::report_illegal_binary_operation(type_to_string(left->type()),
-            kind_to_string(SyntaxKind::IndexExpression), type_to_string(right->type()), node->get_pos());
+        DiagnosticBag::report_illegal_binary_operation(type_to_string(left.value->type()),
+            kind_to_string(SyntaxKind::IndexExpression), type_to_string(right.value->type()), node->get_pos());
+        delete left.value;
+        delete right.value;
+        delete result;
+        return CompletionType::Error;
     } 
 
-    delete left;
-    delete right;
+    delete left.value;
+    delete right.value;
     return result;
 }
 
+// An expression hoisted out of its loop. Only the first time it's reached in a run of the loop evaluates it.
+// Refer to loop-invariants.cpp.
+Completion Evaluator::evaluate_hoisted(Context& context, HoistedExpressionSyntax* node)
+{
+    if (node->get_value() == nullptr)
+    {
+        Completion value = evaluate(context, node->get_expression());
+        if (!value.is_normal()) return value;
+        node->set_value(value.value);
+    }
+    return node->get_value()->copy();
+}
+
 // Declares a variable, assigns a default value.
-Object* Evaluator::evaluate_var_declare(Context& context, VarDeclareExpressionSyntax* node)
+Completion Evaluator::evaluate_var_declare(Context& context, VarDeclareExpressionSyntax* node, bool is_used)
 {
     Type type = SyntaxFacts::get_keyword_type(node->get_var_keyword()->kind());
 
@@ -286,12 +508,12 @@ Object* Evaluator::evaluate_var_declare(Context& context, VarDeclareExpressionSy
     {
         case Type::BOOLEAN:
         {
-            value = new Boolean(false);
+            value = Boolean::make(false);
             break;
         }
         case Type::INTEGER:
         {
-            value = new Integer(0);
+            value = Integer::make(0);
             break;
         }
         case Type::DOUBLE:
@@ -319,210 +541,293 @@ Object* Evaluator::evaluate_var_declare(Context& context, VarDeclareExpressionSy
         default:
         {
             DiagnosticBag::report_unreachable_code("invalid type declaration", node->get_pos());
-            return new None();
+            return CompletionType::Error;
         }
     }
 
-    Object* orig_value = context.get_symbol_table()->get_object(node->get_identifier()->get_text()).object;
-    delete orig_value;
-    context.get_symbol_table()->set_object(node->get_identifier()->get_text(), value);
+    context.get_symbol_table()->declare_object(node->get_identifier()->get_text(), value);
+    if (!is_used) return nullptr;
     return value->copy();
 }
 
 // Assigns a value to a variable.
-Object* Evaluator::evaluate_var_assign(Context& context, VarAssignExpressionSyntax* node)
+Completion Evaluator::evaluate_var_assign(Context& context, VarAssignExpressionSyntax* node, bool is_used)
 {
-    Object* value = evaluate(context, node->get_value());
-    if (should_return()) 
-    {
-        delete value;
-        return new None();
-    }
+    Completion value = evaluate(context, node->get_value());
+    if (!value.is_normal()) return value;
 
     ObjectSymbol obj_sym = context.get_symbol_table()->get_object(node->get_identifier()->get_text());
 
     Object* orig_value = obj_sym.object;
-    if (orig_value->type() != value->type())
+
+    // The binder has already proven that the types match when the assignment is type checked.
+    if (!node->is_type_checked() && (obj_sym.symbol == nullptr || orig_value->type() != value.value->type()))
     {
-        DiagnosticBag::report_invalid_assign(type_to_string(value->type()), type_to_string(orig_value->type()),
+        DiagnosticBag::report_invalid_assign(type_to_string(value.value->type()), type_to_string(orig_value->type()),
             node->get_pos());
-        delete value;
-        return new None();
+        if (obj_sym.symbol == nullptr) delete orig_value;
+        delete value.value;
+        return CompletionType::Error;
     }
 
+    // The value moves into the symbol table. The result is a copy, since the table can change it later.
     delete orig_value;
-    obj_sym.symbol->set_object(node->get_identifier()->get_text(), value);
-    return value->copy();
+    obj_sym.symbol->set_object(node->get_identifier()->get_text(), value.value);
+    if (!is_used) return nullptr;
+    return value.value->copy();
 }
 
 // Accesses a variable.
-Object* Evaluator::evaluate_var_access(Context& context, VarAccessExpressionSyntax* node)
+Completion Evaluator::evaluate_var_access(Context& context, VarAccessExpressionSyntax* node)
 {
     Object* result = context.get_symbol_table()->get_object(node->get_identifier()->get_text()).object->copy();
     if (result->type() == Type::NONE)
     {
         DiagnosticBag::report_undeclared_identifier(node->get_identifier()->get_text(),
             node->get_identifier()->get_pos());
+        delete result;
+        return CompletionType::Error;
+    }
+
+    return result;
+}
+
+// While statement. The body keeps one context for the whole loop, unless it declares nothing.
+// The values hoisted out of the loop only last until it ends.
+Completion Evaluator::evaluate_while(Context& context, WhileExpressionSyntax* node)
+{
+    if (!node->is_scoped())
+    {
+        Completion result = run_while(context, context, node);
+        node->forget_invariants();
         return result;
     }
 
+    Context* exec_ctx = ContextPool::acquire("while-loop", &context);
+    Completion result = run_while(context, *exec_ctx, node);
+    ContextPool::release(exec_ctx);
+    node->forget_invariants();
     return result;
 }
 
-// While statement.
-Object* Evaluator::evaluate_while(Context& context, WhileExpressionSyntax* node)
+Completion Evaluator::run_while(Context& context, Context& exec_ctx, WhileExpressionSyntax* node)
 {
-    Context exec_ctx = Context("while-loop", &context, SymbolTable(context.get_symbol_table()));
+    CountedLoop* loop = node->get_counted_loop();
+    if (loop != nullptr) return evaluate_counted_loop(context, exec_ctx, loop, node);
+
     while(true)
     {
-        Object* condition = evaluate(context, node->get_condition());
-        if (should_return()) 
-        {
-            delete condition;
-            return new None();
-        }
+        Completion condition = evaluate(context, node->get_condition());
+        if (!condition.is_normal()) return condition;
 
-        if (condition->type() != Type::BOOLEAN)
+        if (condition.value->type() != Type::BOOLEAN)
         {
-            DiagnosticBag::report_unexpected_type(type_to_string(condition->type()), type_to_string(Type::BOOLEAN),
-                node->get_condition()->get_pos());
-            delete condition;
-            return new None();
+            DiagnosticBag::report_unexpected_type(type_to_string(condition.value->type()), 
+                type_to_string(Type::BOOLEAN), node->get_condition()->get_pos());
+            delete condition.value;
+            return CompletionType::Error;
         }
 
-        if (!((Boolean*)condition)->get_value())
-        {
-            delete condition;
-            break;
-        }
-        
-        Object* body_obj = evaluate(exec_ctx, node->get_body());
-        delete body_obj;
-        delete condition;
-
-        if (should_return() && !(to_break || to_continue)) 
-            return new None();
+        bool is_true = ((Boolean*)condition.value)->get_value();
+        delete condition.value;
+        if (!is_true) break;
         
-        if (to_break)
+        Completion body = evaluate(exec_ctx, node->get_body(), false);
+        if (body.type == CompletionType::Break) break;
+        if (body.type != CompletionType::Continue)
         {
-            to_break = false;
-            break;
+            if (!body.is_normal()) return body;
+            delete body.value;
         }
 
-        if (to_continue)
+        // A hot loop may finish in its trace. Refer to trace-jit.cpp.
+        if (Compilers::TraceJit::run(exec_ctx, node) == Compilers::TraceExit::Finished) break;
+    }
+    return None::make();
+}
+
+// Runs a loop found by the CountedLoops pass. The counter is kept in a native integer and is only written
+// to its variable when the body reads it, when the loop ends, and when the loop goes into its trace.
+// The condition is evaluated in 'context' and the body in 'exec_ctx', which are the same for for-loops.
+Completion Evaluator::evaluate_counted_loop(Context& context, Context& exec_ctx, CountedLoop* loop, SyntaxNode* node)
+{
+    Completion limit_obj = evaluate(context, loop->limit);
+    if (!limit_obj.is_normal()) return limit_obj;
+    long long limit = ((Integer*)limit_obj.value)->get_value();
+    delete limit_obj.value;
+
+    Integer* counter = get_counter(context, loop->variable);
+    long long i = counter->get_value();
+    while (compare_counter(loop->compare, i, limit))
+    {
+        if (loop->is_read) counter->set_value(i);
+        for (SyntaxNode* statement : loop->body)
         {
-            to_continue = false;
-            continue;
+            Completion completion = evaluate(exec_ctx, statement, false);
+            if (completion.is_normal())
+            {
+                delete completion.value;
+                continue;
+            }
+
+            // Only for-loops can continue, and the update still runs after it.
+            if (completion.type == CompletionType::Continue) break;
+
+            counter->set_value(i);
+            if (completion.type == CompletionType::Break) return None::make();
+            return completion;
         }
+        i += loop->step;
+
+        // The trace writes the counter back as a new object. Refer to trace-jit.cpp.
+        counter->set_value(i);
+        Compilers::TraceExit exit = Compilers::TraceJit::run(exec_ctx, node);
+        if (exit == Compilers::TraceExit::Finished) return None::make();
+        if (exit == Compilers::TraceExit::NotEntered) continue;
+        counter = get_counter(context, loop->variable);
+        i = counter->get_value();
+    }
+
+    counter->set_value(i);
+    return None::make();
+}
+
+// The binder made sure the variable is a declared integer, and the body never replaces it.
+// A shared integer can't be changed, so the variable gets its own one first.
+Integer* Evaluator::get_counter(Context& context, const std::string& variable)
+{
+    ObjectSymbol obj_sym = context.get_symbol_table()->get_object(variable);
+    Integer* counter = (Integer*)obj_sym.object;
+    if (Object::is_shared(counter))
+    {
+        counter = new Integer(counter->get_value());
+        obj_sym.symbol->set_object(variable, counter);
+    }
+    return counter;
+}
+
+bool Evaluator::compare_counter(BoundBinaryOperator op, long long counter, long long limit)
+{
+    switch (op)
+    {
+        case BoundBinaryOperator::IntLess:
+            return counter < limit;
+        case BoundBinaryOperator::IntGreater:
+            return counter > limit;
+        case BoundBinaryOperator::IntLessEquals:
+            return counter <= limit;
+        case BoundBinaryOperator::IntGreaterEquals:
+            return counter >= limit;
+        default:
+            return false;
     }
-    return new None();
 }
 
 // Conditional staement.
-Object* Evaluator::evaluate_if(Context& context, IfExpressionSyntax* node)
+Completion Evaluator::evaluate_if(Context& context, IfExpressionSyntax* node, bool is_used)
 {
     int n = node->get_size();
     for (int i = 0; i < n; i++)
     {
-        Object* condition = evaluate(context,node->get_condition(i));
-        if (should_return()) 
-        {
-            delete condition;
-            return new None();
-        }
+        Completion condition = evaluate(context,node->get_condition(i));
+        if (!condition.is_normal()) return condition;
 
-        if (condition->type() != Type::BOOLEAN)
+        if (condition.value->type() != Type::BOOLEAN)
         {
-            DiagnosticBag::report_unexpected_type(type_to_string(condition->type()), type_to_string(Type::BOOLEAN),
-                node->get_condition(i)->get_pos());
-            delete condition;
-            return new None();
+            DiagnosticBag::report_unexpected_type(type_to_string(condition.value->type()), 
+                type_to_string(Type::BOOLEAN), node->get_condition(i)->get_pos());
+            delete condition.value;
+            return CompletionType::Error;
         }
 
-        if (((Boolean*)condition)->get_value())
-        {
-            Context exec_ctx = Context("if-statement", &context, SymbolTable(context.get_symbol_table()));
-            Object* value = evaluate(exec_ctx, node->get_body(i));
-            delete condition;
-            if (should_return()) 
-            {
-                delete value;
-                return new None();
-            }
-            return value;
-        }
-        delete condition;
+        bool is_true = ((Boolean*)condition.value)->get_value();
+        delete condition.value;
+        if (is_true) 
+            return evaluate_scoped(context, node->get_body(i), "if-statement", node->is_scoped(i), is_used);
     }
 
     if (node->get_else_body())
+        return evaluate_scoped(context, node->get_else_body(), "if-statement", node->is_else_scoped(), is_used);
+
+    if (!is_used) return nullptr;
+    return None::make();
+}
+
+// Evaluates the body in a context from the pool, or straight in the current one when it declares nothing.
+Completion Evaluator::evaluate_scoped(Context& context, SyntaxNode* node, const char* name, bool is_scoped,
+    bool is_used)
+{
+    if (!is_scoped) return evaluate(context, node, is_used);
+
+    Context* exec_ctx = ContextPool::acquire(name, &context);
+    Completion result = evaluate(*exec_ctx, node, is_used);
+    ContextPool::release(exec_ctx);
+    return result;
+}
+
+// For statement. Refer to evaluate_while.
+Completion Evaluator::evaluate_for(Context& context, ForExpressionSyntax* node)
+{
+    if (!node->is_scoped())
     {
-        Context exec_ctx = Context("if-statement", &context, SymbolTable(context.get_symbol_table()));
-        Object* value = evaluate(exec_ctx, node->get_else_body());
-        if (should_return()) 
-        {
-            delete value;
-            return new None();
-        }
-        return value;       
+        Completion result = run_for(context, node);
+        node->forget_invariants();
+        return result;
     }
 
-    return new None();
+    Context* exec_ctx = ContextPool::acquire("for-loop", &context);
+    Completion result = run_for(*exec_ctx, node);
+    ContextPool::release(exec_ctx);
+    node->forget_invariants();
+    return result;
 }
 
-// For statement.
-Object* Evaluator::evaluate_for(Context& context, ForExpressionSyntax* node)
+Completion Evaluator::run_for(Context& exec_ctx, ForExpressionSyntax* node)
 {
-    Context exec_ctx = Context("for-loop", &context, SymbolTable(context.get_symbol_table()));
-    Object* init_obj = evaluate(exec_ctx, node->get_init());
-    delete init_obj;
-    if (should_return()) return new None();
+    Completion init = evaluate(exec_ctx, node->get_init(), false);
+    if (!init.is_normal()) return init;
+    delete init.value;
+
+    CountedLoop* loop = node->get_counted_loop();
+    if (loop != nullptr) return evaluate_counted_loop(exec_ctx, exec_ctx, loop, node);
 
     while(true)
     {
-        Object* condition = evaluate(exec_ctx, node->get_condition());
-        if (should_return()) 
-        {
-            delete condition;
-            return new None();
-        }
-        if (condition->type() != Type::BOOLEAN)
-        {
-            DiagnosticBag::report_unexpected_type(type_to_string(condition->type()), type_to_string(Type::BOOLEAN),
-                node->get_condition()->get_pos());
-            delete condition;
-            return new None();
-        }
+        Completion condition = evaluate(exec_ctx, node->get_condition());
+        if (!condition.is_normal()) return condition;
 
-        if (!((Boolean*)condition)->get_value())
+        if (condition.value->type() != Type::BOOLEAN)
         {
-            delete condition;
-            break;
+            DiagnosticBag::report_unexpected_type(type_to_string(condition.value->type()), 
+                type_to_string(Type::BOOLEAN), node->get_condition()->get_pos());
+            delete condition.value;
+            return CompletionType::Error;
         }
 
-        Object* body_obj = evaluate(exec_ctx, node->get_body());
-        delete body_obj;
-        delete condition;
+        bool is_true = ((Boolean*)condition.value)->get_value();
+        delete condition.value;
+        if (!is_true) break;
 
-        if (should_return() && !(to_break || to_continue)) 
-            return new None();
-
-        if (to_break)
+        Completion body = evaluate(exec_ctx, node->get_body(), false);
+        if (body.type == CompletionType::Break) break;
+        if (body.type != CompletionType::Continue)
         {
-            to_break = false;
-            break;
+            if (!body.is_normal()) return body;
+            delete body.value;
         }
 
-        if (to_continue) to_continue = false;
+        Completion update = evaluate(exec_ctx, node->get_update(), false);
+        if (!update.is_normal()) return update;
+        delete update.value;
 
-        Object* update_obj = evaluate(exec_ctx, node->get_update());
-        delete update_obj;
-        if (should_return()) return new None();
+        // A hot loop may finish in its trace. Refer to trace-jit.cpp.
+        if (Compilers::TraceJit::run(exec_ctx, node) == Compilers::TraceExit::Finished) break;
     }
-    return new None();
+    return None::make();
 }
 
 // Defines a function.
-Object* Evaluator::evaluate_function_define(Context& context, FuncDefineExpressionSyntax* node)
+Completion Evaluator::evaluate_function_define(Context& context, FuncDefineExpressionSyntax* node, bool is_used)
 {
     std::string name = node->get_identifier()->get_text();
     std::vector<std::string> arg_names; 
@@ -533,158 +838,231 @@ Object* Evaluator::evaluate_function_define(Context& context, FuncDefineExpressi
         arg_names.push_back(node->get_arg_name(i)->get_text());
     
     Object* val = new Function(name, arg_names, node->get_body());
-    Object* orig_val = context.get_symbol_table()->get_object(node->get_identifier()->get_text()).object;
-    delete orig_val;
-
-    context.get_symbol_table()->set_object(node->get_identifier()->get_text(), val);
+    context.get_symbol_table()->declare_object(node->get_identifier()->get_text(), val);
+    if (!is_used) return nullptr;
     return val->copy();
 }
 
 // Calls a function.
-Object* Evaluator::evaluate_function_call(Context& context, FuncCallExpressionSyntax* node)
+Completion Evaluator::evaluate_function_call(Context& context, FuncCallExpressionSyntax* node)
 {
-    Object* obj = context.get_symbol_table()->get_object(node->get_identifier()->get_text()).object->copy();
-    if (obj->type() != Type::FUNCTION)
+    const BuiltIn* builtin = node->get_builtin();
+    if (builtin) return evaluate_builtin_call(context, node, builtin);
+
+    // The function is used where it's stored, unless evaluating the arguments could replace it.
+    // A missing function comes back as a none that belongs to the caller.
+    ObjectSymbol obj_sym = context.get_symbol_table()->get_object(node->get_identifier()->get_text());
+    if (obj_sym.object->type() != Type::FUNCTION)
     {
-        DiagnosticBag::report_unexpected_type(type_to_string(obj->type()), type_to_string(Type::FUNCTION),
+        DiagnosticBag::report_unexpected_type(type_to_string(obj_sym.object->type()), type_to_string(Type::FUNCTION),
             node->get_identifier()->get_pos());
-        delete obj;
-        return new None();
+        if (obj_sym.symbol == nullptr) delete obj_sym.object;
+        return CompletionType::Error;
     }
     
-    Function* func = (Function*)obj;
-
-    // Generate context
-    Context exec_ctx = Context(func->get_name(), &context, SymbolTable(context.get_symbol_table()));
+    Function* func = (Function*)obj_sym.object;
 
     // Check arguments
     int n = func->get_argument_size();
     int m = node->get_arg_size();
     if (n != m)
     {
-        Position arg_pos = Position();
-        if (m > 0) 
-        {
-            Position first_arg = node->get_arg(0)->get_pos();
-            Position last_arg = node->get_arg(m-1)->get_pos();
-            arg_pos = Position(first_arg.ln, first_arg.col, first_arg.start, last_arg.end);
-        }
-        DiagnosticBag::report_illegal_arguments(m, n, func->get_name(), arg_pos);
-        delete func;
-        return new None();
+        report_illegal_arguments(node, n, func->get_name());
+        return CompletionType::Error;
     }
+
+    // A body that was only pre-parsed is parsed the first time the function is called.
+    SyntaxNode* func_body = (SyntaxNode*)(func->get_body());
+    if (func_body != nullptr && func_body->kind() == SyntaxKind::LazyBodyExpression &&
+        !compile_body((LazyBodyExpressionSyntax*)func_body, func->get_argument_names()))
+        return CompletionType::Error;
+
+    bool is_copied = node->args_write();
+    if (is_copied) func = (Function*)func->copy();
     
     // Evaluate arguments
     std::vector<Object*> args;
     for (int i = 0; i < n; i++)
     {
-        args.push_back(evaluate(context, node->get_arg(i)));
-        if (should_return()) 
+        Completion arg = evaluate(context, node->get_arg(i));
+        if (!arg.is_normal()) 
         {
             for (auto &o : args)
                 delete o;
-            return new None();
+            if (is_copied) delete func;
+            return arg;
         }
-
+        args.push_back(arg.value);
     }
 
-    // Populate arguments
+    // Generate context and populate arguments
+    Context* exec_ctx = ContextPool::acquire(func->get_name(), &context);
     for (int i = 0; i < n; i++)
-        exec_ctx.get_symbol_table()->set_object(func->get_argument_name(i), args[i]);
+        exec_ctx->get_symbol_table()->set_object(func->get_argument_name(i), args[i]);
 
-    Object* result = nullptr;
-    if (!func->is_built_in())
+    // The body can replace the function, so nothing is read from it afterwards.
+    // I had to cast here because I used a void*.
+    func_body = (SyntaxNode*)(func->get_body());
+    if (is_copied) delete func;
+    if (func_body == nullptr)
     {
-        
-        if (func->get_body() == nullptr)
-        {
-            delete func;
-            return new None();
-        }
+        ContextPool::release(exec_ctx);
+        return None::make();
+    }
+    if (func_body->kind() == SyntaxKind::LazyBodyExpression)
+        func_body = ((LazyBodyExpressionSyntax*)func_body)->get_body();
 
-        // I had to cast here because I used a void*.
-        Object* body_obj = evaluate(exec_ctx, (SyntaxNode*)(func->get_body()));
-        delete body_obj;
-        delete func;
+    Completion body = evaluate(*exec_ctx, func_body, false);
+    ContextPool::release(exec_ctx);
 
-        if (should_return() && !return_value) 
-            return new None();
+    // The call ends a 'return'. A 'break' or 'continue' keeps going to the caller's loop.
+    if (body.type == CompletionType::Return) return body.value;
+    if (!body.is_normal()) return body;
+    delete body.value;
+    return None::make();
+}
 
-        if (return_value)
-        {
-            result = return_value;
-            return_value = nullptr;
-        }
-        
-        if (result != nullptr) return result;
-        else return new None();
-    }
-
-    std::string func_name = func->get_name();
-    delete func;
-    switch (SyntaxFacts::get_keyword_kind(func_name))
-    {
-        case SyntaxKind::PrintFunction:
-            return BuiltInFunctions::PRINT(exec_ctx);
-        case SyntaxKind::InputFunction:
-            return BuiltInFunctions::INPUT(exec_ctx);
-        case SyntaxKind::SplitFunction:
-            return BuiltInFunctions::SPLIT(exec_ctx);    
-        case SyntaxKind::SizeFunction:
-            return BuiltInFunctions::SIZE(exec_ctx);
-        case SyntaxKind::TypeFunction:
-            return BuiltInFunctions::TYPE(exec_ctx);
-        case SyntaxKind::ToBoolFunction:
-            return BuiltInFunctions::TO_BOOL(exec_ctx);
-        case SyntaxKind::ToIntFunction:
-            return BuiltInFunctions::TO_INT(exec_ctx);
-        case SyntaxKind::ToDoubleFunction:
-            return BuiltInFunctions::TO_DOUBLE(exec_ctx);
-        case SyntaxKind::ToStringFunction:
-            return BuiltInFunctions::TO_STRING(exec_ctx);
-        case SyntaxKind::SetIndexFunction:
-            return BuiltInFunctions::SET_INDEX(exec_ctx);
-        default:
+// Calls a builtin function. The arguments are passed straight to the native function.
+// Builtins report their own errors.
+Completion Evaluator::evaluate_builtin_call(Context& context, FuncCallExpressionSyntax* node, const BuiltIn* builtin)
+{
+    int n = builtin->arity;
+    int m = node->get_arg_size();
+    if (n != m)
+    {
+        report_illegal_arguments(node, n, builtin->name);
+        return CompletionType::Error;
+    }
+
+    Object* args[BuiltInFunctions::MAX_ARITY];
+    for (int i = 0; i < n; i++)
+    {
+        Completion arg = evaluate(context, node->get_arg(i));
+        if (!arg.is_normal()) 
         {
-            DiagnosticBag::report_unreachable_code("invalid builtin function", node->get_identifier()->get_pos());
-            return new None();
+            for (int j = 0; j < i; j++)
+                delete args[j];
+            return arg;
         }
+        args[i] = arg.value;
     }
 
-    return new None();
+    Object* result = builtin->function(args);
+    for (int i = 0; i < n; i++)
+        delete args[i];
+
+    if (DiagnosticBag::size())
+    {
+        delete result;
+        return CompletionType::Error;
+    }
+    return result;
 }
 
-// Return expression.
-Object* Evaluator::evaluate_return(Context& context, ReturnExpressionSyntax* node)
+// A call to a small function with the function's expression in its place. Refer to function-inliner.cpp.
+// The expression only stands for the call while the name still holds the function it came from. Otherwise,
+// like when the name was assigned another function or isn't defined yet, the call runs as it was written.
+Completion Evaluator::evaluate_inlined_call(Context& context, InlinedCallExpressionSyntax* node)
 {
-    Object* result = nullptr;
-    if (node->get_to_return())
+    FuncCallExpressionSyntax* call = node->get_call();
+    ObjectSymbol obj_sym = context.get_symbol_table()->get_object(call->get_identifier()->get_text());
+    if (obj_sym.object->type() != Type::FUNCTION ||
+        ((Function*)obj_sym.object)->get_body() != node->get_function()->get_body())
     {
-        result = evaluate(context, node->get_to_return());
-        if (should_return()) 
+        if (obj_sym.symbol == nullptr) delete obj_sym.object;
+        return evaluate_function_call(context, call);
+    }
+
+    // The arguments are evaluated in the caller, like they would be for the call.
+    std::vector<Object*> args;
+    int n = call->get_arg_size();
+    for (int i = 0; i < n; i++)
+    {
+        Completion arg = evaluate(context, call->get_arg(i));
+        if (!arg.is_normal())
         {
-            delete result;
-            return new None();
+            for (auto &o : args)
+                delete o;
+            return arg;
         }
+        args.push_back(arg.value);
+    }
+
+    node->set_arguments(args);
+    Completion result = evaluate(context, node->get_body());
+    node->clear_arguments();
+    return result;
+}
+
+// A parameter of an inlined function reads the argument of the current call.
+Completion Evaluator::evaluate_parameter(Context& context, ParameterExpressionSyntax* node)
+{
+    return node->get_argument()->copy();
+}
+
+// Parses a pre-parsed function body and runs it through the same passes as the rest of the program.
+// If anything is reported, the body stays unparsed and the call ends in an error.
+bool Evaluator::compile_body(LazyBodyExpressionSyntax* node, const std::vector<std::string>& arg_names)
+{
+    if (node->get_body() != nullptr) return true;
 
-        if (return_value != nullptr) delete return_value;
-        return_value = result;
-        return new None();
+    Parser parser(node->get_text(), false, true, true, node->get_pos().start);
+    SyntaxNode* body = parser.parse_body();
+    if (!DiagnosticBag::size()) 
+        body = Optimizers::ConstantFolder::fold(body);
+    if (!DiagnosticBag::size()) 
+    {
+        Binding::Binder binder;
+        body = binder.bind_function_body(arg_names, body);
+    }
+    if (!DiagnosticBag::size()) 
+    {
+        body = Optimizers::FunctionInliner::inline_calls(body);
+        Optimizers::LoopInvariants::find(body);
+        Optimizers::CountedLoops::find(body);
     }
 
-    return new None();
+    if (DiagnosticBag::size())
+    {
+        delete body;
+        return false;
+    }
+    node->set_body(body);
+    return true;
+}
+
+// Reports a call with the wrong number of arguments, highlighting the arguments given.
+void Evaluator::report_illegal_arguments(FuncCallExpressionSyntax* node, int expected, std::string name)
+{
+    int m = node->get_arg_size();
+    Position arg_pos = Position();
+    if (m > 0) 
+    {
+        Position first_arg = node->get_arg(0)->get_pos();
+        Position last_arg = node->get_arg(m-1)->get_pos();
+        arg_pos = Position(first_arg.start, last_arg.end);
+    }
+    DiagnosticBag::report_illegal_arguments(m, expected, name, arg_pos);
+}
+
+// Return expression. A bare 'return' returns none.
+Completion Evaluator::evaluate_return(Context& context, ReturnExpressionSyntax* node)
+{
+    if (node->get_to_return() == nullptr) return Completion(CompletionType::Return, None::make());
+
+    Completion result = evaluate(context, node->get_to_return());
+    if (!result.is_normal()) return result;
+    return Completion(CompletionType::Return, result.value);
 }
 
 // Continue expression.
-Object* Evaluator::evaluate_continue(Context& context, ContinueExpressionSyntax* node)
+Completion Evaluator::evaluate_continue(Context& context, ContinueExpressionSyntax* node)
 {
-    to_continue = true;
-    return new None();
+    return CompletionType::Continue;
 }
 
 // Break expression.
-Object* Evaluator::evaluate_break(Context& context, BreakExpressionSyntax* node)
+Completion Evaluator::evaluate_break(Context& context, BreakExpressionSyntax* node)
 {
-    to_break = true;
-    return new None();
-}
+    return CompletionType::Break;
+}
\ No newline at end of file
@@ -4,36 +4,88 @@
 #include "../Syntax/Expressions/syntax-expressions.h"
 #include "../Contexts/context.h"
 #include "../Diagnostics/diagnostic.h"
+#include "builtin-functions.h"
 
 namespace Evaluators
 {
+    // How an evaluation ended. Anything but 'Normal' unwinds until something handles it: loops handle 'Break'
+    // and 'Continue', function calls handle 'Return', and 'Error' means a diagnostic was reported.
+    enum class CompletionType
+    {
+        Normal,
+        Break,
+        Continue,
+        Return,
+        Error,
+    };
+
+    // Refer to evaluator.cpp.
+    struct Completion
+    {
+        CompletionType type;
+        Objects::Object* value;
+        Completion(Objects::Object* _value);
+        Completion(CompletionType _type, Objects::Object* _value=nullptr);
+
+        bool is_normal() const;
+    };
+
     // Refer to evaluator.cpp.
     class Evaluator final
     {
     private:
-        static bool should_return();
-        static bool to_continue;
-        static bool to_break;
-        static Objects::Object* return_value;
-
-        static Objects::Object* evaluate_literal(Contexts::Context& context, Syntax::LiteralExpressionSyntax* node);
-        static Objects::Object* evaluate_unary(Contexts::Context& context, Syntax::UnaryExpressionSyntax* node);
-        static Objects::Object* evaluate_binary(Contexts::Context& context, Syntax::BinaryExpressionSyntax* node);
-        static Objects::Object* evaluate_sequence(Contexts::Context& context, Syntax::SequenceExpressionSyntax* node);
-        static Objects::Object* evaluate_index(Contexts::Context& context, Syntax::IndexExpressionSyntax* node);
-        static Objects::Object* evaluate_var_declare(Contexts::Context& context, Syntax::VarDeclareExpressionSyntax* node);
-        static Objects::Object* evaluate_var_assign(Contexts::Context& context, Syntax::VarAssignExpressionSyntax* node);
-        static Objects::Object* evaluate_var_access(Contexts::Context& context, Syntax::VarAccessExpressionSyntax* node);
-        static Objects::Object* evaluate_while(Contexts::Context& context, Syntax::WhileExpressionSyntax* node);
-        static Objects::Object* evaluate_for(Contexts::Context& context, Syntax::ForExpressionSyntax* node);
-        static Objects::Object* evaluate_if(Contexts::Context& context, Syntax::IfExpressionSyntax* node);
-        static Objects::Object* evaluate_return(Contexts::Context& context, Syntax::ReturnExpressionSyntax* node);
-        static Objects::Object* evaluate_continue(Contexts::Context& context, Syntax::ContinueExpressionSyntax* node);
-        static Objects::Object* evaluate_break(Contexts::Context& context, Syntax::BreakExpressionSyntax* node);
-        static Objects::Object* evaluate_function_define(Contexts::Context& context, Syntax::FuncDefineExpressionSyntax* node);
-        static Objects::Object* evaluate_function_call(Contexts::Context& context, Syntax::FuncCallExpressionSyntax* node);
+        static Completion evaluate_literal(Contexts::Context& context, Syntax::LiteralExpressionSyntax* node);
+        static Completion evaluate_unary(Contexts::Context& context, Syntax::UnaryExpressionSyntax* node);
+        static Completion evaluate_binary(Contexts::Context& context, Syntax::BinaryExpressionSyntax* node);
+        static Completion evaluate_logical(Contexts::Context& context, Syntax::BinaryExpressionSyntax* node);
+        static Completion evaluate_bound_binary(Contexts::Context& context, Syntax::BoundBinaryExpressionSyntax* node);
+        static Objects::Object* apply_bound_binary(Syntax::BoundBinaryOperator op, Objects::Object* left,
+            Objects::Object* right);
+        static Objects::Object* apply_bound_unary(Syntax::BoundUnaryOperator op, Objects::Object* operand);
+        static void quicken_binary(Syntax::BinaryFeedback* feedback, Syntax::SyntaxKind op_kind,
+            Objects::Type left, Objects::Type right);
+        static void quicken_unary(Syntax::UnaryFeedback* feedback, Syntax::SyntaxKind op_kind, Objects::Type operand);
+        static long double get_number(Objects::Object* obj);
+        static Completion evaluate_sequence(Contexts::Context& context, Syntax::SequenceExpressionSyntax* node,
+            bool is_used);
+        static Completion evaluate_index(Contexts::Context& context, Syntax::IndexExpressionSyntax* node);
+        static Completion evaluate_hoisted(Contexts::Context& context, Syntax::HoistedExpressionSyntax* node);
+        static Completion evaluate_var_declare(Contexts::Context& context, Syntax::VarDeclareExpressionSyntax* node,
+            bool is_used);
+        static Completion evaluate_var_assign(Contexts::Context& context, Syntax::VarAssignExpressionSyntax* node,
+            bool is_used);
+        static Completion evaluate_var_access(Contexts::Context& context, Syntax::VarAccessExpressionSyntax* node);
+        static Completion evaluate_while(Contexts::Context& context, Syntax::WhileExpressionSyntax* node);
+        static Completion run_while(Contexts::Context& context, Contexts::Context& exec_ctx,
+            Syntax::WhileExpressionSyntax* node);
+        static Completion evaluate_for(Contexts::Context& context, Syntax::ForExpressionSyntax* node);
+        static Completion run_for(Contexts::Context& exec_ctx, Syntax::ForExpressionSyntax* node);
+        static Completion evaluate_counted_loop(Contexts::Context& context, Contexts::Context& exec_ctx,
+            Syntax::CountedLoop* loop, Syntax::SyntaxNode* node);
+        static Completion evaluate_if(Contexts::Context& context, Syntax::IfExpressionSyntax* node, bool is_used);
+        static Completion evaluate_scoped(Contexts::Context& context, Syntax::SyntaxNode* node, const char* name,
+            bool is_scoped, bool is_used);
+        static Completion evaluate_return(Contexts::Context& context, Syntax::ReturnExpressionSyntax* node);
+        static Completion evaluate_continue(Contexts::Context& context, Syntax::ContinueExpressionSyntax* node);
+        static Completion evaluate_break(Contexts::Context& context, Syntax::BreakExpressionSyntax* node);
+        static Completion evaluate_function_define(Contexts::Context& context, Syntax::FuncDefineExpressionSyntax* node,
+            bool is_used);
+        static Completion evaluate_function_call(Contexts::Context& context, Syntax::FuncCallExpressionSyntax* node);
+        static Completion evaluate_builtin_call(Contexts::Context& context, Syntax::FuncCallExpressionSyntax* node,
+            const BuiltIn* builtin);
+        static Completion evaluate_inlined_call(Contexts::Context& context,
+            Syntax::InlinedCallExpressionSyntax* node);
+        static Completion evaluate_parameter(Contexts::Context& context, Syntax::ParameterExpressionSyntax* node);
     public:
-        static void clear();
-        static Objects::Object* evaluate(Contexts::Context& context, Syntax::SyntaxNode* node);
+        static Objects::Object* apply_unary(Syntax::SyntaxKind op_kind, Objects::Object* operand);
+        static Objects::Object* apply_binary(Syntax::SyntaxKind op_kind, Objects::Object* left, Objects::Object* right);
+
+        static Completion evaluate(Contexts::Context& context, Syntax::SyntaxNode* node, bool is_used=true);
+
+        // The closures share these with the evaluator. Refer to closure-compiler.cpp.
+        static Objects::Integer* get_counter(Contexts::Context& context, const std::string& variable);
+        static bool compare_counter(Syntax::BoundBinaryOperator op, long long counter, long long limit);
+        static void report_illegal_arguments(Syntax::FuncCallExpressionSyntax* node, int expected, std::string name);
+        static bool compile_body(Syntax::LazyBodyExpressionSyntax* node, const std::vector<std::string>& arg_names);
     };
 }
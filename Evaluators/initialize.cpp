@@ -1,5 +1,7 @@
 #include "initialize.h"
-#include "../constants.h"
+#include "../Optimizers/optimizers.h"
+#include "../Binding/binding.h"
+#include "../Compilers/compilers.h"
 #include <iostream>
 
 using Evaluators::Evaluator;
@@ -7,41 +9,63 @@ using Evaluators::Evaluator;
 Contexts::SymbolTable global_symbol_table = Contexts::SymbolTable(nullptr);
 Contexts::Context context("<program>", nullptr, global_symbol_table);
 
-// Create Builtin 
-void add_builtin_function(std::string name, std::vector<std::string> arg_names)
+// Parses the script of a file, unless the tree it had the last time is still on disk. Refer to syntax-cache.cpp.
+static Syntax::SyntaxNode* parse_cached(const std::string& filename, std::string_view script, bool show_return)
 {
-    Objects::Object* func = new Objects::Function(name, arg_names, nullptr, true);
-    context.get_symbol_table()->set_object(name, func);
-}
+    Syntax::SyntaxCache cache(filename, script);
+    Syntax::SyntaxNode* root = cache.load();
+    if (root != nullptr) return root;
 
-void Evaluators::initialize()
-{
-    add_builtin_function(BI_INPUT, {});
-    add_builtin_function(BI_PRINT, {"value"});
-    add_builtin_function(BI_SPLIT, {"value", "delimiter"});
-    add_builtin_function(BI_SIZE, {"value"});
-    add_builtin_function(BI_TYPE, {"value"});
-    add_builtin_function(BI_TO_BOOL, {"value"});
-    add_builtin_function(BI_TO_INT, {"value"});
-    add_builtin_function(BI_TO_DOUBLE, {"value"});
-    add_builtin_function(BI_TO_STRING, {"value"});
-    add_builtin_function(BI_SET_INDEX, {"collection", "index", "value"});
+    root = Syntax::Parser(script, show_return, false, true).parse();
+    if (!Diagnostics::DiagnosticBag::size()) cache.store(root);
+    return root;
 }
 
-void Evaluators::run(std::string &script, bool show_tree, bool show_return, bool is_shell)
+void Evaluators::run(std::string_view script, bool show_tree, bool show_return, bool is_shell,
+    bool show_feedback, bool is_parallel, const std::string& cache_name, bool use_closures)
 {
-    Diagnostics::DiagnosticBag::script = script;
-    Syntax::Parser parser(script, show_return);
-    Syntax::SyntaxNode* root = parser.parse();
+    Diagnostics::DiagnosticBag::set_script(script);
+    Syntax::SyntaxNode* root;
+    if (!cache_name.empty()) root = parse_cached(cache_name, script, show_return);
+    else if (is_parallel) root = Syntax::ParallelParser(script, show_return, !is_shell).parse();
+    else root = Syntax::Parser(script, show_return, false, !is_shell).parse();
+    if (!Diagnostics::DiagnosticBag::size()) 
+        root = Optimizers::ConstantFolder::fold(root);
+    if (!Diagnostics::DiagnosticBag::size()) 
+    {
+        Binding::Binder binder;
+        root = binder.bind_program(root);
+    }
+    if (!Diagnostics::DiagnosticBag::size()) 
+        root = Optimizers::FunctionInliner::inline_program(root);
+    if (!Diagnostics::DiagnosticBag::size()) 
+    {
+        Optimizers::LoopInvariants::find(root);
+        Optimizers::CountedLoops::find(root);
+    }
 
     if (show_tree) Syntax::pretty_print(root);
 
     Objects::Object* answer = nullptr;
     if (!Diagnostics::DiagnosticBag::size()) 
-        answer = Evaluator::evaluate(context, root);
+    {
+        // A 'break', 'continue' or 'return' outside of where it belongs just ends the program.
+        // The closures run the same tree, compiled first. Refer to closure-compiler.cpp.
+        Evaluators::Completion completion = use_closures ? Compilers::ClosureCompiler::run(context, root) :
+            Evaluator::evaluate(context, root);
+        if (completion.is_normal()) answer = completion.value;
+        else if (completion.type != Evaluators::CompletionType::Error)
+        {
+            delete completion.value;
+            answer = new Objects::None();
+        }
+    }
 
     Diagnostics::DiagnosticBag::print();
 
+    // The tree again, now with how often each operation hit or missed its specialized path.
+    if (show_feedback && !Diagnostics::DiagnosticBag::size()) Syntax::pretty_print(root);
+
     // If the List only has one element, print that element.
     if (!Diagnostics::DiagnosticBag::size() && show_return && answer != nullptr) 
     {
@@ -53,6 +77,89 @@ void Evaluators::run(std::string &script, bool show_tree, bool show_return, bool
 
     delete answer;
     if (!is_shell) delete root;
+    Optimizers::FunctionInliner::clear();
     Diagnostics::DiagnosticBag::clear();
-    Evaluator::clear();
-}
\ No newline at end of file
+}
+
+// Runs a script one top-level statement at a time instead of parsing all of it first. Each statement is folded,
+// bound and evaluated as soon as it's parsed, then deleted, and the arena is cut back to where it was before it.
+// A statement that defines a function is kept, since the function holds on to its body, and so is one that
+// parsed a function body on its first call.
+// Errors are printed as soon as they come up, and they end the run.
+void Evaluators::run_stream(ScriptFile& script)
+{
+    std::string_view text = script.get_text();
+    Diagnostics::DiagnosticBag::set_script(text);
+    Syntax::Parser parser(text, false, true, true);
+    Binding::Binder binder;
+
+    bool is_running = true;
+    while (is_running && !parser.is_done())
+    {
+        Syntax::SyntaxMark mark = parser.mark();
+        int functions = parser.get_function_count();
+        int compiled = Syntax::LazyBodyExpressionSyntax::get_compiled_count();
+
+        Syntax::SyntaxNode* statement = parser.parse_next();
+        if (!Diagnostics::DiagnosticBag::size()) 
+            statement = Optimizers::ConstantFolder::fold(statement);
+        if (!Diagnostics::DiagnosticBag::size()) 
+            statement = binder.bind_statement(statement);
+        if (!Diagnostics::DiagnosticBag::size()) 
+            statement = Optimizers::FunctionInliner::inline_program(statement);
+        if (!Diagnostics::DiagnosticBag::size()) 
+        {
+            Optimizers::LoopInvariants::find(statement);
+            Optimizers::CountedLoops::find(statement);
+        }
+
+        if (!Diagnostics::DiagnosticBag::size())
+        {
+            // Like in a whole program, a 'break', 'continue' or 'return' out here just ends it.
+            Evaluators::Completion completion = Evaluator::evaluate(context, statement, false);
+            delete completion.value;
+            is_running = completion.is_normal();
+        }
+
+        if (Diagnostics::DiagnosticBag::size())
+        {
+            Diagnostics::DiagnosticBag::print();
+            is_running = false;
+        }
+
+        // Bodies parsed on their first call are allocated past the mark too.
+        if (parser.get_function_count() == functions && 
+            Syntax::LazyBodyExpressionSyntax::get_compiled_count() == compiled)
+        {
+            delete statement;
+            parser.release(mark);
+        }
+        script.release_before(parser.get_offset());
+    }
+
+    Optimizers::FunctionInliner::clear();
+    Diagnostics::DiagnosticBag::clear();
+}
+
+// Writes the script out as a C++ program instead of running it. Refer to cpp-emitter.cpp.
+// Every function body is parsed right away, and if anything is reported it's printed and nothing is written.
+// The output is usually redirected into a file, so the errors go to the standard error instead.
+bool Evaluators::emit_cpp(std::string_view script, const std::string& filename)
+{
+    Diagnostics::DiagnosticBag::set_script(script);
+    Syntax::SyntaxNode* root = Syntax::Parser(script, false).parse();
+    if (!Diagnostics::DiagnosticBag::size()) 
+        root = Optimizers::ConstantFolder::fold(root);
+    if (!Diagnostics::DiagnosticBag::size()) 
+    {
+        Binding::Binder binder;
+        root = binder.bind_program(root);
+    }
+
+    bool is_emitted = !Diagnostics::DiagnosticBag::size();
+    if (is_emitted) std::cout << Compilers::CppEmitter(script, filename).emit_program(root);
+    Diagnostics::DiagnosticBag::print(std::cerr);
+    Diagnostics::DiagnosticBag::clear();
+    delete root;
+    return is_emitted;
+}
@@ -2,9 +2,29 @@
 
 #include "evaluator.h"
 #include <string>
+#include <string_view>
 
 namespace Evaluators
 {
-    void initialize();
-    void run(std::string &script, bool show_tree=false, bool show_return=false, bool is_shell=false);
+    // Refer to script-file.cpp.
+    class ScriptFile final
+    {
+    private:
+        const char* _data;
+        size_t _size;
+        bool _is_mapped;
+        size_t _released;
+        std::string _buffer;
+    public:
+        ScriptFile(const std::string& filename);
+        ~ScriptFile();
+
+        std::string_view get_text() const;
+        void release_before(size_t offset);
+    };
+
+    void run(std::string_view script, bool show_tree=false, bool show_return=false, bool is_shell=false,
+        bool show_feedback=false, bool is_parallel=false, const std::string& cache_name="", bool use_closures=false);
+    void run_stream(ScriptFile& script);
+    bool emit_cpp(std::string_view script, const std::string& filename);
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "initialize.h"
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Evaluators;
+
+// The script of a file run. The file is mapped into memory where that's possible, so the lexer reads it
+// in place instead of through a copy. Otherwise, or if the mapping fails, it is read into a string.
+// A file that can't be opened gives an empty script, like it always has.
+ScriptFile::ScriptFile(const std::string& filename) : _data(nullptr), _size(0), _is_mapped(false), _released(0)
+{
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd != -1)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        {
+            void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = (const char*)data;
+                _size = st.st_size;
+                _is_mapped = true;
+            }
+        }
+        close(fd);
+        if (_is_mapped) return;
+    }
+#endif
+
+    std::ifstream file(filename);
+    if (!file.is_open()) return;
+
+    std::ostringstream os;
+    os << file.rdbuf();
+    _buffer = os.str();
+    _data = _buffer.data();
+    _size = _buffer.size();
+}
+
+ScriptFile::~ScriptFile()
+{
+#ifndef _WIN32
+    if (_is_mapped) munmap((void*)_data, _size);
+#endif
+}
+
+std::string_view ScriptFile::get_text() const
+{
+    return std::string_view(_data, _size);
+}
+
+
+// Lets the system drop the mapped pages before the offset once a streamed run is past them. They stay mapped,
+// so a diagnostic that needs the text again just reads it back from the file. It's done a megabyte at a time
+// so it doesn't cost a call per statement.
+void ScriptFile::release_before(size_t offset)
+{
+#ifndef _WIN32
+    if (!_is_mapped) return;
+
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t end = offset / page * page;
+    if (end < _released + (1 << 20)) return;
+
+    madvise((void*)(_data + _released), end - _released, MADV_DONTNEED);
+    _released = end;
+#endif
+}
\ No newline at end of file
@@ -4,92 +4,119 @@ using namespace Objects;
 
 Object::~Object() {}
 
+// Objects come from the pool, and are freed by their own operator delete. Refer to shared-objects.cpp.
+void* Object::operator new(size_t size)
+{
+    return ObjectPool::allocate(size);
+}
+
+void* Object::operator new(size_t size, void* ptr)
+{
+    return ptr;
+}
+
 // Return none type as default. This will tell me when an illegal operation has occured.
 Object* Object::added_by(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::subtracted_by(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::multiplied_by(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::divided_by(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::modded_by(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::powered_by(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::accessed_by(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::and_with(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::or_with(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::xor_with(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::notted() const
 {
-    return new None();
+    return None::make();
+}
+
+Object* Object::negated() const
+{
+    return None::make();
+}
+
+Object* Object::posited() const
+{
+    return None::make();
 }
 
 Object* Object::less_than(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::greater_than(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
 Object* Object::equals(Object* other) const
 {
-    return new None();
+    return None::make();
 }
 
-// These can be derived from the other operations.
+// These can be derived from the other operations. The intermediate result is deleted once it's negated.
 Object* Object::not_equals(Object* other) const
 {
-    return equals(other)->notted();
+    Object* result = equals(other);
+    Object* notted_result = result->notted();
+    delete result;
+    return notted_result;
 }
 
 Object* Object::less_equals(Object* other) const
 {
-    return greater_than(other)->notted();
+    Object* result = greater_than(other);
+    Object* notted_result = result->notted();
+    delete result;
+    return notted_result;
 }
 
 Object* Object::greater_equals(Object* other) const
 {
-    return less_than(other)->notted();
+    Object* result = less_than(other);
+    Object* notted_result = result->notted();
+    delete result;
+    return notted_result;
 }
-
-
-
@@ -26,7 +26,7 @@ std::string Boolean::to_string() const
 // Boolean operations. These are self explanatory.
 Object* Boolean::notted() const
 {
-    return new Boolean(!_value);
+    return Boolean::make(!_value);
 }
 
 Object* Boolean::and_with(Object* other) const
@@ -34,9 +34,9 @@ Object* Boolean::and_with(Object* other) const
     switch(other->type())
     {
         case Type::BOOLEAN:
-            return new Boolean(_value && ((Boolean*)other)->get_value());
+            return Boolean::make(_value && ((Boolean*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -45,9 +45,9 @@ Object* Boolean::or_with(Object* other) const
     switch(other->type())
     {
         case Type::BOOLEAN:
-            return new Boolean(_value || ((Boolean*)other)->get_value());
+            return Boolean::make(_value || ((Boolean*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -56,9 +56,9 @@ Object* Boolean::xor_with(Object* other) const
     switch(other->type())
     {
         case Type::BOOLEAN:
-            return new Boolean(_value ^ ((Boolean*)other)->get_value());
+            return Boolean::make(_value ^ ((Boolean*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -67,13 +67,13 @@ Object* Boolean::equals(Object* other) const
     switch(other->type())
     {
         case Type::BOOLEAN:
-            return new Boolean(_value == ((Boolean*)other)->get_value());
+            return Boolean::make(_value == ((Boolean*)other)->get_value());
         default:
-            return new Boolean(false);
+            return Boolean::make(false);
     }
 }
 
 Object* Boolean::copy()
 {
-    return new Boolean(_value);
+    return Boolean::make(_value);
 }
\ No newline at end of file
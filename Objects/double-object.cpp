@@ -34,7 +34,7 @@ Object* Double::added_by(Object* other) const
         case Type::DOUBLE:
             return new Double(_value+((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -47,7 +47,7 @@ Object* Double::subtracted_by(Object* other) const
         case Type::DOUBLE:
             return new Double(_value-((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -60,7 +60,7 @@ Object* Double::multiplied_by(Object* other) const
         case Type::DOUBLE:
             return new Double(_value*((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -71,17 +71,17 @@ Object* Double::divided_by(Object* other) const
         case Type::INTEGER:
         {
             Integer* other_int = (Integer*)other;
-            if (other_int->get_value() == 0) return new None();
+            if (other_int->get_value() == 0) return None::make();
             return new Double(_value/other_int->get_value());
         }
         case Type::DOUBLE:
         {
             Double* other_double = (Double*)other;
-            if (other_double->get_value() == 0) return new None();
+            if (other_double->get_value() == 0) return None::make();
             return new Double(_value/other_double->get_value());            
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -94,21 +94,32 @@ Object* Double::powered_by(Object* other) const
         case Type::DOUBLE:
             return new Double(powl(_value, ((Double*)other)->get_value()));     
         default:
-            return new None();       
+            return None::make();       
     }
 }
 
+// Unary minus and plus.
+Object* Double::negated() const
+{
+    return new Double(-_value);
+}
+
+Object* Double::posited() const
+{
+    return new Double(_value);
+}
+
 // Returns the respective booleans.
 Object* Double::less_than(Object* other) const
 {
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Boolean(_value<((Integer*)other)->get_value());
+            return Boolean::make(_value<((Integer*)other)->get_value());
         case Type::DOUBLE:
-            return new Boolean(_value<((Double*)other)->get_value());
+            return Boolean::make(_value<((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -117,11 +128,11 @@ Object* Double::greater_than(Object* other) const
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Boolean(_value>((Integer*)other)->get_value());
+            return Boolean::make(_value>((Integer*)other)->get_value());
         case Type::DOUBLE:
-            return new Boolean(_value>((Double*)other)->get_value());
+            return Boolean::make(_value>((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -130,11 +141,11 @@ Object* Double::equals(Object* other) const
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Boolean(_value==((Integer*)other)->get_value());
+            return Boolean::make(_value==((Integer*)other)->get_value());
         case Type::DOUBLE:
-            return new Boolean(_value==((Double*)other)->get_value());
+            return Boolean::make(_value==((Double*)other)->get_value());
         default:
-            return new Boolean(false);
+            return Boolean::make(false);
     }
 }
 
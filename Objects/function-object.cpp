@@ -5,15 +5,15 @@ using namespace Objects;
 //  I used a void* here because I can't declare SyntaxNode here since 'syntax.h' needs to includes 'object.h'.
 //  I could move the declaration of SyntaxNode here, but that would mess up my organization.
 //  It should be fine since I'm not going to cast it into anything but SyntaxNode... I think.
-Function::Function(std::string name, std::vector<std::string>& argument_names, void* body, bool built_in)
-    : _name(name), _argument_names(argument_names), _body(body), _built_in(built_in) {}
+Function::Function(std::string name, std::vector<std::string>& argument_names, void* body)
+    : _name(name), _argument_names(argument_names), _body(body) {}
 
 Type Function::type() const
 {
     return Type::FUNCTION;
 }
 
-std::string Function::get_name() const
+const std::string& Function::get_name() const
 {
     return _name;
 }
@@ -23,7 +23,7 @@ int Function::get_argument_size() const
     return _argument_names.size();
 }
 
-std::string Function::get_argument_name(int i) const
+const std::string& Function::get_argument_name(int i) const
 {
     return _argument_names[i];
 }
@@ -38,11 +38,6 @@ void* Function::get_body() const
     return _body;
 }
 
-bool Function::is_built_in() const
-{
-    return _built_in;
-}
-
 // Prints the name of the function in a special format.
 std::string Function::to_string() const
 {
@@ -57,13 +52,13 @@ Object* Function::equals(Object* other) const
     switch (other->type())
     {
         case Type::FUNCTION:
-            return new Boolean(this == other);
+            return Boolean::make(this == other);
         default:
-            return new Boolean(false);
+            return Boolean::make(false);
     }
 }
 
 Object* Function::copy()
 {
-    return new Function(_name, _argument_names, _body, _built_in);
+    return new Function(_name, _argument_names, _body);
 }
\ No newline at end of file
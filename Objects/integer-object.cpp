@@ -15,6 +15,12 @@ long long Integer::get_value() const
     return _value;
 }
 
+// Only for counters that are owned by a symbol table, see evaluate_counted_loop.
+void Integer::set_value(long long value)
+{
+    _value = value;
+}
+
 std::string Integer::to_string() const
 {
     std::ostringstream os;
@@ -28,11 +34,11 @@ Object* Integer::added_by(Object* other) const
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Integer(_value+((Integer*)other)->get_value());
+            return Integer::make(_value+((Integer*)other)->get_value());
         case Type::DOUBLE:
             return new Double(_value+((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -41,11 +47,11 @@ Object* Integer::subtracted_by(Object* other) const
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Integer(_value-((Integer*)other)->get_value());
+            return Integer::make(_value-((Integer*)other)->get_value());
         case Type::DOUBLE:
             return new Double(_value-((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -56,12 +62,12 @@ Object* Integer::multiplied_by(Object* other) const
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Integer(_value*((Integer*)other)->get_value());
+            return Integer::make(_value*((Integer*)other)->get_value());
         case Type::DOUBLE:
             return new Double(_value*((Double*)other)->get_value());
         case Type::STRING:
         {
-            if (_value < 0) return new None();
+            if (_value < 0) return None::make();
             long long e = _value;
             std::string result;
             std::string base = ((String*)other)->get_value();
@@ -74,7 +80,7 @@ Object* Integer::multiplied_by(Object* other) const
             return new String(result);
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -86,17 +92,17 @@ Object* Integer::divided_by(Object* other) const
         case Type::INTEGER:
         {
             Integer* other_int = (Integer*)other;
-            if (other_int->get_value() == 0) return new None();
-            return new Integer(_value/other_int->get_value());
+            if (other_int->get_value() == 0) return None::make();
+            return Integer::make(_value/other_int->get_value());
         }
         case Type::DOUBLE:
         {
             Double* other_double = (Double*)other;
-            if (other_double->get_value() == 0) return new None();
+            if (other_double->get_value() == 0) return None::make();
             return new Double(_value/other_double->get_value());            
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -107,11 +113,11 @@ Object* Integer::modded_by(Object* other) const
         case Type::INTEGER:
         {
             Integer* other_int = (Integer*)other;
-            if (other_int->get_value() == 0) return new None();
-            return new Integer(_value%other_int->get_value());
+            if (other_int->get_value() == 0) return None::make();
+            return Integer::make(_value%other_int->get_value());
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -133,26 +139,37 @@ Object* Integer::powered_by(Object* other) const
                 b *= b;
                 e >>= 1;
             }
-            return new Integer(ans);
+            return Integer::make(ans);
         }
         case Type::DOUBLE:
             return new Double(powl(_value, ((Double*)other)->get_value()));   
         default:
-            return new None();         
+            return None::make();         
     }
 }
 
+// Unary minus and plus.
+Object* Integer::negated() const
+{
+    return Integer::make(-_value);
+}
+
+Object* Integer::posited() const
+{
+    return Integer::make(_value);
+}
+
 // Returns the respective booleans.
 Object* Integer::less_than(Object* other) const
 {
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Boolean(_value<((Integer*)other)->get_value());
+            return Boolean::make(_value<((Integer*)other)->get_value());
         case Type::DOUBLE:
-            return new Boolean(_value<((Double*)other)->get_value());
+            return Boolean::make(_value<((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -161,11 +178,11 @@ Object* Integer::greater_than(Object* other) const
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Boolean(_value>((Integer*)other)->get_value());
+            return Boolean::make(_value>((Integer*)other)->get_value());
         case Type::DOUBLE:
-            return new Boolean(_value>((Double*)other)->get_value());
+            return Boolean::make(_value>((Double*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -174,15 +191,15 @@ Object* Integer::equals(Object* other) const
     switch (other->type())
     {
         case Type::INTEGER:
-            return new Boolean(_value==((Integer*)other)->get_value());
+            return Boolean::make(_value==((Integer*)other)->get_value());
         case Type::DOUBLE:
-            return new Boolean(_value==((Double*)other)->get_value());
+            return Boolean::make(_value==((Double*)other)->get_value());
         default:
-            return new Boolean(false);
+            return Boolean::make(false);
     }
 }
 
 Object* Integer::copy()
 {
-    return new Integer(_value);
+    return Integer::make(_value);
 }
\ No newline at end of file
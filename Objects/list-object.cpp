@@ -121,11 +121,11 @@ Object* List::accessed_by(Object* other) const
             long long i = ((Integer*)other)->get_value();
             int n = _values.size();
             if (i < 0) i += n;
-            if (i < 0 || i >= n) return new None();
+            if (i < 0 || i >= n) return None::make();
             return _values[i]->copy();
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -139,17 +139,17 @@ Object* List::equals(Object* other) const
             int n = _values.size();
             List* other_list = (List*)other;
             int m = other_list->get_size();
-            if (m != n) return new Boolean(false);
+            if (m != n) return Boolean::make(false);
             
             bool result = true;
             for (int i = 0; i < n; i++)
             {
                 result &= ((Boolean*)(_values[i]->equals(other_list->get_value(i))))->get_value();
             }
-            return new Boolean(result);
+            return Boolean::make(result);
         }
         default:
-            return new Boolean(false);
+            return Boolean::make(false);
     }
 }
 
@@ -162,13 +162,13 @@ Object* List::multiplied_by(Object* other) const
         {
             List* other_list = (List*)other;
             if (!is_matrix(this) || !is_matrix(other_list))
-                return new None();
+                return None::make();
             int a = _values.size();
             int b = ((List*)_values[0])->get_size();
             int c = other_list->get_size();
             int d = ((List*)other_list->get_value(0))->get_size();
 
-            if (b != c) return new None();
+            if (b != c) return None::make();
 
             std::vector<std::vector<long long>> result(a, std::vector<long long>(d));
             for (int i = 0; i < a; i++)
@@ -190,7 +190,7 @@ Object* List::multiplied_by(Object* other) const
             {
                 std::vector<Object*> children;
                 for (int j = 0; j < d; j++)
-                    children.push_back(new Integer(result[i][j]));
+                    children.push_back(Integer::make(result[i][j]));
                 
                 elems.push_back(new List(children));
             }
@@ -198,7 +198,7 @@ Object* List::multiplied_by(Object* other) const
             return new List(elems);
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -209,13 +209,13 @@ Object* List::powered_by(Object* other) const
     {
         case Type::INTEGER:
         {
-            if (!is_matrix(this)) return new None();
+            if (!is_matrix(this)) return None::make();
             int n = _values.size();
             int m = ((List*)_values[0])->get_size();
-            if (n != m) return new None();
+            if (n != m) return None::make();
 
             long long e = ((Integer*)other)->get_value();
-            if (e < 0) return new None();
+            if (e < 0) return None::make();
 
             // Build identity matrix
             std::vector<Object*> result_elems;
@@ -223,7 +223,7 @@ Object* List::powered_by(Object* other) const
             {
                 std::vector<Object*> result_children;
                 for (int j = 0; j < n; j++)
-                    result_children.push_back(new Integer(j == i));
+                    result_children.push_back(Integer::make(j == i));
                 result_elems.push_back(new List(result_children));
             }
             List* result = new List(result_elems);
@@ -252,7 +252,7 @@ Object* List::powered_by(Object* other) const
             return result;
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -22,13 +22,13 @@ Object* None::equals(Object* other) const
     switch (other->type())
     {
         case Type::NONE:
-            return new Boolean(true);
+            return Boolean::make(true);
         default:
-            return new Boolean(false);
+            return Boolean::make(false);
     }
 }
 
 Object* None::copy()
 {
-    return new None();
+    return None::make();
 }
\ No newline at end of file
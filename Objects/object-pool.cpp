@@ -0,0 +1,83 @@
+#include "object.h"
+#include <iostream>
+#include <new>
+
+using namespace Objects;
+
+// The evaluator makes and deletes small objects all the time, so they are kept on free lists instead of going
+// back to the system. Objects are grouped by size in steps of 16 bytes, and each group gets its memory in chunks
+// that are never freed. Objects bigger than the largest group go straight to the system.
+// Building with -DNO_OBJECT_POOL, or with AddressSanitizer, skips the pool so every object is checked on its own.
+#if defined(NO_OBJECT_POOL) || defined(__SANITIZE_ADDRESS__)
+#define OBJECT_POOL_ENABLED false
+#else
+#define OBJECT_POOL_ENABLED true
+#endif
+
+// Each thread has free lists of its own. An object deleted on another thread than the one that made it just
+// goes on the free list of the thread deleting it, so the numbers printed are the ones for the current thread.
+thread_local ObjectPool::SizeClass ObjectPool::_classes[CLASS_COUNT] = {};
+
+// Splits a new chunk into free objects of the group's size.
+void ObjectPool::refill(SizeClass& size_class, size_t size)
+{
+    char* chunk = (char*)::operator new(size*CHUNK_OBJECTS);
+    for (int i = CHUNK_OBJECTS-1; i >= 0; i--)
+    {
+        FreeObject* obj = (FreeObject*)(chunk + i*size);
+        obj->next = size_class.free;
+        size_class.free = obj;
+    }
+    size_class.chunks++;
+}
+
+void* ObjectPool::allocate(size_t size)
+{
+    int i = (size-1) / GRANULARITY;
+    if (!OBJECT_POOL_ENABLED || i >= CLASS_COUNT) return ::operator new(size);
+
+    SizeClass& size_class = _classes[i];
+    if (size_class.free == nullptr) refill(size_class, (i+1)*GRANULARITY);
+
+    FreeObject* obj = size_class.free;
+    size_class.free = obj->next;
+    size_class.in_use++;
+    size_class.allocations++;
+    return obj;
+}
+
+// The size is the one the object was allocated with, since objects are deleted through their virtual destructor.
+void ObjectPool::deallocate(void* ptr, size_t size)
+{
+    int i = (size-1) / GRANULARITY;
+    if (!OBJECT_POOL_ENABLED || i >= CLASS_COUNT)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    SizeClass& size_class = _classes[i];
+    FreeObject* obj = (FreeObject*)ptr;
+    obj->next = size_class.free;
+    size_class.free = obj;
+    size_class.in_use--;
+}
+
+// Prints how each group is used, for tuning the group sizes.
+void ObjectPool::print_stats()
+{
+    if (!OBJECT_POOL_ENABLED)
+    {
+        std::cout << "The object pool is disabled in this build.\n" << std::endl;
+        return;
+    }
+
+    for (int i = 0; i < CLASS_COUNT; i++)
+    {
+        const SizeClass& size_class = _classes[i];
+        if (size_class.chunks == 0) continue;
+        std::cout << (i+1)*GRANULARITY << " bytes: " << size_class.allocations << " allocations, "
+            << size_class.in_use << " in use, " << size_class.chunks*CHUNK_OBJECTS << " reserved" << std::endl;
+    }
+    std::cout << std::endl;
+}
@@ -21,11 +21,69 @@ namespace Objects
     // Refer to object-helpers.cpp.
     std::string type_to_string(Type type);
 
+    class Object;
+
+    // Enum class of the binary operators, in the order of the operator table.
+    enum class Operator
+    {
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        MODULO,
+        POWER,
+        AND,
+        OR,
+        XOR,
+        LESS,
+        GREATER,
+        LESS_EQUALS,
+        GREATER_EQUALS,
+        EQUALS,
+        NOT_EQUALS
+    };
+
+    // Refer to operator-table.cpp.
+    Object* operate(Operator op, Object* left, Object* right);
+
+    // Refer to object-pool.cpp.
+    class ObjectPool final
+    {
+    private:
+        struct FreeObject
+        {
+            FreeObject* next;
+        };
+
+        struct SizeClass
+        {
+            FreeObject* free;
+            long long in_use;
+            long long allocations;
+            long long chunks;
+        };
+
+        static const size_t GRANULARITY = 16;
+        static const int CLASS_COUNT = 8;
+        static const int CHUNK_OBJECTS = 256;
+        static thread_local SizeClass _classes[CLASS_COUNT];
+
+        static void refill(SizeClass& size_class, size_t size);
+    public:
+        static void* allocate(size_t size);
+        static void deallocate(void* ptr, size_t size);
+        static void print_stats();
+    };
+
     // Refer to base-object.cpp.
     class Object
     {
     public:
         virtual ~Object();
+        static void* operator new(size_t size);
+        static void* operator new(size_t size, void* ptr);
+        static void operator delete(void* ptr, size_t size);
+        static bool is_shared(const Object* obj);
         
         virtual Type type() const = 0;
         virtual std::string to_string() const = 0;
@@ -38,6 +96,8 @@ namespace Objects
         virtual Object* powered_by(Object* other) const;
         virtual Object* accessed_by(Object* other) const;
         virtual Object* notted() const;
+        virtual Object* negated() const;
+        virtual Object* posited() const;
         virtual Object* less_than(Object* other) const;
         virtual Object* greater_than(Object* other) const;
         virtual Object* equals(Object* other) const;
@@ -57,6 +117,7 @@ namespace Objects
         bool _value;   
     public:
         Boolean(bool value);
+        static Boolean* make(bool value);
         Type type() const;
         std::string to_string() const;
         bool get_value() const;
@@ -76,9 +137,11 @@ namespace Objects
         long long _value;   
     public:
         Integer(long long value);
+        static Integer* make(long long value);
         Type type() const;
         std::string to_string() const;
         long long get_value() const;
+        void set_value(long long value);
 
         Object* added_by(Object* other) const;
         Object* subtracted_by(Object* other) const;
@@ -86,6 +149,8 @@ namespace Objects
         Object* divided_by(Object* other) const;
         Object* modded_by(Object* other) const;
         Object* powered_by(Object* other) const;
+        Object* negated() const;
+        Object* posited() const;
         Object* less_than(Object* other) const;
         Object* greater_than(Object* other) const;
         Object* equals(Object* other) const;
@@ -99,6 +164,7 @@ namespace Objects
         long double _value;   
     public:
         Double(long double value);
+        static Double* make(long double value);
         Type type() const;
         std::string to_string() const;
         long double get_value() const;
@@ -108,6 +174,8 @@ namespace Objects
         Object* multiplied_by(Object* other) const;
         Object* divided_by(Object* other) const;
         Object* powered_by(Object* other) const;
+        Object* negated() const;
+        Object* posited() const;
         Object* less_than(Object* other) const;
         Object* greater_than(Object* other) const;
         Object* equals(Object* other) const;
@@ -131,6 +199,7 @@ namespace Objects
         Object* added_by(Object* other) const;
         Object* multiplied_by(Object* other) const;
         Object* accessed_by(Object* other) const;
+        Object* posited() const;
         Object* less_than(Object* other) const;
         Object* greater_than(Object* other) const;
         Object* equals(Object* other) const;
@@ -172,20 +241,18 @@ namespace Objects
         std::string _name;
         std::vector<std::string> _argument_names;
         void* _body;
-        bool _built_in;
     public:
-        Function(std::string name, std::vector<std::string>& argument_names, void* body, bool built_in = false);
+        Function(std::string name, std::vector<std::string>& argument_names, void* body);
         
         Type type() const;
         std::string to_string() const;
 
-        std::string get_name() const;
+        const std::string& get_name() const;
 
         int get_argument_size() const;
-        std::string get_argument_name(int i) const;
+        const std::string& get_argument_name(int i) const;
         std::vector<std::string> get_argument_names() const;
         void* get_body() const;
-        bool is_built_in() const;
 
         Object* equals(Object* other) const;
         Object* copy();
@@ -196,6 +263,7 @@ namespace Objects
     {
     public:
         None();
+        static None* make();
         Type type() const;
         std::string to_string() const;
 
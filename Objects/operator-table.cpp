@@ -0,0 +1,138 @@
+#include "object.h"
+#include <array>
+#include <utility>
+#include <type_traits>
+
+using namespace Objects;
+
+const int TYPE_COUNT = (int)Type::NONE + 1;
+const int OPERATOR_COUNT = (int)Operator::NOT_EQUALS + 1;
+
+typedef Object* (*Operation)(Object* left, Object* right);
+
+constexpr bool is_number(Type type)
+{
+    return type == Type::INTEGER || type == Type::DOUBLE;
+}
+
+// Reads an integer or a double as its own C++ type, so mixed operations promote the same way the objects do.
+template <Type T>
+auto get_number(Object* obj)
+{
+    if constexpr (T == Type::INTEGER) return ((Integer*)obj)->get_value();
+    else return ((Double*)obj)->get_value();
+}
+
+// The other operations are left to the objects, which return none when the operation is illegal.
+template <Operator op>
+Object* operate_objects(Object* left, Object* right)
+{
+    if constexpr (op == Operator::ADD) return left->added_by(right);
+    else if constexpr (op == Operator::SUBTRACT) return left->subtracted_by(right);
+    else if constexpr (op == Operator::MULTIPLY) return left->multiplied_by(right);
+    else if constexpr (op == Operator::DIVIDE) return left->divided_by(right);
+    else if constexpr (op == Operator::MODULO) return left->modded_by(right);
+    else if constexpr (op == Operator::POWER) return left->powered_by(right);
+    else if constexpr (op == Operator::AND) return left->and_with(right);
+    else if constexpr (op == Operator::OR) return left->or_with(right);
+    else if constexpr (op == Operator::XOR) return left->xor_with(right);
+    else if constexpr (op == Operator::LESS) return left->less_than(right);
+    else if constexpr (op == Operator::GREATER) return left->greater_than(right);
+    else if constexpr (op == Operator::LESS_EQUALS) return left->less_equals(right);
+    else if constexpr (op == Operator::GREATER_EQUALS) return left->greater_equals(right);
+    else if constexpr (op == Operator::EQUALS) return left->equals(right);
+    else return left->not_equals(right);
+}
+
+// Division by zero returns nullptr. The comparisons are negated the same way the objects do it, so NaN
+// compares the same.
+template <Operator op, Type L, Type R>
+Object* operate_numbers(Object* left, Object* right)
+{
+    typedef std::conditional_t<L == Type::INTEGER && R == Type::INTEGER, Integer, Double> Number;
+    auto l = get_number<L>(left);
+    auto r = get_number<R>(right);
+
+    if constexpr (op == Operator::ADD) return Number::make(l + r);
+    else if constexpr (op == Operator::SUBTRACT) return Number::make(l - r);
+    else if constexpr (op == Operator::MULTIPLY) return Number::make(l * r);
+    else if constexpr (op == Operator::DIVIDE)
+    {
+        if (r == 0) return nullptr;
+        return Number::make(l / r);
+    }
+    else if constexpr (op == Operator::MODULO && std::is_same_v<Number, Integer>)
+    {
+        if (r == 0) return nullptr;
+        return Integer::make(l % r);
+    }
+    else if constexpr (op == Operator::LESS) return Boolean::make(l < r);
+    else if constexpr (op == Operator::GREATER) return Boolean::make(l > r);
+    else if constexpr (op == Operator::LESS_EQUALS) return Boolean::make(!(l > r));
+    else if constexpr (op == Operator::GREATER_EQUALS) return Boolean::make(!(l < r));
+    else if constexpr (op == Operator::EQUALS) return Boolean::make(l == r);
+    else if constexpr (op == Operator::NOT_EQUALS) return Boolean::make(!(l == r));
+    else return operate_objects<op>(left, right);
+}
+
+template <Operator op>
+Object* operate_booleans(Object* left, Object* right)
+{
+    bool l = ((Boolean*)left)->get_value();
+    bool r = ((Boolean*)right)->get_value();
+
+    if constexpr (op == Operator::AND) return Boolean::make(l && r);
+    else if constexpr (op == Operator::OR) return Boolean::make(l || r);
+    else if constexpr (op == Operator::XOR) return Boolean::make(l ^ r);
+    else if constexpr (op == Operator::EQUALS) return Boolean::make(l == r);
+    else if constexpr (op == Operator::NOT_EQUALS) return Boolean::make(l != r);
+    else return nullptr;
+}
+
+template <Operator op>
+Object* operate_strings(Object* left, Object* right)
+{
+    if constexpr (op == Operator::ADD || op == Operator::MULTIPLY || op == Operator::POWER)
+        return operate_objects<op>(left, right);
+    else
+    {
+        std::string l = ((String*)left)->get_value();
+        std::string r = ((String*)right)->get_value();
+
+        if constexpr (op == Operator::LESS) return Boolean::make(l < r);
+        else if constexpr (op == Operator::GREATER) return Boolean::make(l > r);
+        else if constexpr (op == Operator::LESS_EQUALS) return Boolean::make(!(l > r));
+        else if constexpr (op == Operator::GREATER_EQUALS) return Boolean::make(!(l < r));
+        else if constexpr (op == Operator::EQUALS) return Boolean::make(l == r);
+        else if constexpr (op == Operator::NOT_EQUALS) return Boolean::make(l != r);
+        else return nullptr;
+    }
+}
+
+// One entry of the table. The operand types are known here, so the common cases skip the virtual methods.
+template <Operator op, Type L, Type R>
+Object* operate_types(Object* left, Object* right)
+{
+    if constexpr (is_number(L) && is_number(R)) return operate_numbers<op, L, R>(left, right);
+    else if constexpr (L == Type::BOOLEAN && R == Type::BOOLEAN) return operate_booleans<op>(left, right);
+    else if constexpr (L == Type::STRING && R == Type::STRING) return operate_strings<op>(left, right);
+    else return operate_objects<op>(left, right);
+}
+
+template <int... I>
+constexpr std::array<Operation, sizeof...(I)> make_table(std::integer_sequence<int, I...>)
+{
+    return {{&operate_types<(Operator)(I / (TYPE_COUNT*TYPE_COUNT)), (Type)(I / TYPE_COUNT % TYPE_COUNT),
+        (Type)(I % TYPE_COUNT)>...}};
+}
+
+// The table is indexed by the operator, then the type of the left operand, then the type of the right one.
+constexpr std::array<Operation, OPERATOR_COUNT*TYPE_COUNT*TYPE_COUNT> OPERATION_TABLE =
+    make_table(std::make_integer_sequence<int, OPERATOR_COUNT*TYPE_COUNT*TYPE_COUNT>());
+
+// Returns none or nullptr when the operation is illegal for these operands.
+Object* Objects::operate(Operator op, Object* left, Object* right)
+{
+    int i = ((int)op*TYPE_COUNT + (int)left->type())*TYPE_COUNT + (int)right->type();
+    return OPERATION_TABLE[i](left, right);
+}
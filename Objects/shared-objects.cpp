@@ -0,0 +1,81 @@
+#include "object.h"
+#include <new>
+
+using namespace Objects;
+
+// None, true, false and the small integers are shared, so making one doesn't allocate anything.
+// They live in static storage and are never freed. Deleting one puts it back the way it was, so every owner
+// can still delete what it gets without checking. A shared object must never be changed,
+// refer to evaluate_counted_loop.
+const long long MIN_SMALL_INTEGER = -128;
+const long long MAX_SMALL_INTEGER = 1023;
+const int SMALL_INTEGER_COUNT = MAX_SMALL_INTEGER - MIN_SMALL_INTEGER + 1;
+
+alignas(None) static unsigned char none_storage[sizeof(None)];
+alignas(Boolean) static unsigned char boolean_storage[2][sizeof(Boolean)];
+alignas(Integer) static unsigned char integer_storage[SMALL_INTEGER_COUNT][sizeof(Integer)];
+
+static None* shared_none;
+static Boolean* shared_booleans[2];
+static Integer* shared_integers[SMALL_INTEGER_COUNT];
+
+static bool make_shared_objects()
+{
+    shared_none = new (none_storage) None();
+    shared_booleans[0] = new (boolean_storage[0]) Boolean(false);
+    shared_booleans[1] = new (boolean_storage[1]) Boolean(true);
+    for (int i = 0; i < SMALL_INTEGER_COUNT; i++)
+        shared_integers[i] = new (integer_storage[i]) Integer(MIN_SMALL_INTEGER + i);
+    return true;
+}
+
+static bool is_made = make_shared_objects();
+
+template <typename T>
+static bool is_in(const void* ptr, const T& storage)
+{
+    const unsigned char* p = (const unsigned char*)ptr;
+    const unsigned char* begin = (const unsigned char*)&storage;
+    return p >= begin && p < begin + sizeof(storage);
+}
+
+None* None::make()
+{
+    return shared_none;
+}
+
+Boolean* Boolean::make(bool value)
+{
+    return shared_booleans[value];
+}
+
+Integer* Integer::make(long long value)
+{
+    if (value < MIN_SMALL_INTEGER || value > MAX_SMALL_INTEGER) return new Integer(value);
+    return shared_integers[value - MIN_SMALL_INTEGER];
+}
+
+// Doubles are never shared. This is for code that makes either kind of number.
+Double* Double::make(long double value)
+{
+    return new Double(value);
+}
+
+bool Object::is_shared(const Object* obj)
+{
+    return is_in(obj, none_storage) || is_in(obj, boolean_storage) || is_in(obj, integer_storage);
+}
+
+// By the time this runs the object has been destroyed, so a shared one is made again in the same place.
+// Everything else goes back to the pool.
+void Object::operator delete(void* ptr, size_t size)
+{
+    if (is_in(ptr, none_storage)) new (ptr) None();
+    else if (is_in(ptr, boolean_storage)) new (ptr) Boolean(ptr != boolean_storage[0]);
+    else if (is_in(ptr, integer_storage))
+    {
+        long long i = ((unsigned char*)ptr - &integer_storage[0][0]) / sizeof(Integer);
+        new (ptr) Integer(MIN_SMALL_INTEGER + i);
+    }
+    else ObjectPool::deallocate(ptr, size);
+}
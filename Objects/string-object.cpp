@@ -34,7 +34,7 @@ Object* String::added_by(Object* other) const
         case Type::STRING:
             return new String(_value + ((String*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -46,7 +46,7 @@ Object* String::multiplied_by(Object* other) const
         case Type::INTEGER:
         {
             long long e = ((Integer*)other)->get_value();
-            if (e < 0) return new None();
+            if (e < 0) return None::make();
             std::string result;
             std::string base = _value;
             while (e > 0)
@@ -58,7 +58,7 @@ Object* String::multiplied_by(Object* other) const
             return new String(result);
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -72,23 +72,29 @@ Object* String::accessed_by(Object* other) const
             long long i = ((Integer*)other)->get_value();
             int n = _value.size();
             if (i < 0) i += n;
-            if (i < 0 || i >= n) return new None();
+            if (i < 0 || i >= n) return None::make();
             return new String(_value.substr(i, 1));
         }
         default:
-            return new None();
+            return None::make();
     }
 }
 
+// Unary plus leaves the string as it is, the same as multiplying it by one.
+Object* String::posited() const
+{
+    return new String(_value);
+}
+
 // Returns the respective booleans.
 Object* String::less_than(Object* other) const
 {
     switch (other->type())
     {
         case Type::STRING:
-            return new Boolean(_value<((String*)other)->get_value());
+            return Boolean::make(_value<((String*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -97,9 +103,9 @@ Object* String::greater_than(Object* other) const
     switch (other->type())
     {
         case Type::STRING:
-            return new Boolean(_value>((String*)other)->get_value());
+            return Boolean::make(_value>((String*)other)->get_value());
         default:
-            return new None();
+            return None::make();
     }
 }
 
@@ -108,9 +114,9 @@ Object* String::equals(Object* other) const
     switch (other->type())
     {
         case Type::STRING:
-            return new Boolean(_value==((String*)other)->get_value());
+            return Boolean::make(_value==((String*)other)->get_value());
         default:
-            return new Boolean(false);
+            return Boolean::make(false);
     }
 }
 
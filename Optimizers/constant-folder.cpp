@@ -0,0 +1,196 @@
+#include "optimizers.h"
+#include "../Evaluators/evaluator.h"
+
+using namespace Optimizers;
+using namespace Syntax;
+using namespace Objects;
+using Evaluators::Evaluator;
+
+// Folding a string multiplication would build the whole string ahead of time, even in code that never runs.
+// Anything longer than this is left for the evaluator.
+const long long MAX_FOLDED_STRING = 1 << 16;
+
+bool ConstantFolder::is_constant(SyntaxNode* node)
+{
+    return node->kind() == SyntaxKind::LiteralExpression && ((LiteralExpressionSyntax*)node)->get_object() != nullptr;
+}
+
+Object* ConstantFolder::get_constant(SyntaxNode* node)
+{
+    return ((LiteralExpressionSyntax*)node)->get_object();
+}
+
+bool ConstantFolder::is_too_large(SyntaxKind op_kind, Object* left, Object* right)
+{
+    if (op_kind != SyntaxKind::StarToken) return false;
+    if (left->type() == Type::INTEGER && right->type() == Type::STRING)
+        std::swap(left, right);
+    if (left->type() != Type::STRING || right->type() != Type::INTEGER) return false;
+
+    long long length = ((String*)left)->get_size();
+    long long times = ((Integer*)right)->get_value();
+    return length > 0 && times > MAX_FOLDED_STRING/length;
+}
+
+// Swaps the node for a literal that keeps the node's position.
+SyntaxNode* ConstantFolder::replace(SyntaxNode* node, Object* value)
+{
+    SyntaxNode* literal = new LiteralExpressionSyntax(value, node->get_pos());
+    delete node;
+    return literal;
+}
+
+// Folds the constant parts of the tree. This runs after parsing and before evaluation.
+// Returns the node that takes the place of the given node, which is deleted if it was replaced.
+SyntaxNode* ConstantFolder::fold(SyntaxNode* node)
+{
+    if (node == nullptr) return nullptr;
+
+    switch (node->kind())
+    {
+        case SyntaxKind::UnaryExpression:
+            return fold_unary((UnaryExpressionSyntax*)node);
+        case SyntaxKind::BinaryExpression:
+            return fold_binary((BinaryExpressionSyntax*)node);
+        case SyntaxKind::IndexExpression:
+            return fold_index((IndexExpressionSyntax*)node);
+        case SyntaxKind::SequenceExpression:
+            return fold_sequence((SequenceExpressionSyntax*)node);
+        case SyntaxKind::VarAssignExpression:
+        {
+            VarAssignExpressionSyntax* t = (VarAssignExpressionSyntax*)node;
+            t->set_value(fold(t->get_value()));
+            return node;
+        }
+        case SyntaxKind::WhileExpression:
+        {
+            WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            t->set_condition(fold(t->get_condition()));
+            t->set_body(fold(t->get_body()));
+            return node;
+        }
+        case SyntaxKind::ForExpression:
+        {
+            ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            t->set_init(fold(t->get_init()));
+            t->set_condition(fold(t->get_condition()));
+            t->set_update(fold(t->get_update()));
+            t->set_body(fold(t->get_body()));
+            return node;
+        }
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            int n = t->get_size();
+            for (int i = 0; i < n; i++)
+            {
+                t->set_condition(i, fold(t->get_condition(i)));
+                t->set_body(i, fold(t->get_body(i)));
+            }
+            t->set_else_body(fold(t->get_else_body()));
+            return node;
+        }
+        case SyntaxKind::FuncDefineExpression:
+        {
+            FuncDefineExpressionSyntax* t = (FuncDefineExpressionSyntax*)node;
+            t->set_body(fold(t->get_body()));
+            return node;
+        }
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                t->set_arg(i, fold(t->get_arg(i)));
+            return node;
+        }
+        case SyntaxKind::ReturnExpression:
+        {
+            ReturnExpressionSyntax* t = (ReturnExpressionSyntax*)node;
+            t->set_to_return(fold(t->get_to_return()));
+            return node;
+        }
+        default:
+            return node;
+    }
+}
+
+// An operation that fails is left for the evaluator, which reports it only if that code actually runs.
+SyntaxNode* ConstantFolder::fold_unary(UnaryExpressionSyntax* node)
+{
+    node->set_operand(fold(node->get_operand()));
+    if (!is_constant(node->get_operand())) return node;
+
+    Object* operand = get_constant(node->get_operand());
+    Object* result = Evaluator::apply_unary(node->get_op_token()->kind(), operand);
+    if (result == nullptr || result->type() == Type::NONE)
+    {
+        delete result;
+        return node;
+    }
+    return replace(node, result);
+}
+
+SyntaxNode* ConstantFolder::fold_binary(BinaryExpressionSyntax* node)
+{
+    SyntaxKind op_kind = node->get_op_token()->kind();
+    node->set_left(fold(node->get_left()));
+    node->set_right(fold(node->get_right()));
+    if (!is_constant(node->get_left())) return node;
+
+    // A constant left operand can decide 'and' and 'or' on its own, the right operand would never run.
+    Object* left = get_constant(node->get_left());
+    bool is_and = op_kind == SyntaxKind::AndKeyword || op_kind == SyntaxKind::DAmpersandToken;
+    bool is_or = op_kind == SyntaxKind::OrKeyword || op_kind == SyntaxKind::DPipeToken;
+    if ((is_and || is_or) && left->type() == Type::BOOLEAN && ((Boolean*)left)->get_value() == is_or)
+        return replace(node, left->copy());
+
+    if (!is_constant(node->get_right())) return node;
+
+    Object* right = get_constant(node->get_right());
+    if (is_too_large(op_kind, left, right)) return node;
+
+    Object* result = Evaluator::apply_binary(op_kind, left, right);
+    if (result == nullptr || result->type() == Type::NONE)
+    {
+        delete result;
+        return node;
+    }
+    return replace(node, result);
+}
+
+SyntaxNode* ConstantFolder::fold_index(IndexExpressionSyntax* node)
+{
+    node->set_to_access(fold(node->get_to_access()));
+    node->set_indexer(fold(node->get_indexer()));
+    if (!is_constant(node->get_to_access()) || !is_constant(node->get_indexer())) return node;
+
+    Object* left = get_constant(node->get_to_access());
+    Object* right = get_constant(node->get_indexer());
+    Object* result = left->accessed_by(right);
+    if (result->type() == Type::NONE)
+    {
+        delete result;
+        return node;
+    }
+    return replace(node, result);
+}
+
+// A list whose elements are all constants is built once here, instead of element by element on every evaluation.
+SyntaxNode* ConstantFolder::fold_sequence(SequenceExpressionSyntax* node)
+{
+    bool all_constant = true;
+    int n = node->get_nodes_size();
+    for (int i = 0; i < n; i++)
+    {
+        node->set_node(i, fold(node->get_node(i)));
+        all_constant &= is_constant(node->get_node(i));
+    }
+
+    if (!node->get_to_return() || !all_constant) return node;
+
+    std::vector<Object*> elements;
+    for (int i = 0; i < n; i++)
+        elements.push_back(get_constant(node->get_node(i))->copy());
+    return replace(node, new List(elements));
+}
@@ -0,0 +1,234 @@
+#include "optimizers.h"
+
+using namespace Optimizers;
+using namespace Syntax;
+using namespace Objects;
+
+// The children of a node that get evaluated, in no particular order.
+std::vector<SyntaxNode*> CountedLoops::get_children(SyntaxNode* node)
+{
+    switch (node->kind())
+    {
+        case SyntaxKind::UnaryExpression:
+            return {((UnaryExpressionSyntax*)node)->get_operand()};
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            return {t->get_left(), t->get_right()};
+        }
+        case SyntaxKind::BoundBinaryExpression:
+        {
+            BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)node;
+            return {t->get_left(), t->get_right()};
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            return {t->get_to_access(), t->get_indexer()};
+        }
+        case SyntaxKind::SequenceExpression:
+            return ((SequenceExpressionSyntax*)node)->get_nodes();
+        case SyntaxKind::VarAssignExpression:
+            return {((VarAssignExpressionSyntax*)node)->get_value()};
+        case SyntaxKind::WhileExpression:
+        {
+            WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            return {t->get_condition(), t->get_body()};
+        }
+        case SyntaxKind::ForExpression:
+        {
+            ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            return {t->get_init(), t->get_condition(), t->get_update(), t->get_body()};
+        }
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            std::vector<SyntaxNode*> children = t->get_conditions();
+            for (SyntaxNode* body : t->get_bodies()) children.push_back(body);
+            children.push_back(t->get_else_body());
+            return children;
+        }
+        case SyntaxKind::FuncDefineExpression:
+            return {((FuncDefineExpressionSyntax*)node)->get_body()};
+        case SyntaxKind::FuncCallExpression:
+            return ((FuncCallExpressionSyntax*)node)->get_args();
+        case SyntaxKind::ReturnExpression:
+            return {((ReturnExpressionSyntax*)node)->get_to_return()};
+        case SyntaxKind::HoistedExpression:
+            return {((HoistedExpressionSyntax*)node)->get_expression()};
+        case SyntaxKind::InlinedCallExpression:
+        {
+            // The call is still there in case it has to run, so a loop with one is treated as calling it.
+            InlinedCallExpressionSyntax* t = (InlinedCallExpressionSyntax*)node;
+            return {t->get_call(), t->get_body()};
+        }
+        default:
+            return {};
+    }
+}
+
+// Records what running the node can do to variables. Function bodies aren't run where they are defined,
+// so only the name of the function is written.
+void CountedLoops::scan(SyntaxNode* node, Effects& effects)
+{
+    if (node == nullptr) return;
+
+    switch (node->kind())
+    {
+        case SyntaxKind::VarAccessExpression:
+            effects.reads.insert(((VarAccessExpressionSyntax*)node)->get_identifier()->get_text());
+            return;
+        case SyntaxKind::VarDeclareExpression:
+            effects.writes.insert(((VarDeclareExpressionSyntax*)node)->get_identifier()->get_text());
+            return;
+        case SyntaxKind::VarAssignExpression:
+            effects.writes.insert(((VarAssignExpressionSyntax*)node)->get_identifier()->get_text());
+            break;
+        case SyntaxKind::FuncDefineExpression:
+            effects.writes.insert(((FuncDefineExpressionSyntax*)node)->get_identifier()->get_text());
+            return;
+        case SyntaxKind::FuncCallExpression:
+        {
+            // A user-defined function sees the variables of its caller, so it can change any of them.
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            SyntaxKind kind = t->get_identifier()->kind();
+            if (t->get_builtin() == nullptr) effects.has_user_calls = true;
+            else if (kind == SyntaxKind::PrintFunction || kind == SyntaxKind::InputFunction) effects.has_io = true;
+            break;
+        }
+        case SyntaxKind::ContinueExpression:
+            effects.has_continue = true;
+            return;
+        default:
+            break;
+    }
+
+    for (SyntaxNode* child : get_children(node))
+        scan(child, effects);
+}
+
+// The limit is evaluated once, so it can't depend on anything the loop changes.
+bool CountedLoops::is_invariant(SyntaxNode* limit, const std::string& variable, Effects& body)
+{
+    Effects effects;
+    scan(limit, effects);
+    if (effects.has_user_calls || effects.has_io || !effects.writes.empty()) return false;
+
+    for (const std::string& name : effects.reads)
+        if (name == variable || body.writes.count(name)) return false;
+    return true;
+}
+
+// Matches conditions like 'i < n' where both sides are integers.
+bool CountedLoops::match_condition(SyntaxNode* condition, CountedLoop& loop)
+{
+    if (condition == nullptr || condition->kind() != SyntaxKind::BoundBinaryExpression) return false;
+
+    BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)condition;
+    switch (t->get_op())
+    {
+        case BoundBinaryOperator::IntLess:
+        case BoundBinaryOperator::IntGreater:
+        case BoundBinaryOperator::IntLessEquals:
+        case BoundBinaryOperator::IntGreaterEquals:
+            break;
+        default:
+            return false;
+    }
+    if (t->get_left()->kind() != SyntaxKind::VarAccessExpression) return false;
+
+    loop.variable = ((VarAccessExpressionSyntax*)t->get_left())->get_identifier()->get_text();
+    loop.compare = t->get_op();
+    loop.limit = t->get_right();
+    return true;
+}
+
+// Matches updates like 'i = i + 1', 'i = 2 + i' or 'i = i - 2'.
+bool CountedLoops::match_update(SyntaxNode* update, CountedLoop& loop)
+{
+    if (update == nullptr || update->kind() != SyntaxKind::VarAssignExpression) return false;
+
+    VarAssignExpressionSyntax* assign = (VarAssignExpressionSyntax*)update;
+    if (assign->get_identifier()->get_text() != loop.variable) return false;
+    if (assign->get_value()->kind() != SyntaxKind::BoundBinaryExpression) return false;
+
+    BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)assign->get_value();
+    SyntaxNode* counter = t->get_left();
+    SyntaxNode* step = t->get_right();
+    if (t->get_op() == BoundBinaryOperator::IntAdd && step->kind() == SyntaxKind::VarAccessExpression)
+        std::swap(counter, step);
+    else if (t->get_op() != BoundBinaryOperator::IntAdd && t->get_op() != BoundBinaryOperator::IntSubtract)
+        return false;
+
+    if (counter->kind() != SyntaxKind::VarAccessExpression || step->kind() != SyntaxKind::LiteralExpression)
+        return false;
+    if (((VarAccessExpressionSyntax*)counter)->get_identifier()->get_text() != loop.variable) return false;
+
+    Object* value = ((LiteralExpressionSyntax*)step)->get_object();
+    if (value == nullptr || value->type() != Type::INTEGER) return false;
+
+    loop.step = ((Integer*)value)->get_value();
+    if (t->get_op() == BoundBinaryOperator::IntSubtract) loop.step = -loop.step;
+    return true;
+}
+
+// Finds the counted loops in the tree. This runs after the binder, since it relies on the bound comparisons
+// to know that the counter and the limit are integers. It should be the last pass to change the tree,
+// because the loops point into their own conditions and bodies.
+void CountedLoops::find(SyntaxNode* node)
+{
+    if (node == nullptr) return;
+
+    for (SyntaxNode* child : get_children(node))
+        find(child);
+
+    if (node->kind() == SyntaxKind::ForExpression)
+        find_for((ForExpressionSyntax*)node);
+    else if (node->kind() == SyntaxKind::WhileExpression)
+        find_while((WhileExpressionSyntax*)node);
+}
+
+// A for loop whose body doesn't touch the counter. A 'continue' still runs the update, so it's allowed.
+void CountedLoops::find_for(ForExpressionSyntax* node)
+{
+    CountedLoop loop;
+    if (!match_condition(node->get_condition(), loop) || !match_update(node->get_update(), loop)) return;
+
+    Effects effects;
+    scan(node->get_body(), effects);
+    if (effects.has_user_calls || effects.writes.count(loop.variable)) return;
+    if (!is_invariant(loop.limit, loop.variable, effects)) return;
+
+    loop.body = {node->get_body()};
+    loop.is_read = effects.reads.count(loop.variable) > 0;
+    node->set_counted_loop(new CountedLoop(loop));
+}
+
+// A while loop whose body ends with the update, like the 'while(i < N) i = i + 1;' in the README.
+// A 'continue' would skip the update, so it isn't allowed.
+void CountedLoops::find_while(WhileExpressionSyntax* node)
+{
+    CountedLoop loop;
+    if (!match_condition(node->get_condition(), loop)) return;
+
+    SyntaxNode* body = node->get_body();
+    if (body->kind() == SyntaxKind::SequenceExpression)
+    {
+        SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)body;
+        int n = t->get_nodes_size();
+        if (n == 0) return;
+        for (int i = 0; i < n-1; i++)
+            loop.body.push_back(t->get_node(i));
+        body = t->get_node(n-1);
+    }
+    if (!match_update(body, loop)) return;
+
+    Effects effects;
+    for (SyntaxNode* statement : loop.body)
+        scan(statement, effects);
+    if (effects.has_user_calls || effects.has_continue || effects.writes.count(loop.variable)) return;
+    if (!is_invariant(loop.limit, loop.variable, effects)) return;
+
+    loop.is_read = effects.reads.count(loop.variable) > 0;
+    node->set_counted_loop(new CountedLoop(loop));
+}
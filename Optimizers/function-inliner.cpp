@@ -0,0 +1,343 @@
+#include "optimizers.h"
+#include "../Evaluators/evaluator.h"
+#include "../Diagnostics/diagnostic.h"
+
+using namespace Optimizers;
+using namespace Syntax;
+
+// Inlines small functions where they're called. A function that's defined once at the top of the program,
+// whose name nothing else declares or assigns, and whose body is just 'return' and a small expression, has
+// a copy of that expression put in place of each call with the right number of arguments. The parameters in
+// the copy become ParameterExpressionSyntax nodes, which read the arguments of the call straight from the
+// InlinedCallExpressionSyntax instead of from variables in a new context.
+//
+// The expression may only use variables, literals, operators, indexing, lists and builtins, so an inlined
+// function never calls another function, and never itself. Since a name can still be shadowed, or be assigned
+// inside a body that hasn't been parsed yet, the inlined call checks that the name still holds the function
+// before it uses the copy, and runs the call as written otherwise. Refer to evaluate_inlined_call.
+// This runs after the binder and before LoopInvariants.
+
+std::unordered_map<std::string, FunctionInliner::Inlinable> FunctionInliner::_functions;
+std::unordered_map<std::string, int> FunctionInliner::_writes;
+
+// Counts the declarations, assignments and definitions of each name.
+void FunctionInliner::count_writes(SyntaxNode* node)
+{
+    if (node == nullptr) return;
+
+    switch (node->kind())
+    {
+        case SyntaxKind::VarDeclareExpression:
+            _writes[((VarDeclareExpressionSyntax*)node)->get_identifier()->get_text()]++;
+            break;
+        case SyntaxKind::VarAssignExpression:
+            _writes[((VarAssignExpressionSyntax*)node)->get_identifier()->get_text()]++;
+            break;
+        case SyntaxKind::FuncDefineExpression:
+            _writes[((FuncDefineExpressionSyntax*)node)->get_identifier()->get_text()]++;
+            break;
+        default:
+            break;
+    }
+
+    for (SyntaxNode* child : CountedLoops::get_children(node))
+        count_writes(child);
+}
+
+// Whether the expression is made of what an inlined function may use, and is small enough to copy.
+bool FunctionInliner::is_small(SyntaxNode* node, int& size)
+{
+    if (++size > MAX_SIZE) return false;
+
+    switch (node->kind())
+    {
+        case SyntaxKind::LiteralExpression:
+        case SyntaxKind::VarAccessExpression:
+            return true;
+        case SyntaxKind::SequenceExpression:
+            if (!((SequenceExpressionSyntax*)node)->get_to_return()) return false;
+            break;
+        case SyntaxKind::FuncCallExpression:
+            if (((FuncCallExpressionSyntax*)node)->get_builtin() == nullptr) return false;
+            break;
+        case SyntaxKind::UnaryExpression:
+        case SyntaxKind::BinaryExpression:
+        case SyntaxKind::BoundBinaryExpression:
+        case SyntaxKind::IndexExpression:
+            break;
+        default:
+            return false;
+    }
+
+    for (SyntaxNode* child : CountedLoops::get_children(node))
+    {
+        if (!is_small(child, size)) return false;
+    }
+    return true;
+}
+
+// The expression the function returns, or nullptr if it can't be inlined.
+// A body that was only pre-parsed is parsed now if it's short. If that reports anything, the errors are
+// left for the first call to report again, and the function isn't inlined.
+SyntaxNode* FunctionInliner::get_expression(FuncDefineExpressionSyntax* node)
+{
+    SyntaxNode* body = node->get_body();
+    if (body == nullptr) return nullptr;
+
+    if (body->kind() == SyntaxKind::LazyBodyExpression)
+    {
+        LazyBodyExpressionSyntax* lazy = (LazyBodyExpressionSyntax*)body;
+        if (lazy->get_body() == nullptr)
+        {
+            if (lazy->get_text().size() > MAX_LAZY_LENGTH) return nullptr;
+
+            std::vector<std::string> arg_names;
+            for (SyntaxToken& arg_name : node->get_arg_names())
+                arg_names.push_back(arg_name.get_text());
+            if (!Evaluators::Evaluator::compile_body(lazy, arg_names))
+            {
+                Diagnostics::DiagnosticBag::clear();
+                return nullptr;
+            }
+        }
+        body = lazy->get_body();
+    }
+
+    while (body->kind() == SyntaxKind::SequenceExpression && !((SequenceExpressionSyntax*)body)->get_to_return() &&
+        ((SequenceExpressionSyntax*)body)->get_nodes_size() == 1)
+        body = ((SequenceExpressionSyntax*)body)->get_node(0);
+    if (body->kind() != SyntaxKind::ReturnExpression) return nullptr;
+
+    SyntaxNode* expression = ((ReturnExpressionSyntax*)body)->get_to_return();
+    int size = 0;
+    if (expression == nullptr || !is_small(expression, size)) return nullptr;
+    return expression;
+}
+
+// Copies an expression that passed is_small, with the parameters of the function reading from the call.
+SyntaxNode* FunctionInliner::copy(SyntaxNode* node, FuncDefineExpressionSyntax* function,
+    InlinedCallExpressionSyntax* call)
+{
+    switch (node->kind())
+    {
+        case SyntaxKind::LiteralExpression:
+            return new LiteralExpressionSyntax(((LiteralExpressionSyntax*)node)->get_object()->copy(),
+                node->get_pos());
+        case SyntaxKind::VarAccessExpression:
+        {
+            SyntaxToken* identifier = ((VarAccessExpressionSyntax*)node)->get_identifier();
+            int n = function->get_arg_size();
+            for (int i = 0; i < n; i++)
+            {
+                if (function->get_arg_name(i)->get_text() == identifier->get_text())
+                    return new ParameterExpressionSyntax(call, i, *identifier, node->get_pos());
+            }
+            return new VarAccessExpressionSyntax(*identifier, node->get_pos());
+        }
+        case SyntaxKind::UnaryExpression:
+        {
+            UnaryExpressionSyntax* t = (UnaryExpressionSyntax*)node;
+            return new UnaryExpressionSyntax(*t->get_op_token(), copy(t->get_operand(), function, call),
+                node->get_pos());
+        }
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            return new BinaryExpressionSyntax(copy(t->get_left(), function, call), *t->get_op_token(),
+                copy(t->get_right(), function, call), node->get_pos());
+        }
+        case SyntaxKind::BoundBinaryExpression:
+        {
+            BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)node;
+            return new BoundBinaryExpressionSyntax(copy(t->get_left(), function, call), *t->get_op_token(),
+                copy(t->get_right(), function, call), t->get_op(), node->get_pos());
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            return new IndexExpressionSyntax(copy(t->get_to_access(), function, call),
+                copy(t->get_indexer(), function, call), node->get_pos());
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            std::vector<SyntaxNode*> nodes;
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+                nodes.push_back(copy(t->get_node(i), function, call));
+            return new SequenceExpressionSyntax(nodes, node->get_pos(), true);
+        }
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            std::vector<SyntaxNode*> args;
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                args.push_back(copy(t->get_arg(i), function, call));
+            FuncCallExpressionSyntax* result = new FuncCallExpressionSyntax(*t->get_identifier(), args,
+                node->get_pos());
+            result->set_args_write(t->args_write());
+            return result;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+// Registers the functions defined at the top of the program that can be inlined, then inlines their calls.
+// When a script runs one statement at a time, each statement comes through here, so a name that a later
+// statement writes again stops being inlined from then on.
+SyntaxNode* FunctionInliner::inline_program(SyntaxNode* root)
+{
+    if (root == nullptr) return nullptr;
+
+    count_writes(root);
+    for (auto it = _functions.begin(); it != _functions.end();)
+    {
+        if (_writes[it->first] > 1) it = _functions.erase(it);
+        else it++;
+    }
+
+    std::vector<SyntaxNode*> statements = {root};
+    if (root->kind() == SyntaxKind::SequenceExpression)
+        statements = ((SequenceExpressionSyntax*)root)->get_nodes();
+    for (SyntaxNode* statement : statements)
+    {
+        if (statement->kind() != SyntaxKind::FuncDefineExpression) continue;
+
+        FuncDefineExpressionSyntax* function = (FuncDefineExpressionSyntax*)statement;
+        std::string name = function->get_identifier()->get_text();
+        if (_writes[name] > 1) continue;
+
+        SyntaxNode* expression = get_expression(function);
+        if (expression != nullptr) _functions[name] = {function, expression};
+    }
+
+    return inline_calls(root);
+}
+
+// Puts the function's expression in place of a call to it.
+SyntaxNode* FunctionInliner::inline_call(FuncCallExpressionSyntax* node)
+{
+    if (node->get_builtin() != nullptr) return node;
+
+    auto it = _functions.find(node->get_identifier()->get_text());
+    if (it == _functions.end()) return node;
+    FuncDefineExpressionSyntax* function = it->second.function;
+    if (function->get_arg_size() != node->get_arg_size()) return node;
+
+    InlinedCallExpressionSyntax* call = new InlinedCallExpressionSyntax(node, function);
+    call->set_body(copy(it->second.expression, function, call));
+    return call;
+}
+
+// Inlines the calls under the node. Returns the node that takes the place of the given one.
+// The bodies of functions are included, except for those that haven't been parsed yet, which come through
+// here when they're parsed on their first call.
+SyntaxNode* FunctionInliner::inline_calls(SyntaxNode* node)
+{
+    if (node == nullptr) return nullptr;
+
+    switch (node->kind())
+    {
+        case SyntaxKind::UnaryExpression:
+        {
+            UnaryExpressionSyntax* t = (UnaryExpressionSyntax*)node;
+            t->set_operand(inline_calls(t->get_operand()));
+            break;
+        }
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            t->set_left(inline_calls(t->get_left()));
+            t->set_right(inline_calls(t->get_right()));
+            break;
+        }
+        case SyntaxKind::BoundBinaryExpression:
+        {
+            BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)node;
+            t->set_left(inline_calls(t->get_left()));
+            t->set_right(inline_calls(t->get_right()));
+            break;
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            t->set_to_access(inline_calls(t->get_to_access()));
+            t->set_indexer(inline_calls(t->get_indexer()));
+            break;
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+                t->set_node(i, inline_calls(t->get_node(i)));
+            break;
+        }
+        case SyntaxKind::VarAssignExpression:
+        {
+            VarAssignExpressionSyntax* t = (VarAssignExpressionSyntax*)node;
+            t->set_value(inline_calls(t->get_value()));
+            break;
+        }
+        case SyntaxKind::WhileExpression:
+        {
+            WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            t->set_condition(inline_calls(t->get_condition()));
+            t->set_body(inline_calls(t->get_body()));
+            break;
+        }
+        case SyntaxKind::ForExpression:
+        {
+            ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            t->set_init(inline_calls(t->get_init()));
+            t->set_condition(inline_calls(t->get_condition()));
+            t->set_update(inline_calls(t->get_update()));
+            t->set_body(inline_calls(t->get_body()));
+            break;
+        }
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            int n = t->get_size();
+            for (int i = 0; i < n; i++)
+            {
+                t->set_condition(i, inline_calls(t->get_condition(i)));
+                t->set_body(i, inline_calls(t->get_body(i)));
+            }
+            t->set_else_body(inline_calls(t->get_else_body()));
+            break;
+        }
+        case SyntaxKind::FuncDefineExpression:
+        {
+            FuncDefineExpressionSyntax* t = (FuncDefineExpressionSyntax*)node;
+            t->set_body(inline_calls(t->get_body()));
+            break;
+        }
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                t->set_arg(i, inline_calls(t->get_arg(i)));
+            return inline_call(t);
+        }
+        case SyntaxKind::ReturnExpression:
+        {
+            ReturnExpressionSyntax* t = (ReturnExpressionSyntax*)node;
+            t->set_to_return(inline_calls(t->get_to_return()));
+            break;
+        }
+        default:
+            break;
+    }
+    return node;
+}
+
+// The functions belong to the tree of the program, so they're forgotten once it's done running.
+void FunctionInliner::clear()
+{
+    _functions.clear();
+    _writes.clear();
+}
@@ -0,0 +1,218 @@
+#include "optimizers.h"
+#include "../Evaluators/builtin-functions.h"
+
+using namespace Optimizers;
+using namespace Syntax;
+
+// Loop-invariant code motion. An expression in a loop whose variables the loop never writes gives the same
+// value on every iteration, like the 'size(a)' in 'while (i < size(a))' or the 'n*m' in 'x = x + n*m'.
+// Such an expression is wrapped in a HoistedExpressionSyntax, which is evaluated the first time it's reached
+// and then keeps its value until the loop ends. Since it's still evaluated where it was, an expression that
+// would fail, or that a loop that never runs would never reach, does exactly what it did before.
+//
+// Only variables, literals, operators, indexing, lists and pure builtins are hoisted. A loop that calls a user
+// function is left alone, since the function sees the caller's variables and could write any of them.
+// This runs after the binder and before CountedLoops, which should stay the last pass to change the tree.
+
+// Whether the node gives the same value on every iteration of a loop with these effects.
+bool LoopInvariants::is_invariant(SyntaxNode* node, const CountedLoops::Effects& loop)
+{
+    switch (node->kind())
+    {
+        case SyntaxKind::LiteralExpression:
+        case SyntaxKind::HoistedExpression:
+            return true;
+        case SyntaxKind::VarAccessExpression:
+            return !loop.writes.count(((VarAccessExpressionSyntax*)node)->get_identifier()->get_text());
+        case SyntaxKind::SequenceExpression:
+            if (!((SequenceExpressionSyntax*)node)->get_to_return()) return false;
+            break;
+        case SyntaxKind::FuncCallExpression:
+        {
+            const Evaluators::BuiltIn* builtin = ((FuncCallExpressionSyntax*)node)->get_builtin();
+            if (builtin == nullptr || !builtin->is_pure) return false;
+            break;
+        }
+        case SyntaxKind::UnaryExpression:
+        case SyntaxKind::BinaryExpression:
+        case SyntaxKind::BoundBinaryExpression:
+        case SyntaxKind::IndexExpression:
+            break;
+        default:
+            return false;
+    }
+
+    for (SyntaxNode* child : CountedLoops::get_children(node))
+    {
+        if (!is_invariant(child, loop)) return false;
+    }
+    return true;
+}
+
+// A literal or a variable on its own costs as much as reading the hoisted value back.
+bool LoopInvariants::is_worth_hoisting(SyntaxNode* node)
+{
+    switch (node->kind())
+    {
+        case SyntaxKind::UnaryExpression:
+        case SyntaxKind::BinaryExpression:
+        case SyntaxKind::BoundBinaryExpression:
+        case SyntaxKind::IndexExpression:
+        case SyntaxKind::SequenceExpression:
+        case SyntaxKind::FuncCallExpression:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Wraps the largest invariant expressions under the node. Returns the node that takes the place of the given one.
+// The bodies of functions defined in the loop don't run in it, so they're left to their own loops.
+SyntaxNode* LoopInvariants::hoist(SyntaxNode* node, const CountedLoops::Effects& loop,
+    std::vector<HoistedExpressionSyntax*>& invariants)
+{
+    if (node == nullptr) return nullptr;
+
+    if (is_worth_hoisting(node) && is_invariant(node, loop))
+    {
+        HoistedExpressionSyntax* invariant = new HoistedExpressionSyntax(node);
+        invariants.push_back(invariant);
+        return invariant;
+    }
+
+    switch (node->kind())
+    {
+        case SyntaxKind::UnaryExpression:
+        {
+            UnaryExpressionSyntax* t = (UnaryExpressionSyntax*)node;
+            t->set_operand(hoist(t->get_operand(), loop, invariants));
+            break;
+        }
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            t->set_left(hoist(t->get_left(), loop, invariants));
+            t->set_right(hoist(t->get_right(), loop, invariants));
+            break;
+        }
+        case SyntaxKind::BoundBinaryExpression:
+        {
+            BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)node;
+            t->set_left(hoist(t->get_left(), loop, invariants));
+            t->set_right(hoist(t->get_right(), loop, invariants));
+            break;
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            t->set_to_access(hoist(t->get_to_access(), loop, invariants));
+            t->set_indexer(hoist(t->get_indexer(), loop, invariants));
+            break;
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+                t->set_node(i, hoist(t->get_node(i), loop, invariants));
+            break;
+        }
+        case SyntaxKind::VarAssignExpression:
+        {
+            VarAssignExpressionSyntax* t = (VarAssignExpressionSyntax*)node;
+            t->set_value(hoist(t->get_value(), loop, invariants));
+            break;
+        }
+        case SyntaxKind::WhileExpression:
+        {
+            WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            t->set_condition(hoist(t->get_condition(), loop, invariants));
+            t->set_body(hoist(t->get_body(), loop, invariants));
+            break;
+        }
+        case SyntaxKind::ForExpression:
+        {
+            ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            t->set_init(hoist(t->get_init(), loop, invariants));
+            t->set_condition(hoist(t->get_condition(), loop, invariants));
+            t->set_update(hoist(t->get_update(), loop, invariants));
+            t->set_body(hoist(t->get_body(), loop, invariants));
+            break;
+        }
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            int n = t->get_size();
+            for (int i = 0; i < n; i++)
+            {
+                t->set_condition(i, hoist(t->get_condition(i), loop, invariants));
+                t->set_body(i, hoist(t->get_body(i), loop, invariants));
+            }
+            t->set_else_body(hoist(t->get_else_body(), loop, invariants));
+            break;
+        }
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                t->set_arg(i, hoist(t->get_arg(i), loop, invariants));
+            break;
+        }
+        case SyntaxKind::ReturnExpression:
+        {
+            ReturnExpressionSyntax* t = (ReturnExpressionSyntax*)node;
+            t->set_to_return(hoist(t->get_to_return(), loop, invariants));
+            break;
+        }
+        default:
+            break;
+    }
+    return node;
+}
+
+// Hoists out of the outer loops first, so an inner loop finds what's invariant in both already hoisted,
+// and only keeps what changes with the outer loop for itself.
+void LoopInvariants::find(SyntaxNode* node)
+{
+    if (node == nullptr) return;
+
+    if (node->kind() == SyntaxKind::ForExpression)
+        hoist_for((ForExpressionSyntax*)node);
+    else if (node->kind() == SyntaxKind::WhileExpression)
+        hoist_while((WhileExpressionSyntax*)node);
+
+    for (SyntaxNode* child : CountedLoops::get_children(node))
+        find(child);
+}
+
+// The init runs once before the loop, so what it writes doesn't change between iterations.
+void LoopInvariants::hoist_for(ForExpressionSyntax* node)
+{
+    CountedLoops::Effects loop;
+    CountedLoops::scan(node->get_condition(), loop);
+    CountedLoops::scan(node->get_update(), loop);
+    CountedLoops::scan(node->get_body(), loop);
+    if (loop.has_user_calls) return;
+
+    std::vector<HoistedExpressionSyntax*> invariants;
+    node->set_condition(hoist(node->get_condition(), loop, invariants));
+    node->set_update(hoist(node->get_update(), loop, invariants));
+    node->set_body(hoist(node->get_body(), loop, invariants));
+    for (HoistedExpressionSyntax* invariant : invariants)
+        node->add_invariant(invariant);
+}
+
+void LoopInvariants::hoist_while(WhileExpressionSyntax* node)
+{
+    CountedLoops::Effects loop;
+    CountedLoops::scan(node->get_condition(), loop);
+    CountedLoops::scan(node->get_body(), loop);
+    if (loop.has_user_calls) return;
+
+    std::vector<HoistedExpressionSyntax*> invariants;
+    node->set_condition(hoist(node->get_condition(), loop, invariants));
+    node->set_body(hoist(node->get_body(), loop, invariants));
+    for (HoistedExpressionSyntax* invariant : invariants)
+        node->add_invariant(invariant);
+}
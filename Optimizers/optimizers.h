@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../Syntax/Expressions/syntax-expressions.h"
+
+#include <set>
+#include <unordered_map>
+
+namespace Optimizers
+{
+    // Refer to constant-folder.cpp.
+    class ConstantFolder final
+    {
+    private:
+        static bool is_constant(Syntax::SyntaxNode* node);
+        static Objects::Object* get_constant(Syntax::SyntaxNode* node);
+        static bool is_too_large(Syntax::SyntaxKind op_kind, Objects::Object* left, Objects::Object* right);
+        static Syntax::SyntaxNode* replace(Syntax::SyntaxNode* node, Objects::Object* value);
+
+        static Syntax::SyntaxNode* fold_unary(Syntax::UnaryExpressionSyntax* node);
+        static Syntax::SyntaxNode* fold_binary(Syntax::BinaryExpressionSyntax* node);
+        static Syntax::SyntaxNode* fold_index(Syntax::IndexExpressionSyntax* node);
+        static Syntax::SyntaxNode* fold_sequence(Syntax::SequenceExpressionSyntax* node);
+    public:
+        static Syntax::SyntaxNode* fold(Syntax::SyntaxNode* node);
+    };
+
+    // Refer to counted-loops.cpp.
+    class CountedLoops final
+    {
+    public:
+        // LoopInvariants looks at loops the same way. Refer to loop-invariants.cpp.
+        struct Effects
+        {
+            std::set<std::string> reads;
+            std::set<std::string> writes;
+            bool has_user_calls = false;
+            bool has_io = false;
+            bool has_continue = false;
+        };
+
+        static std::vector<Syntax::SyntaxNode*> get_children(Syntax::SyntaxNode* node);
+        static void scan(Syntax::SyntaxNode* node, Effects& effects);
+    private:
+        static bool is_invariant(Syntax::SyntaxNode* limit, const std::string& variable, Effects& body);
+        static bool match_condition(Syntax::SyntaxNode* condition, Syntax::CountedLoop& loop);
+        static bool match_update(Syntax::SyntaxNode* update, Syntax::CountedLoop& loop);
+
+        static void find_for(Syntax::ForExpressionSyntax* node);
+        static void find_while(Syntax::WhileExpressionSyntax* node);
+    public:
+        static void find(Syntax::SyntaxNode* node);
+    };
+
+    // Refer to loop-invariants.cpp.
+    class LoopInvariants final
+    {
+    private:
+        static bool is_invariant(Syntax::SyntaxNode* node, const CountedLoops::Effects& loop);
+        static bool is_worth_hoisting(Syntax::SyntaxNode* node);
+        static Syntax::SyntaxNode* hoist(Syntax::SyntaxNode* node, const CountedLoops::Effects& loop,
+            std::vector<Syntax::HoistedExpressionSyntax*>& invariants);
+
+        static void hoist_for(Syntax::ForExpressionSyntax* node);
+        static void hoist_while(Syntax::WhileExpressionSyntax* node);
+    public:
+        static void find(Syntax::SyntaxNode* node);
+    };
+
+    // Refer to function-inliner.cpp.
+    class FunctionInliner final
+    {
+    private:
+        // The most nodes an inlined expression can have, and the longest unparsed body that's parsed to look.
+        static const int MAX_SIZE = 32;
+        static const size_t MAX_LAZY_LENGTH = 256;
+
+        struct Inlinable
+        {
+            Syntax::FuncDefineExpressionSyntax* function;
+            Syntax::SyntaxNode* expression;
+        };
+        static std::unordered_map<std::string, Inlinable> _functions;
+        static std::unordered_map<std::string, int> _writes;
+
+        static void count_writes(Syntax::SyntaxNode* node);
+        static bool is_small(Syntax::SyntaxNode* node, int& size);
+        static Syntax::SyntaxNode* get_expression(Syntax::FuncDefineExpressionSyntax* node);
+        static Syntax::SyntaxNode* copy(Syntax::SyntaxNode* node, Syntax::FuncDefineExpressionSyntax* function,
+            Syntax::InlinedCallExpressionSyntax* call);
+        static Syntax::SyntaxNode* inline_call(Syntax::FuncCallExpressionSyntax* node);
+    public:
+        static Syntax::SyntaxNode* inline_program(Syntax::SyntaxNode* root);
+        static Syntax::SyntaxNode* inline_calls(Syntax::SyntaxNode* node);
+        static void clear();
+    };
+}
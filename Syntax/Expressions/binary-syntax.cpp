@@ -4,9 +4,12 @@ using namespace Syntax;
 
 using Diagnostics::Position;
 
-// This is for binary operations.
+// This is for binary operations whose operand types aren't known before evaluation.
+// The feedback remembers the operand types the node saw last, so that while they stay the same
+// the evaluator can run the specialized operation instead of going through the objects.
 BinaryExpressionSyntax::BinaryExpressionSyntax(SyntaxNode* left, SyntaxToken op_token, SyntaxNode* right, Position pos)
-    : SyntaxNode(pos), _left(left), _op_token(op_token), _right(right) {}
+    : SyntaxNode(SyntaxKind::BinaryExpression, pos), _left(left), _op_token(op_token), _right(right),
+      _feedback{false, Objects::Type::NONE, Objects::Type::NONE, BoundBinaryOperator::IntAdd, 0, 0} {}
 
 BinaryExpressionSyntax::~BinaryExpressionSyntax()
 {
@@ -14,11 +17,6 @@ BinaryExpressionSyntax::~BinaryExpressionSyntax()
     delete _right;
 }
 
-SyntaxKind BinaryExpressionSyntax::kind() const
-{
-    return SyntaxKind::BinaryExpression;
-}
-
 SyntaxNode* BinaryExpressionSyntax::get_left()
 {
     return _left;
@@ -32,4 +30,19 @@ SyntaxToken* BinaryExpressionSyntax::get_op_token()
 SyntaxNode* BinaryExpressionSyntax::get_right()
 {
     return _right;
+}
+
+BinaryFeedback* BinaryExpressionSyntax::get_feedback()
+{
+    return &_feedback;
+}
+
+void BinaryExpressionSyntax::set_left(SyntaxNode* left)
+{
+    _left = left;
+}
+
+void BinaryExpressionSyntax::set_right(SyntaxNode* right)
+{
+    _right = right;
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "syntax-expressions.h"
+
+using namespace Syntax;
+
+using Diagnostics::Position;
+
+// This is a binary operation whose operand types are known before evaluation. Refer to binder.cpp.
+// The operator token is kept for error messages.
+BoundBinaryExpressionSyntax::BoundBinaryExpressionSyntax(SyntaxNode* left, SyntaxToken op_token, SyntaxNode* right, 
+    BoundBinaryOperator op, Position pos)
+    : SyntaxNode(SyntaxKind::BoundBinaryExpression, pos), _left(left), _op_token(op_token), _right(right), _op(op) {}
+
+BoundBinaryExpressionSyntax::~BoundBinaryExpressionSyntax()
+{
+    delete _left;
+    delete _right;
+}
+
+SyntaxNode* BoundBinaryExpressionSyntax::get_left()
+{
+    return _left;
+}
+
+SyntaxToken* BoundBinaryExpressionSyntax::get_op_token()
+{
+    return &_op_token;
+}
+
+SyntaxNode* BoundBinaryExpressionSyntax::get_right()
+{
+    return _right;
+}
+
+BoundBinaryOperator BoundBinaryExpressionSyntax::get_op() const
+{
+    return _op;
+}
+
+void BoundBinaryExpressionSyntax::set_left(SyntaxNode* left)
+{
+    _left = left;
+}
+
+void BoundBinaryExpressionSyntax::set_right(SyntaxNode* right)
+{
+    _right = right;
+}
\ No newline at end of file
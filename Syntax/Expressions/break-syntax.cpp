@@ -3,11 +3,6 @@
 using namespace Syntax;
 
 // This breaks a loop. Just your standard break keyword.
-BreakExpressionSyntax::BreakExpressionSyntax() {}
+BreakExpressionSyntax::BreakExpressionSyntax() : SyntaxNode(SyntaxKind::BreakExpression) {}
 
-BreakExpressionSyntax::~BreakExpressionSyntax() {}
-
-SyntaxKind BreakExpressionSyntax::kind() const
-{
-    return SyntaxKind::BreakExpression;
-}
\ No newline at end of file
+BreakExpressionSyntax::~BreakExpressionSyntax() {}
\ No newline at end of file
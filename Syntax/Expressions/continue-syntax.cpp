@@ -3,11 +3,6 @@
 using namespace Syntax;
 
 // This continues a loop. Just your standard continue keyword.
-ContinueExpressionSyntax::ContinueExpressionSyntax() {}
+ContinueExpressionSyntax::ContinueExpressionSyntax() : SyntaxNode(SyntaxKind::ContinueExpression) {}
 
-ContinueExpressionSyntax::~ContinueExpressionSyntax() {}
-
-SyntaxKind ContinueExpressionSyntax::kind() const
-{
-    return SyntaxKind::ContinueExpression;
-}
\ No newline at end of file
+ContinueExpressionSyntax::~ContinueExpressionSyntax() {}
\ No newline at end of file
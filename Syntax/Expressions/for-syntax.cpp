@@ -1,10 +1,11 @@
 #include "syntax-expressions.h"
+#include "../../Compilers/compilers.h"
 
 using namespace Syntax;
 
 // This is for for-loops. Just your standard C-style for-loop.
 ForExpressionSyntax::ForExpressionSyntax(SyntaxNode *init, SyntaxNode* condition, SyntaxNode *update, SyntaxNode* body, Diagnostics::Position pos)
-    : SyntaxNode(pos), _init(init), _condition(condition), _update(update), _body(body) {}
+    : SyntaxNode(SyntaxKind::ForExpression, pos), _init(init), _condition(condition), _update(update), _body(body), _counted_loop(nullptr), _heat{0, 0, false, nullptr}, _is_scoped(true) {}
 
 ForExpressionSyntax::~ForExpressionSyntax()
 {
@@ -12,11 +13,8 @@ ForExpressionSyntax::~ForExpressionSyntax()
     delete _condition;
     delete _update;
     delete _body;
-}
-
-SyntaxKind ForExpressionSyntax::kind() const
-{
-    return SyntaxKind::ForExpression;
+    delete _counted_loop;
+    delete _heat.trace;
 }
 
 SyntaxNode* ForExpressionSyntax::get_condition()
@@ -38,3 +36,69 @@ SyntaxNode* ForExpressionSyntax::get_update()
 {
     return _update;
 }
+
+void ForExpressionSyntax::set_init(SyntaxNode* init)
+{
+    _init = init;
+}
+
+void ForExpressionSyntax::set_condition(SyntaxNode* condition)
+{
+    _condition = condition;
+}
+
+void ForExpressionSyntax::set_update(SyntaxNode* update)
+{
+    _update = update;
+}
+
+void ForExpressionSyntax::set_body(SyntaxNode* body)
+{
+    _body = body;
+}
+
+CountedLoop* ForExpressionSyntax::get_counted_loop()
+{
+    return _counted_loop;
+}
+
+void ForExpressionSyntax::set_counted_loop(CountedLoop* counted_loop)
+{
+    delete _counted_loop;
+    _counted_loop = counted_loop;
+}
+
+// How often the loop went around, and its trace once it got hot. Refer to trace-jit.cpp.
+LoopHeat* ForExpressionSyntax::get_heat()
+{
+    return &_heat;
+}
+
+// The expressions that were hoisted out of the loop. The hoisted nodes belong to the tree, not to the loop.
+const std::vector<HoistedExpressionSyntax*>& ForExpressionSyntax::get_invariants()
+{
+    return _invariants;
+}
+
+void ForExpressionSyntax::add_invariant(HoistedExpressionSyntax* invariant)
+{
+    _invariants.push_back(invariant);
+}
+
+// Called when the loop ends, so the next run of it evaluates them again.
+void ForExpressionSyntax::forget_invariants()
+{
+    for (HoistedExpressionSyntax* invariant : _invariants)
+        invariant->forget_value();
+}
+
+// A body that declares nothing doesn't need a context of its own. Refer to binder.cpp.
+bool ForExpressionSyntax::is_scoped() const
+{
+    return _is_scoped;
+}
+
+void ForExpressionSyntax::set_scoped(bool is_scoped)
+{
+    _is_scoped = is_scoped;
+}
\ No newline at end of file
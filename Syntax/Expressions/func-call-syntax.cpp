@@ -1,10 +1,15 @@
 #include "syntax-expressions.h"
+#include "../../Evaluators/builtin-functions.h"
 
 using namespace Syntax;
 using Diagnostics::Position;
 // Calls the function.
+// Builtins are bound here, so the evaluator never has to look them up by name.
+// '_args_write' tells whether evaluating the arguments can change a variable. Until the binder finds out,
+// it assumes they can.
 FuncCallExpressionSyntax::FuncCallExpressionSyntax(SyntaxToken identifier, std::vector<SyntaxNode*>& args, Position pos)
-    : SyntaxNode(pos), _identifier(identifier), _args(args) {}
+    : SyntaxNode(SyntaxKind::FuncCallExpression, pos), _identifier(identifier), _args(args), 
+    _builtin(Evaluators::BuiltInFunctions::get_builtin(identifier.kind())), _args_write(true) {}
 
 FuncCallExpressionSyntax::~FuncCallExpressionSyntax()
 {
@@ -12,11 +17,6 @@ FuncCallExpressionSyntax::~FuncCallExpressionSyntax()
         delete o;
 }
 
-SyntaxKind FuncCallExpressionSyntax::kind() const
-{
-    return SyntaxKind::FuncCallExpression;
-}
-
 SyntaxToken* FuncCallExpressionSyntax::get_identifier()
 {
     return &_identifier;
@@ -35,4 +35,24 @@ SyntaxNode* FuncCallExpressionSyntax::get_arg(int i)
 std::vector<SyntaxNode*> FuncCallExpressionSyntax::get_args()
 {
     return _args;
+}
+
+const Evaluators::BuiltIn* FuncCallExpressionSyntax::get_builtin() const
+{
+    return _builtin;
+}
+
+bool FuncCallExpressionSyntax::args_write() const
+{
+    return _args_write;
+}
+
+void FuncCallExpressionSyntax::set_arg(int i, SyntaxNode* arg)
+{
+    _args[i] = arg;
+}
+
+void FuncCallExpressionSyntax::set_args_write(bool args_write)
+{
+    _args_write = args_write;
 }
\ No newline at end of file
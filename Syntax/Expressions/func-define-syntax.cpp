@@ -5,18 +5,13 @@ using Diagnostics::Position;
 // Defines a function. This behaves more like a python function.
 FuncDefineExpressionSyntax::FuncDefineExpressionSyntax(SyntaxToken identifier, std::vector<SyntaxToken>& arg_names, 
     SyntaxNode* body, Position pos)
-    : SyntaxNode(pos), _identifier(identifier), _arg_names(arg_names), _body(body) {}
+    : SyntaxNode(SyntaxKind::FuncDefineExpression, pos), _identifier(identifier), _arg_names(arg_names), _body(body) {}
 
 FuncDefineExpressionSyntax::~FuncDefineExpressionSyntax()
 {
     delete _body;
 }
 
-SyntaxKind FuncDefineExpressionSyntax::kind() const
-{
-    return SyntaxKind::FuncDefineExpression;
-}
-
 int FuncDefineExpressionSyntax::get_arg_size()
 {
     return _arg_names.size();
@@ -40,4 +35,9 @@ SyntaxToken* FuncDefineExpressionSyntax::get_identifier()
 SyntaxNode* FuncDefineExpressionSyntax::get_body()
 {
     return _body;
+}
+
+void FuncDefineExpressionSyntax::set_body(SyntaxNode* body)
+{
+    _body = body;
 }
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "syntax-expressions.h"
+
+using namespace Syntax;
+
+// An expression that gives the same value on every iteration of its loop. It's evaluated the first time it's
+// reached, and the value is kept until the loop ends. Refer to loop-invariants.cpp.
+HoistedExpressionSyntax::HoistedExpressionSyntax(SyntaxNode* expression)
+    : SyntaxNode(SyntaxKind::HoistedExpression, expression->get_pos()), _expression(expression), _value(nullptr) {}
+
+HoistedExpressionSyntax::~HoistedExpressionSyntax()
+{
+    delete _expression;
+    delete _value;
+}
+
+SyntaxNode* HoistedExpressionSyntax::get_expression()
+{
+    return _expression;
+}
+
+// Returns nullptr until it's evaluated in the current run of the loop.
+Objects::Object* HoistedExpressionSyntax::get_value()
+{
+    return _value;
+}
+
+void HoistedExpressionSyntax::set_value(Objects::Object* value)
+{
+    _value = value;
+}
+
+void HoistedExpressionSyntax::forget_value()
+{
+    delete _value;
+    _value = nullptr;
+}
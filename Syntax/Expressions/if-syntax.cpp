@@ -4,7 +4,8 @@ using namespace Syntax;
 using Diagnostics::Position;
 // This is for conditional statements. Just your standard C-style conditional statements.
 IfExpressionSyntax::IfExpressionSyntax(std::vector<SyntaxNode*>& conditions, std::vector<SyntaxNode*>& bodies, 
-    SyntaxNode* else_body, Position pos) : SyntaxNode(pos), _conditions(conditions), _bodies(bodies), _else_body(else_body) {}
+    SyntaxNode* else_body, Position pos) : SyntaxNode(SyntaxKind::IfExpression, pos), _conditions(conditions), _bodies(bodies), _else_body(else_body), 
+    _scoped(bodies.size(), true), _is_else_scoped(true) {}
 
 IfExpressionSyntax::~IfExpressionSyntax()
 {
@@ -17,11 +18,6 @@ IfExpressionSyntax::~IfExpressionSyntax()
     delete _else_body;
 }
 
-SyntaxKind IfExpressionSyntax::kind() const
-{
-    return SyntaxKind::IfExpression;
-}
-
 SyntaxNode* IfExpressionSyntax::get_condition(int i)
 {
     return _conditions[i];
@@ -50,4 +46,40 @@ std::vector<SyntaxNode*> IfExpressionSyntax::get_conditions()
 std::vector<SyntaxNode*> IfExpressionSyntax::get_bodies()
 {
     return _bodies;
+}
+
+void IfExpressionSyntax::set_condition(int i, SyntaxNode* condition)
+{
+    _conditions[i] = condition;
+}
+
+void IfExpressionSyntax::set_body(int i, SyntaxNode* body)
+{
+    _bodies[i] = body;
+}
+
+void IfExpressionSyntax::set_else_body(SyntaxNode* else_body)
+{
+    _else_body = else_body;
+}
+
+// A body that declares nothing doesn't need a context of its own. Refer to binder.cpp.
+bool IfExpressionSyntax::is_scoped(int i) const
+{
+    return _scoped[i];
+}
+
+void IfExpressionSyntax::set_scoped(int i, bool is_scoped)
+{
+    _scoped[i] = is_scoped;
+}
+
+bool IfExpressionSyntax::is_else_scoped() const
+{
+    return _is_else_scoped;
+}
+
+void IfExpressionSyntax::set_else_scoped(bool is_scoped)
+{
+    _is_else_scoped = is_scoped;
 }
\ No newline at end of file
@@ -4,7 +4,7 @@ using namespace Syntax;
 using Diagnostics::Position;
 // This indexes a string or a list.
 IndexExpressionSyntax::IndexExpressionSyntax(SyntaxNode* to_access, SyntaxNode* indexer, Position pos)
-    : SyntaxNode(pos), _to_access(to_access), _indexer(indexer)  {}
+    : SyntaxNode(SyntaxKind::IndexExpression, pos), _to_access(to_access), _indexer(indexer)  {}
 
 IndexExpressionSyntax::~IndexExpressionSyntax()
 {
@@ -12,11 +12,6 @@ IndexExpressionSyntax::~IndexExpressionSyntax()
     delete _indexer;
 }
 
-SyntaxKind IndexExpressionSyntax::kind() const
-{
-    return SyntaxKind::IndexExpression;
-}
-
 SyntaxNode* IndexExpressionSyntax::get_to_access()
 {
     return _to_access;
@@ -26,3 +21,13 @@ SyntaxNode* IndexExpressionSyntax::get_indexer()
 {
     return _indexer;
 }
+
+void IndexExpressionSyntax::set_to_access(SyntaxNode* to_access)
+{
+    _to_access = to_access;
+}
+
+void IndexExpressionSyntax::set_indexer(SyntaxNode* indexer)
+{
+    _indexer = indexer;
+}
\ No newline at end of file
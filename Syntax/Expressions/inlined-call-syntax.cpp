@@ -0,0 +1,55 @@
+#include "syntax-expressions.h"
+
+using namespace Syntax;
+
+// A call to a small function, with a copy of the function's expression in its place. The call is kept to run
+// instead whenever its name no longer holds that function. Refer to function-inliner.cpp.
+InlinedCallExpressionSyntax::InlinedCallExpressionSyntax(FuncCallExpressionSyntax* call,
+    FuncDefineExpressionSyntax* function)
+    : SyntaxNode(SyntaxKind::InlinedCallExpression, call->get_pos()), _call(call), _function(function),
+    _body(nullptr) {}
+
+InlinedCallExpressionSyntax::~InlinedCallExpressionSyntax()
+{
+    delete _call;
+    delete _body;
+    clear_arguments();
+}
+
+FuncCallExpressionSyntax* InlinedCallExpressionSyntax::get_call()
+{
+    return _call;
+}
+
+FuncDefineExpressionSyntax* InlinedCallExpressionSyntax::get_function()
+{
+    return _function;
+}
+
+SyntaxNode* InlinedCallExpressionSyntax::get_body()
+{
+    return _body;
+}
+
+void InlinedCallExpressionSyntax::set_body(SyntaxNode* body)
+{
+    _body = body;
+}
+
+Objects::Object* InlinedCallExpressionSyntax::get_argument(int i)
+{
+    return _arguments[i];
+}
+
+// Takes over the arguments of the current call. They're deleted by clear_arguments().
+void InlinedCallExpressionSyntax::set_arguments(std::vector<Objects::Object*>& arguments)
+{
+    _arguments.swap(arguments);
+}
+
+void InlinedCallExpressionSyntax::clear_arguments()
+{
+    for (Objects::Object* argument : _arguments)
+        delete argument;
+    _arguments.clear();
+}
@@ -0,0 +1,38 @@
+#include "syntax-expressions.h"
+
+using namespace Syntax;
+using Diagnostics::Position;
+
+// A function body that the parser only pre-parsed. It holds the script up to the end of the body, and the
+// body itself is parsed the first time the function is called. Refer to compile_body in evaluator.cpp.
+int LazyBodyExpressionSyntax::_compiled = 0;
+
+LazyBodyExpressionSyntax::LazyBodyExpressionSyntax(std::string_view text, Position pos)
+    : SyntaxNode(SyntaxKind::LazyBodyExpression, pos), _text(text), _body(nullptr) {}
+
+LazyBodyExpressionSyntax::~LazyBodyExpressionSyntax()
+{
+    delete _body;
+}
+
+std::string_view LazyBodyExpressionSyntax::get_text() const
+{
+    return _text;
+}
+
+SyntaxNode* LazyBodyExpressionSyntax::get_body()
+{
+    return _body;
+}
+
+void LazyBodyExpressionSyntax::set_body(SyntaxNode* body)
+{
+    if (_body == nullptr) _compiled++;
+    _body = body;
+}
+
+// How many bodies have been parsed so far. A streamed run can't cut the arena back past one.
+int LazyBodyExpressionSyntax::get_compiled_count()
+{
+    return _compiled;
+}
@@ -3,11 +3,6 @@
 using namespace Syntax;
 
 // This does nothing.
-NoneExpressionSyntax::NoneExpressionSyntax() {}
+NoneExpressionSyntax::NoneExpressionSyntax() : SyntaxNode(SyntaxKind::NoneExpression) {}
 
-NoneExpressionSyntax::~NoneExpressionSyntax() {}
-
-SyntaxKind NoneExpressionSyntax::kind() const
-{
-    return SyntaxKind::NoneExpression;
-}
\ No newline at end of file
+NoneExpressionSyntax::~NoneExpressionSyntax() {}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#include "syntax-expressions.h"
+
+using namespace Syntax;
+using Diagnostics::Position;
+// A parameter of an inlined function. It reads the argument of the current call instead of a variable.
+ParameterExpressionSyntax::ParameterExpressionSyntax(InlinedCallExpressionSyntax* call, int index,
+    SyntaxToken identifier, Position pos)
+    : SyntaxNode(SyntaxKind::ParameterExpression, pos), _call(call), _index(index), _identifier(identifier) {}
+
+ParameterExpressionSyntax::~ParameterExpressionSyntax() {}
+
+Objects::Object* ParameterExpressionSyntax::get_argument()
+{
+    return _call->get_argument(_index);
+}
+
+SyntaxToken* ParameterExpressionSyntax::get_identifier()
+{
+    return &_identifier;
+}
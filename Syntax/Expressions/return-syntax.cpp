@@ -3,19 +3,19 @@
 using namespace Syntax;
 
 // This returns a value. Just your standard return keyword.
-ReturnExpressionSyntax::ReturnExpressionSyntax(SyntaxNode* to_return) : _to_return(to_return) {}
+ReturnExpressionSyntax::ReturnExpressionSyntax(SyntaxNode* to_return) : SyntaxNode(SyntaxKind::ReturnExpression), _to_return(to_return) {}
 
 ReturnExpressionSyntax::~ReturnExpressionSyntax()
 {
     delete _to_return;
 }
 
-SyntaxKind ReturnExpressionSyntax::kind() const
+SyntaxNode* ReturnExpressionSyntax::get_to_return()
 {
-    return SyntaxKind::ReturnExpression;
+    return _to_return;
 }
 
-SyntaxNode* ReturnExpressionSyntax::get_to_return()
+void ReturnExpressionSyntax::set_to_return(SyntaxNode* to_return)
 {
-    return _to_return;
+    _to_return = to_return;
 }
\ No newline at end of file
@@ -5,7 +5,7 @@ using namespace Syntax;
 // This is for sequences and lists.
 // Retruns a python-style list when '_to_return' is set to true.
 SequenceExpressionSyntax::SequenceExpressionSyntax(std::vector<SyntaxNode*>& nodes, Diagnostics::Position pos, bool to_return)
-    : SyntaxNode(pos), _nodes(nodes), _to_return(to_return) {}
+    : SyntaxNode(SyntaxKind::SequenceExpression, pos), _nodes(nodes), _to_return(to_return) {}
 
 SequenceExpressionSyntax::~SequenceExpressionSyntax()
 {
@@ -13,11 +13,6 @@ SequenceExpressionSyntax::~SequenceExpressionSyntax()
         delete o;
 }
 
-SyntaxKind SequenceExpressionSyntax::kind() const
-{
-    return SyntaxKind::SequenceExpression;
-}
-
 int SequenceExpressionSyntax::get_nodes_size() const
 {
     return _nodes.size();
@@ -36,4 +31,9 @@ std::vector<SyntaxNode*> SequenceExpressionSyntax::get_nodes()
 bool SequenceExpressionSyntax::get_to_return()
 {
     return _to_return;
+}
+
+void SequenceExpressionSyntax::set_node(int i, SyntaxNode* node)
+{
+    _nodes[i] = node;
 }
\ No newline at end of file
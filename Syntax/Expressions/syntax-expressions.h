@@ -1,6 +1,13 @@
 #pragma once
 
 #include "../syntax.h"
+#include <deque>
+
+namespace Evaluators
+{
+    // Refer to builtin-functions.h.
+    struct BuiltIn;
+}
 
 namespace Syntax
 {
@@ -13,7 +20,6 @@ namespace Syntax
         LiteralExpressionSyntax(Objects::Object* value, Diagnostics::Position pos);
         ~LiteralExpressionSyntax();
 
-        SyntaxKind kind() const;
         Objects::Object* get_object();
     };
 
@@ -23,14 +29,16 @@ namespace Syntax
     private:
         SyntaxToken _op_token;
         SyntaxNode* _operand;
+        UnaryFeedback _feedback;
     public:
         UnaryExpressionSyntax(SyntaxToken op_token, SyntaxNode* operand, Diagnostics::Position pos);
         ~UnaryExpressionSyntax();
 
-        SyntaxKind kind() const;
         
         SyntaxToken* get_op_token();
         SyntaxNode* get_operand();
+        UnaryFeedback* get_feedback();
+        void set_operand(SyntaxNode* operand);
     };
 
     // Refer to binary-syntax.cpp.
@@ -40,14 +48,38 @@ namespace Syntax
         SyntaxNode* _left;
         SyntaxToken _op_token;
         SyntaxNode*_right;
+        BinaryFeedback _feedback;
     public:
         BinaryExpressionSyntax(SyntaxNode* left, SyntaxToken op_token, SyntaxNode* right, Diagnostics::Position pos);
         ~BinaryExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxNode* get_left();
         SyntaxToken* get_op_token();
         SyntaxNode* get_right();
+        BinaryFeedback* get_feedback();
+        void set_left(SyntaxNode* left);
+        void set_right(SyntaxNode* right);
+    };
+
+    // Refer to bound-binary-syntax.cpp.
+    class BoundBinaryExpressionSyntax final : public SyntaxNode
+    {
+    private:
+        SyntaxNode* _left;
+        SyntaxToken _op_token;
+        SyntaxNode* _right;
+        BoundBinaryOperator _op;
+    public:
+        BoundBinaryExpressionSyntax(SyntaxNode* left, SyntaxToken op_token, SyntaxNode* right, BoundBinaryOperator op,
+            Diagnostics::Position pos);
+        ~BoundBinaryExpressionSyntax();
+
+        SyntaxNode* get_left();
+        SyntaxToken* get_op_token();
+        SyntaxNode* get_right();
+        BoundBinaryOperator get_op() const;
+        void set_left(SyntaxNode* left);
+        void set_right(SyntaxNode* right);
     };
 
     // Refer to sequence-syntax.cpp.
@@ -59,12 +91,28 @@ namespace Syntax
     public:
         SequenceExpressionSyntax(std::vector<SyntaxNode*>& nodes, Diagnostics::Position pos, bool to_return=false);
         ~SequenceExpressionSyntax();
-        SyntaxKind kind() const;    
 
         int get_nodes_size() const;
         SyntaxNode* get_node(int i);
         std::vector<SyntaxNode*> get_nodes();
         bool get_to_return();
+        void set_node(int i, SyntaxNode* node);
+    };
+
+    // Refer to hoisted-syntax.cpp.
+    class HoistedExpressionSyntax final : public SyntaxNode
+    {
+    private:
+        SyntaxNode* _expression;
+        Objects::Object* _value;
+    public:
+        HoistedExpressionSyntax(SyntaxNode* expression);
+        ~HoistedExpressionSyntax();
+
+        SyntaxNode* get_expression();
+        Objects::Object* get_value();
+        void set_value(Objects::Object* value);
+        void forget_value();
     };
 
     // Refer to while-syntax.cpp.
@@ -73,14 +121,27 @@ namespace Syntax
     private:
         SyntaxNode* _condition;
         SyntaxNode* _body;
+        CountedLoop* _counted_loop;
+        LoopHeat _heat;
+        std::vector<HoistedExpressionSyntax*> _invariants;
+        bool _is_scoped;
     public:
         WhileExpressionSyntax(SyntaxNode* condition, SyntaxNode* body, Diagnostics::Position pos);
         ~WhileExpressionSyntax();
 
-        SyntaxKind kind() const;
 
         SyntaxNode* get_condition();
         SyntaxNode* get_body();
+        void set_condition(SyntaxNode* condition);
+        void set_body(SyntaxNode* body);
+        CountedLoop* get_counted_loop();
+        void set_counted_loop(CountedLoop* counted_loop);
+        LoopHeat* get_heat();
+        const std::vector<HoistedExpressionSyntax*>& get_invariants();
+        void add_invariant(HoistedExpressionSyntax* invariant);
+        void forget_invariants();
+        bool is_scoped() const;
+        void set_scoped(bool is_scoped);
     };
 
     // Refer to for-syntax.cpp.
@@ -88,15 +149,30 @@ namespace Syntax
     {
     private:
         SyntaxNode *_init, *_condition, *_update, *_body;
+        CountedLoop* _counted_loop;
+        LoopHeat _heat;
+        std::vector<HoistedExpressionSyntax*> _invariants;
+        bool _is_scoped;
     public:
         ForExpressionSyntax(SyntaxNode* init, SyntaxNode* condition, SyntaxNode* update, SyntaxNode* body, Diagnostics::Position pos);
         ~ForExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxNode* get_init();     
         SyntaxNode* get_condition();      
         SyntaxNode* get_update();      
         SyntaxNode* get_body();            
+        void set_init(SyntaxNode* init);
+        void set_condition(SyntaxNode* condition);
+        void set_update(SyntaxNode* update);
+        void set_body(SyntaxNode* body);
+        CountedLoop* get_counted_loop();
+        void set_counted_loop(CountedLoop* counted_loop);
+        LoopHeat* get_heat();
+        const std::vector<HoistedExpressionSyntax*>& get_invariants();
+        void add_invariant(HoistedExpressionSyntax* invariant);
+        void forget_invariants();
+        bool is_scoped() const;
+        void set_scoped(bool is_scoped);
     };
 
     // Refer to var-declare-syntax.cpp.
@@ -109,7 +185,6 @@ namespace Syntax
         VarDeclareExpressionSyntax(SyntaxToken var_keyword, SyntaxToken identifier, Diagnostics::Position pos);
         ~VarDeclareExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxToken* get_var_keyword();
         SyntaxToken* get_identifier();
     };
@@ -120,13 +195,16 @@ namespace Syntax
     private:
         SyntaxToken _identifier;
         SyntaxNode* _value;
+        bool _type_checked;
     public:
         VarAssignExpressionSyntax(SyntaxToken identifier, SyntaxNode* value, Diagnostics::Position pos);
         ~VarAssignExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxToken* get_identifier();
         SyntaxNode* get_value();
+        void set_value(SyntaxNode* value);
+        bool is_type_checked() const;
+        void set_type_checked(bool type_checked);
     };
 
     // Refer to var-access-syntax.cpp.
@@ -138,7 +216,6 @@ namespace Syntax
         VarAccessExpressionSyntax(SyntaxToken identifier, Diagnostics::Position pos);
         ~VarAccessExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxToken* get_identifier();
     };
 
@@ -149,12 +226,13 @@ namespace Syntax
         std::vector<SyntaxNode*> _conditions;
         std::vector<SyntaxNode*> _bodies;
         SyntaxNode* _else_body;
+        std::vector<bool> _scoped;
+        bool _is_else_scoped;
     public:
         IfExpressionSyntax(std::vector<SyntaxNode*>& conditions,std::vector<SyntaxNode*>& bodies, SyntaxNode* else_body, 
             Diagnostics::Position pos);
         ~IfExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxNode* get_else_body();
         
         int get_size();
@@ -163,6 +241,14 @@ namespace Syntax
 
         std::vector<SyntaxNode*> get_conditions();
         std::vector<SyntaxNode*> get_bodies();
+
+        void set_condition(int i, SyntaxNode* condition);
+        void set_body(int i, SyntaxNode* body);
+        void set_else_body(SyntaxNode* else_body);
+        bool is_scoped(int i) const;
+        void set_scoped(int i, bool is_scoped);
+        bool is_else_scoped() const;
+        void set_else_scoped(bool is_scoped);
     };
 
     // Refer to func-define-syntax.cpp.
@@ -177,12 +263,12 @@ namespace Syntax
             Diagnostics::Position pos);
         ~FuncDefineExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxToken* get_identifier();
         int get_arg_size();
         SyntaxToken* get_arg_name(int i);
         std::vector<SyntaxToken> get_arg_names();
         SyntaxNode* get_body();
+        void set_body(SyntaxNode* body);
     };
 
     // Refer to func-call-syntax.cpp.
@@ -191,15 +277,20 @@ namespace Syntax
     private:
         SyntaxToken _identifier;
         std::vector<SyntaxNode*> _args;
+        const Evaluators::BuiltIn* _builtin;
+        bool _args_write;
     public:
         FuncCallExpressionSyntax(SyntaxToken identifier, std::vector<SyntaxNode*>& args, Diagnostics::Position pos);
         ~FuncCallExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxToken* get_identifier();
         int get_arg_size();
         SyntaxNode* get_arg(int i);
         std::vector<SyntaxNode*> get_args();
+        const Evaluators::BuiltIn* get_builtin() const;
+        bool args_write() const;
+        void set_arg(int i, SyntaxNode* arg);
+        void set_args_write(bool args_write);
     }; 
 
     // Refer to index-syntax.cpp.
@@ -212,9 +303,10 @@ namespace Syntax
         IndexExpressionSyntax(SyntaxNode* to_access, SyntaxNode* indexer, Diagnostics::Position pos);
         ~IndexExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxNode* get_to_access();
         SyntaxNode* get_indexer();
+        void set_to_access(SyntaxNode* to_access);
+        void set_indexer(SyntaxNode* indexer);
     };
 
     // Refer to return-syntax.cpp.
@@ -226,8 +318,8 @@ namespace Syntax
         ReturnExpressionSyntax(SyntaxNode* to_return);
         ~ReturnExpressionSyntax();
 
-        SyntaxKind kind() const;
         SyntaxNode* get_to_return();
+        void set_to_return(SyntaxNode* to_return);
     };
 
     // Refer to continue-syntax.cpp.
@@ -237,7 +329,6 @@ namespace Syntax
         ContinueExpressionSyntax();
         ~ContinueExpressionSyntax();
 
-        SyntaxKind kind() const;
     };
 
     // Refer to break-syntax.cpp.
@@ -247,7 +338,6 @@ namespace Syntax
         BreakExpressionSyntax();
         ~BreakExpressionSyntax();
 
-        SyntaxKind kind() const;
     };
 
     // Refer to none-syntax.cpp.
@@ -257,20 +347,79 @@ namespace Syntax
         NoneExpressionSyntax();
         ~NoneExpressionSyntax();
 
-        SyntaxKind kind() const;
+    };
+
+    // Refer to lazy-body-syntax.cpp.
+    class LazyBodyExpressionSyntax final : public SyntaxNode
+    {
+    private:
+        static int _compiled;
+
+        std::string_view _text;
+        SyntaxNode* _body;
+    public:
+        LazyBodyExpressionSyntax(std::string_view text, Diagnostics::Position pos);
+        ~LazyBodyExpressionSyntax();
+
+        std::string_view get_text() const;
+        SyntaxNode* get_body();
+        void set_body(SyntaxNode* body);
+
+        static int get_compiled_count();
+    };
+
+    // Refer to inlined-call-syntax.cpp.
+    class InlinedCallExpressionSyntax final : public SyntaxNode
+    {
+    private:
+        FuncCallExpressionSyntax* _call;
+        FuncDefineExpressionSyntax* _function;
+        SyntaxNode* _body;
+        std::vector<Objects::Object*> _arguments;
+    public:
+        InlinedCallExpressionSyntax(FuncCallExpressionSyntax* call, FuncDefineExpressionSyntax* function);
+        ~InlinedCallExpressionSyntax();
+
+        FuncCallExpressionSyntax* get_call();
+        FuncDefineExpressionSyntax* get_function();
+        SyntaxNode* get_body();
+        void set_body(SyntaxNode* body);
+        Objects::Object* get_argument(int i);
+        void set_arguments(std::vector<Objects::Object*>& arguments);
+        void clear_arguments();
+    };
+
+    // Refer to parameter-syntax.cpp.
+    class ParameterExpressionSyntax final : public SyntaxNode
+    {
+    private:
+        InlinedCallExpressionSyntax* _call;
+        int _index;
+        SyntaxToken _identifier;
+    public:
+        ParameterExpressionSyntax(InlinedCallExpressionSyntax* call, int index, SyntaxToken identifier,
+            Diagnostics::Position pos);
+        ~ParameterExpressionSyntax();
+
+        Objects::Object* get_argument();
+        SyntaxToken* get_identifier();
     };
 
     // Refer to parser.cpp.
     class Parser final
     {
     private:
-        std::vector<SyntaxToken> _tokens;
-        int _position;
+        std::string_view _text;
+        Lexer _lexer;
+        std::deque<SyntaxToken> _tokens;
+        int _functions;
+        int _taken_end;
         bool _show_return;
+        bool _is_lazy;
 
-        SyntaxToken peek(int offset) const;
-        SyntaxToken current() const;
-        SyntaxToken look_ahead() const;
+        SyntaxToken peek(int offset);
+        SyntaxToken current();
+        SyntaxToken look_ahead();
         SyntaxToken next_token();
         SyntaxToken match_token(SyntaxKind kind);
 
@@ -278,9 +427,91 @@ namespace Syntax
         SyntaxNode* parse_molecule();
         SyntaxNode* parse_expression(int precedence = 0);
         SyntaxNode* parse_statement();
+        SyntaxNode* parse_function_body();
         SyntaxNode* parse_program(bool sub_program=false);
+
+    public:
+        Parser(std::string_view text, bool show_return, bool is_streaming=false, bool is_lazy=false, int position=0);
+        SyntaxNode* parse();
+        SyntaxNode* parse_body();
+
+        bool is_done();
+        SyntaxNode* parse_next();
+        int get_function_count() const;
+        int get_offset();
+        SyntaxMark mark();
+        void release(const SyntaxMark& mark);
+    };
+
+    // Refer to parallel-parser.cpp.
+    class ParallelParser final
+    {
+    private:
+        struct Chunk
+        {
+            int start;
+            int end;
+            int first;
+            std::vector<SyntaxNode*> statements;
+            std::vector<Diagnostics::Position> positions;
+            std::vector<Diagnostics::Diagnostic> diagnostics;
+            size_t lexed;
+        };
+
+        static const size_t MIN_CHUNK_SIZE = 64*1024;
+
+        std::string_view _text;
+        bool _show_return;
+        bool _is_lazy;
+
+        static size_t skip_trivia(std::string_view text, size_t i);
+        static std::vector<int> find_chunks(std::string_view text, size_t target);
+        static void shift_positions(SyntaxNode* node, int offset);
+        void parse_chunk(Chunk& chunk);
     public:
-        Parser(std::string& text, bool show_return);
+        ParallelParser(std::string_view text, bool show_return, bool is_lazy=false);
         SyntaxNode* parse();
     };
+
+    // Refer to syntax-cache.cpp.
+    class SyntaxCache final
+    {
+    private:
+        static const unsigned int MAGIC = 0x5443434B;
+        static const unsigned int VERSION = 3;
+        static const unsigned int NO_NODE = ~0u;
+
+        std::string_view _script;
+        unsigned long long _hash;
+        std::string _path;
+
+        std::string _out;
+        unsigned int _node_count;
+        bool _is_complete;
+        std::vector<std::string> _strings;
+        std::unordered_map<std::string, unsigned int> _string_ids;
+
+        const char* _at;
+        const char* _end;
+        std::vector<std::string_view> _texts;
+        std::vector<SyntaxNode*> _built;
+        std::vector<bool> _owned;
+
+        static unsigned long long hash(std::string_view text);
+
+        template <typename T> void put(T value);
+        unsigned int put_string(const std::string& text);
+        void put_token(SyntaxToken* token);
+        unsigned int put_node(SyntaxNode* node);
+
+        template <typename T> bool get(T& value);
+        bool get_string(std::string_view& text);
+        bool get_node();
+        SyntaxNode* read();
+    public:
+        SyntaxCache(const std::string& filename, std::string_view script);
+
+        SyntaxNode* load();
+        void store(SyntaxNode* root);
+    };
 }
\ No newline at end of file
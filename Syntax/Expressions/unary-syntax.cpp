@@ -4,20 +4,16 @@ using namespace Syntax;
 
 using Diagnostics::Position;
 
-// This is for unary operations.
+// This is for unary operations. Refer to binary-syntax.cpp for the feedback.
 UnaryExpressionSyntax::UnaryExpressionSyntax(SyntaxToken op_token, SyntaxNode* operand, Position pos)
-    : SyntaxNode(pos), _op_token(op_token), _operand(operand) {}
+    : SyntaxNode(SyntaxKind::UnaryExpression, pos), _op_token(op_token), _operand(operand),
+      _feedback{false, Objects::Type::NONE, BoundUnaryOperator::IntNegate, 0, 0} {}
     
 UnaryExpressionSyntax::~UnaryExpressionSyntax()
 {
     delete _operand;
 }
 
-SyntaxKind UnaryExpressionSyntax::kind() const
-{
-    return SyntaxKind::UnaryExpression;
-}
-
 SyntaxToken* UnaryExpressionSyntax::get_op_token()
 {
     return &_op_token;
@@ -26,4 +22,14 @@ SyntaxToken* UnaryExpressionSyntax::get_op_token()
 SyntaxNode* UnaryExpressionSyntax::get_operand()
 {
     return _operand;
+}
+
+UnaryFeedback* UnaryExpressionSyntax::get_feedback()
+{
+    return &_feedback;
+}
+
+void UnaryExpressionSyntax::set_operand(SyntaxNode* operand)
+{
+    _operand = operand;
 }
\ No newline at end of file
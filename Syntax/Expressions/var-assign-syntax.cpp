@@ -4,18 +4,13 @@ using namespace Syntax;
 using Diagnostics::Position;
 // Assigns a value to an existing variable.
 VarAssignExpressionSyntax::VarAssignExpressionSyntax(SyntaxToken identifier, SyntaxNode* value, Position pos)
-    : SyntaxNode(pos), _identifier(identifier), _value(value) {}
+    : SyntaxNode(SyntaxKind::VarAssignExpression, pos), _identifier(identifier), _value(value), _type_checked(false) {}
 
 VarAssignExpressionSyntax::~VarAssignExpressionSyntax()
 {
     delete _value;
 }
 
-SyntaxKind VarAssignExpressionSyntax::kind() const
-{
-    return SyntaxKind::VarAssignExpression;
-}
-
 SyntaxNode* VarAssignExpressionSyntax::get_value()
 {
     return _value;
@@ -24,4 +19,20 @@ SyntaxNode* VarAssignExpressionSyntax::get_value()
 SyntaxToken* VarAssignExpressionSyntax::get_identifier()
 {
     return &_identifier;
+}
+
+void VarAssignExpressionSyntax::set_value(SyntaxNode* value)
+{
+    _value = value;
+}
+
+// Set by the binder when the value is known to have the type of the variable.
+bool VarAssignExpressionSyntax::is_type_checked() const
+{
+    return _type_checked;
+}
+
+void VarAssignExpressionSyntax::set_type_checked(bool type_checked)
+{
+    _type_checked = type_checked;
 }
\ No newline at end of file
@@ -1,20 +1,18 @@
 #include "syntax-expressions.h"
+#include "../../Compilers/compilers.h"
 
 using namespace Syntax;
 
 // This is for while-loops. Just your standard while loop.
 WhileExpressionSyntax::WhileExpressionSyntax(SyntaxNode *condition, SyntaxNode* body, Diagnostics::Position pos)
-    : SyntaxNode(pos), _condition(condition), _body(body) {}
+    : SyntaxNode(SyntaxKind::WhileExpression, pos), _condition(condition), _body(body), _counted_loop(nullptr), _heat{0, 0, false, nullptr}, _is_scoped(true) {}
     
 WhileExpressionSyntax::~WhileExpressionSyntax()
 {
     delete _condition;
     delete _body;
-}
-
-SyntaxKind WhileExpressionSyntax::kind() const
-{
-    return SyntaxKind::WhileExpression;
+    delete _counted_loop;
+    delete _heat.trace;
 }
 
 SyntaxNode* WhileExpressionSyntax::get_condition()
@@ -26,3 +24,59 @@ SyntaxNode* WhileExpressionSyntax::get_body()
 {
     return _body;
 }
+
+void WhileExpressionSyntax::set_condition(SyntaxNode* condition)
+{
+    _condition = condition;
+}
+
+void WhileExpressionSyntax::set_body(SyntaxNode* body)
+{
+    _body = body;
+}
+
+CountedLoop* WhileExpressionSyntax::get_counted_loop()
+{
+    return _counted_loop;
+}
+
+void WhileExpressionSyntax::set_counted_loop(CountedLoop* counted_loop)
+{
+    delete _counted_loop;
+    _counted_loop = counted_loop;
+}
+
+// How often the loop went around, and its trace once it got hot. Refer to trace-jit.cpp.
+LoopHeat* WhileExpressionSyntax::get_heat()
+{
+    return &_heat;
+}
+
+// The expressions that were hoisted out of the loop. The hoisted nodes belong to the tree, not to the loop.
+const std::vector<HoistedExpressionSyntax*>& WhileExpressionSyntax::get_invariants()
+{
+    return _invariants;
+}
+
+void WhileExpressionSyntax::add_invariant(HoistedExpressionSyntax* invariant)
+{
+    _invariants.push_back(invariant);
+}
+
+// Called when the loop ends, so the next run of it evaluates them again.
+void WhileExpressionSyntax::forget_invariants()
+{
+    for (HoistedExpressionSyntax* invariant : _invariants)
+        invariant->forget_value();
+}
+
+// A body that declares nothing doesn't need a context of its own. Refer to binder.cpp.
+bool WhileExpressionSyntax::is_scoped() const
+{
+    return _is_scoped;
+}
+
+void WhileExpressionSyntax::set_scoped(bool is_scoped)
+{
+    _is_scoped = is_scoped;
+}
\ No newline at end of file
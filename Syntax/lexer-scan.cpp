@@ -0,0 +1,97 @@
+#include "syntax.h"
+#include <cctype>
+
+#if defined(__GNUC__) && (defined(__AVX2__) || defined(__SSE2__))
+#include <immintrin.h>
+#define LEXER_SCAN_BLOCKS
+#endif
+
+using namespace Syntax;
+
+// These find the end of a run of characters for the lexer. Where the compiler targets SSE2 or AVX2,
+// the text is checked 16 or 32 characters at a time, and whatever is left at the end is checked one
+// character at a time. Each of them returns the position of the first character that ends the run,
+// or the size of the text if the run goes to the end.
+#ifdef LEXER_SCAN_BLOCKS
+#ifdef __AVX2__
+typedef __m256i Block;
+static const int BLOCK_SIZE = 32;
+static inline Block load(const char* p) { return _mm256_loadu_si256((const Block*)p); }
+static inline Block splat(char c) { return _mm256_set1_epi8(c); }
+static inline Block equals(Block a, Block b) { return _mm256_cmpeq_epi8(a, b); }
+static inline Block greater(Block a, Block b) { return _mm256_cmpgt_epi8(a, b); }
+static inline Block both(Block a, Block b) { return _mm256_and_si256(a, b); }
+static inline Block either(Block a, Block b) { return _mm256_or_si256(a, b); }
+static inline unsigned int to_mask(Block a) { return (unsigned int)_mm256_movemask_epi8(a); }
+#else
+typedef __m128i Block;
+static const int BLOCK_SIZE = 16;
+static inline Block load(const char* p) { return _mm_loadu_si128((const Block*)p); }
+static inline Block splat(char c) { return _mm_set1_epi8(c); }
+static inline Block equals(Block a, Block b) { return _mm_cmpeq_epi8(a, b); }
+static inline Block greater(Block a, Block b) { return _mm_cmpgt_epi8(a, b); }
+static inline Block both(Block a, Block b) { return _mm_and_si128(a, b); }
+static inline Block either(Block a, Block b) { return _mm_or_si128(a, b); }
+static inline unsigned int to_mask(Block a) { return (unsigned int)_mm_movemask_epi8(a); }
+#endif
+
+static const unsigned int FULL_MASK = BLOCK_SIZE == 32 ? 0xFFFFFFFFu : 0xFFFFu;
+
+// Characters are compared as signed bytes, so anything past ASCII is never in a range.
+static inline Block in_range(Block v, char low, char high)
+{
+    return both(greater(v, splat(low-1)), greater(splat(high+1), v));
+}
+#endif
+
+// The same characters as std::isspace.
+int Lexer::scan_whitespace(int from) const
+{
+    int i = from;
+    int size = _text.size();
+#ifdef LEXER_SCAN_BLOCKS
+    for (; i+BLOCK_SIZE <= size; i += BLOCK_SIZE)
+    {
+        Block v = load(_text.data()+i);
+        unsigned int mask = to_mask(either(equals(v, splat(' ')), in_range(v, '\t', '\r')));
+        if (mask != FULL_MASK) return i + __builtin_ctz(~mask);
+    }
+#endif
+    while (i < size && std::isspace(_text[i])) i++;
+    return i;
+}
+
+// The same characters as is_valid_identifier.
+int Lexer::scan_identifier(int from) const
+{
+    int i = from;
+    int size = _text.size();
+#ifdef LEXER_SCAN_BLOCKS
+    for (; i+BLOCK_SIZE <= size; i += BLOCK_SIZE)
+    {
+        Block v = load(_text.data()+i);
+        Block letters = in_range(either(v, splat(0x20)), 'a', 'z');
+        Block digits = in_range(v, '0', '9');
+        unsigned int mask = to_mask(either(either(letters, digits), equals(v, splat('_'))));
+        if (mask != FULL_MASK) return i + __builtin_ctz(~mask);
+    }
+#endif
+    while (i < size && is_valid_identifier(_text[i])) i++;
+    return i;
+}
+
+// Used for the ends of comments and strings.
+int Lexer::find_char(int from, char c) const
+{
+    int i = from;
+    int size = _text.size();
+#ifdef LEXER_SCAN_BLOCKS
+    for (; i+BLOCK_SIZE <= size; i += BLOCK_SIZE)
+    {
+        unsigned int mask = to_mask(equals(load(_text.data()+i), splat(c)));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+#endif
+    while (i < size && _text[i] != c) i++;
+    return i;
+}
@@ -1,12 +1,15 @@
 #include "syntax.h"
+#include <charconv>
 #include <iostream>
 
 using namespace Syntax;
 using namespace Objects;
 using namespace Diagnostics;
 
-// This tokenizes the input.
-Lexer::Lexer(const std::string& text) : _text(text), _position(0), _ln(0), _col(0) {}
+// This tokenizes the input. The lexer only looks at the text it's given, and the tokens it makes get their
+// text through the interned strings, so the input is never copied. It can start partway into the text,
+// so the positions of a function body parsed later still point into the whole script.
+Lexer::Lexer(std::string_view text, int position) : _text(text), _position(position) {}
 
 char Lexer::peek(int offset) const
 {
@@ -25,38 +28,55 @@ char Lexer::look_ahead() const
     return peek(1);
 }
 
+// Lines and columns aren't tracked here. Refer to diagnostic-bag.cpp.
 void Lexer::next()
 {
-    _col++;
-    if (current() == '\n')
+    _position++;
+}
+
+// Whitespace and comments never reach the parser, so they are skipped without being made into tokens.
+// The runs are scanned a block at a time. Refer to lexer-scan.cpp.
+void Lexer::skip_trivia()
+{
+    while (true)
     {
-        _ln++;
-        _col = 0;
+        if (std::isspace(current()))
+            _position = scan_whitespace(_position);
+        else if (current() == '/' && look_ahead() == '/')
+            _position = find_char(_position+2, '\n');
+        else if (current() == '/' && look_ahead() == '*')
+        {
+            int size = _text.size();
+            int end = find_char(_position+2, '*');
+            while (end+1 < size && _text[end+1] != '/')
+                end = find_char(end+1, '*');
+            _position = end+1 < size ? end+2 : size;
+        }
+        else
+            return;
     }
-    _position++;
 }
 
 SyntaxToken Lexer::lex()
 {
+    skip_trivia();
+
     int start = _position;
-    int start_ln = _ln;
-    int start_col = _col;
 
     // Inserts an end of file token at the end.
     if (_position >= (int)_text.size())
-        return SyntaxToken(SyntaxKind::EndOfFileToken, Position(_ln, _col, start, start+1), "\0");
+        return SyntaxToken(SyntaxKind::EndOfFileToken, Position(start, start+1), "\0");
     
     
 
     if (is_letter(current()))
     {
-        while(is_valid_identifier(current()))
-            next();
+        _position = scan_identifier(_position+1);
         
         int length = _position-start;
-        std::string text = _text.substr(start, length);
+        std::string_view text = _text.substr(start, length);
         SyntaxKind kind = SyntaxFacts::get_keyword_kind(text);
-        return SyntaxToken(kind, Position(start_ln, start_col, start, _position), text);
+        return SyntaxToken(kind, Position(start, _position), text);
     }
 
     if (is_digit(current()))
@@ -72,133 +92,94 @@ SyntaxToken Lexer::lex()
         }
 
         int length = _position-start;
-        std::string text = _text.substr(start, length);
-        Position curr_pos = Position(start_ln, start_col, start, _position);
+        std::string_view text = _text.substr(start, length);
+        Position curr_pos = Position(start, _position);
         if (dot_count == 0)
         {
             long long x;
-            std::istringstream is(text);
-            if (is >> x)
+            if (std::from_chars(text.data(), text.data()+text.size(), x).ec == std::errc())
                 return SyntaxToken(SyntaxKind::IntegerToken, curr_pos, text);
 
-            Diagnostics::DiagnosticBag::report_invalid_type(text, type_to_string(Type::INTEGER), curr_pos);
+            Diagnostics::DiagnosticBag::report_invalid_type(std::string(text), type_to_string(Type::INTEGER), curr_pos);
             return SyntaxToken(SyntaxKind::IntegerToken, curr_pos, text);            
         }
         else
         {
             long double x;
-            std::istringstream is(text);
-            if (is >> x)
+            if (std::from_chars(text.data(), text.data()+text.size(), x).ec == std::errc())
                 return SyntaxToken(SyntaxKind::DoubleToken, curr_pos, text);
     
-            Diagnostics::DiagnosticBag::report_invalid_type(text, type_to_string(Type::DOUBLE), curr_pos);
+            Diagnostics::DiagnosticBag::report_invalid_type(std::string(text), type_to_string(Type::DOUBLE), curr_pos);
             return SyntaxToken(SyntaxKind::DoubleToken, curr_pos, text);    
         }
     }
 
-    if (std::isspace(current()))
-    {
-        while(std::isspace(current()))
-            next();
-
-        int length = _position-start;
-        std::string text = _text.substr(start, length);
-        return SyntaxToken(SyntaxKind::WhitespaceToken, Position(start_ln, start_col, start, _position), text);
-    }
-
     switch(current())
     {
         case '+':
             next();
-            return SyntaxToken(SyntaxKind::PlusToken, Position(start_ln, start_col, start, _position), "+");
+            return SyntaxToken(SyntaxKind::PlusToken, Position(start, _position), "+");
         case '-':
             next();
-            return SyntaxToken(SyntaxKind::MinusToken, Position(start_ln, start_col, start, _position), "-");
+            return SyntaxToken(SyntaxKind::MinusToken, Position(start, _position), "-");
         case '*':
             next();
-            return SyntaxToken(SyntaxKind::StarToken, Position(start_ln, start_col, start, _position), "*");
+            return SyntaxToken(SyntaxKind::StarToken, Position(start, _position), "*");
         case '/':
-            if (look_ahead() == '/')
-            {
-                while(current() && current() != '\n')
-                    next();
-                
-                int length = _position-start;
-                std::string text = _text.substr(start, length);
-                return SyntaxToken(SyntaxKind::CommentToken, Position(start_ln, start_col, start, _position), text);
-            }
-            else if (look_ahead() == '*')
-            {
-                next(); next();
-                while(true)
-                {
-                    if (current() == '*' && look_ahead() == '/')
-                    {
-                        next(); next();
-                        break;
-                    }
-                    if (!current())
-                        break;
-                    next();
-                }
-                int length = _position-start;
-                std::string text = _text.substr(start, length);
-                return SyntaxToken(SyntaxKind::CommentToken, Position(start_ln, start_col, start, _position), text);
-            }
             next();
-            return SyntaxToken(SyntaxKind::SlashToken, Position(start_ln, start_col, start, _position), "/");
+            return SyntaxToken(SyntaxKind::SlashToken, Position(start, _position), "/");
         case '%':
             next();
-            return SyntaxToken(SyntaxKind::ModuloToken, Position(start_ln, start_col, start, _position), "%");
+            return SyntaxToken(SyntaxKind::ModuloToken, Position(start, _position), "%");
         case '^':
             next();
-            return SyntaxToken(SyntaxKind::PowerToken, Position(start_ln, start_col, start, _position), "^");
+            return SyntaxToken(SyntaxKind::PowerToken, Position(start, _position), "^");
         case '=':
         {
             if (look_ahead() == '=') 
             {
                 next(); next();
-                return SyntaxToken(SyntaxKind::DEqualsToken, Position(start_ln, start_col, start, _position), "==");
+                return SyntaxToken(SyntaxKind::DEqualsToken, Position(start, _position), "==");
             }
             next();
-            return SyntaxToken(SyntaxKind::EqualsToken, Position(start_ln, start_col, start, _position), "=");
+            return SyntaxToken(SyntaxKind::EqualsToken, Position(start, _position), "=");
         }
         case '!':
         {
             if (look_ahead() == '=') 
             {
                 next(); next();
-                return SyntaxToken(SyntaxKind::BangEqualsToken, Position(start_ln, start_col, start, _position), "!=");
+                return SyntaxToken(SyntaxKind::BangEqualsToken, Position(start, _position), "!=");
             }
             next();
-            return SyntaxToken(SyntaxKind::BangToken, Position(start_ln, start_col, start, _position), "!");
+            return SyntaxToken(SyntaxKind::BangToken, Position(start, _position), "!");
         }
         case '<':
         {
             if (look_ahead() == '=') 
             {
                 next(); next();
-                return SyntaxToken(SyntaxKind::LessEqualsToken, Position(start_ln, start_col, start, _position), "<=");
+                return SyntaxToken(SyntaxKind::LessEqualsToken, Position(start, _position), "<=");
             }
             next();
-            return SyntaxToken(SyntaxKind::LessThanToken, Position(start_ln, start_col, start, _position), "<");
+            return SyntaxToken(SyntaxKind::LessThanToken, Position(start, _position), "<");
         }
         case '>':
         {
             if (look_ahead() == '=') 
             {
                 next(); next();
-                return SyntaxToken(SyntaxKind::GreaterEqualsToken, Position(start_ln, start_col, start, _position), ">=");              
+                return SyntaxToken(SyntaxKind::GreaterEqualsToken, Position(start, _position), ">=");              
             }
             next();
-            return SyntaxToken(SyntaxKind::GreaterThanToken, Position(start_ln, start_col, start, _position), ">");
+            return SyntaxToken(SyntaxKind::GreaterThanToken, Position(start, _position), ">");
         }
         case '&':
         {
             if (look_ahead() == '&') 
             {
                 next(); next();
-                return SyntaxToken(SyntaxKind::DAmpersandToken, Position(start_ln, start_col, start, _position), "&&");  
+                return SyntaxToken(SyntaxKind::DAmpersandToken, Position(start, _position), "&&");  
             }
             break;           
         }
@@ -207,43 +188,41 @@ SyntaxToken Lexer::lex()
             if (look_ahead() == '|') 
             {
                 next(); next();
-                return SyntaxToken(SyntaxKind::DPipeToken, Position(start_ln, start_col, start, _position), "||");
+                return SyntaxToken(SyntaxKind::DPipeToken, Position(start, _position), "||");
             }
             break;           
         }
         case '(':
             next();
-            return SyntaxToken(SyntaxKind::LParenToken, Position(start_ln, start_col, start, _position), "(");
+            return SyntaxToken(SyntaxKind::LParenToken, Position(start, _position), "(");
         case ')':
             next();
-            return SyntaxToken(SyntaxKind::RParenToken, Position(start_ln, start_col, start, _position), ")");
+            return SyntaxToken(SyntaxKind::RParenToken, Position(start, _position), ")");
         case '[':
             next();
-            return SyntaxToken(SyntaxKind::LSquareToken, Position(start_ln, start_col, start, _position), "[");
+            return SyntaxToken(SyntaxKind::LSquareToken, Position(start, _position), "[");
         case ']':
             next();
-            return SyntaxToken(SyntaxKind::RSquareToken, Position(start_ln, start_col, start, _position), "]");
+            return SyntaxToken(SyntaxKind::RSquareToken, Position(start, _position), "]");
         case '{':
             next();
-            return SyntaxToken(SyntaxKind::LCurlyToken, Position(start_ln, start_col, start, _position), "{");
+            return SyntaxToken(SyntaxKind::LCurlyToken, Position(start, _position), "{");
         case '}':  
             next();
-            return SyntaxToken(SyntaxKind::RCurlyToken, Position(start_ln, start_col, start, _position), "}");
+            return SyntaxToken(SyntaxKind::RCurlyToken, Position(start, _position), "}");
         case ',':
             next();
-            return SyntaxToken(SyntaxKind::CommaToken, Position(start_ln, start_col, start, _position), ",");
+            return SyntaxToken(SyntaxKind::CommaToken, Position(start, _position), ",");
         case ';':
             next();
-            return SyntaxToken(SyntaxKind::SemicolonToken, Position(start_ln, start_col, start, _position), ";");
+            return SyntaxToken(SyntaxKind::SemicolonToken, Position(start, _position), ";");
         case '"':
         {
-            next();
-            while(current() && current() != '"')
-                next();
+            _position = find_char(_position+1, '"');
             
             int length = _position-start;
-            std::string text = _text.substr(start+1, length-1);
-            Position curr_pos = Position(start_ln, start_col, start, _position);
+            std::string_view text = _text.substr(start+1, length-1);
+            Position curr_pos = Position(start, _position);
             if (current() != '"')
             {
                 Diagnostics::DiagnosticBag::report_expected_character('"', curr_pos);
@@ -256,9 +235,9 @@ SyntaxToken Lexer::lex()
     }
 
     // Report and return a bad character.
-    std::string text = _text.substr(start, 1);
+    std::string_view text = _text.substr(start, 1);
     next();
-    Position curr_pos = Position(start_ln, start_col, start, _position);
+    Position curr_pos = Position(start, _position);
     Diagnostics::DiagnosticBag::report_bad_character(current(), curr_pos);
 
     return SyntaxToken(SyntaxKind::BadToken, curr_pos, text);
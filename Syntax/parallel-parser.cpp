@@ -0,0 +1,269 @@
+#include "Expressions/syntax-expressions.h"
+#include <atomic>
+#include <thread>
+
+using namespace Syntax;
+using namespace Diagnostics;
+
+// This parses a large script on several threads. A quick scan over the raw text finds where top-level
+// statements end, the script is cut there into chunks, and each chunk is lexed and parsed on its own.
+// The statements are put back together in order afterwards, so the tree is the same one the parser makes.
+// Anything the scan isn't sure about, like an unclosed bracket or string, makes it parse the script in one go.
+// A script with errors can get them reported a bit differently around where it was cut.
+ParallelParser::ParallelParser(std::string_view text, bool show_return, bool is_lazy)
+    : _text(text), _show_return(show_return), _is_lazy(is_lazy) {}
+
+// Skips whitespace and comments the same way the lexer does.
+size_t ParallelParser::skip_trivia(std::string_view text, size_t i)
+{
+    size_t size = text.size();
+    while (i < size)
+    {
+        if (std::isspace(text[i]))
+            i++;
+        else if (text[i] == '/' && i+1 < size && text[i+1] == '/')
+        {
+            i = text.find('\n', i+2);
+            if (i == std::string_view::npos) return size;
+        }
+        else if (text[i] == '/' && i+1 < size && text[i+1] == '*')
+        {
+            i = text.find("*/", i+2);
+            if (i == std::string_view::npos) return size;
+            i += 2;
+        }
+        else
+            return i;
+    }
+    return size;
+}
+
+// Where each chunk starts. A top-level statement ends after a ';' or a '}' outside of any brackets, unless
+// an 'elif' or an 'else' comes after it. A chunk is cut at the first statement to end once it's at least the
+// target size, and it starts at the token after it so the chunks don't share any text.
+// Returns nothing when the brackets don't match up.
+std::vector<int> ParallelParser::find_chunks(std::string_view text, size_t target)
+{
+    std::vector<int> starts = {0};
+    size_t size = text.size();
+    size_t i = 0;
+    int depth = 0;
+    while (i < size)
+    {
+        char c = text[i];
+        if (c == '"')
+        {
+            i = text.find('"', i+1);
+            if (i == std::string_view::npos) return {};
+            i++;
+            continue;
+        }
+        if (c == '/' && (i+1 < size && (text[i+1] == '/' || text[i+1] == '*')))
+        {
+            i = skip_trivia(text, i);
+            continue;
+        }
+
+        if (c == '(' || c == '[' || c == '{')
+            depth++;
+        else if (c == ')' || c == ']' || c == '}')
+            depth--;
+        if (depth < 0) return {};
+        i++;
+
+        if (depth != 0 || (c != ';' && c != '}') || i - starts.back() < target) continue;
+
+        size_t next = skip_trivia(text, i);
+        if (next >= size) break;
+        size_t end = next;
+        if (is_letter(text[next]))
+            while (end < size && is_valid_identifier(text[end])) end++;
+        SyntaxKind kind = SyntaxFacts::get_keyword_kind(text.substr(next, end-next));
+        if (kind != SyntaxKind::ElifKeyword && kind != SyntaxKind::ElseKeyword)
+            starts.push_back(next);
+    }
+
+    if (depth != 0) return {};
+    return starts;
+}
+
+// The positions of a chunk are added to the end of the shared table, so every node and token in it
+// moves up by where the chunk's table starts in it.
+void ParallelParser::shift_positions(SyntaxNode* node, int offset)
+{
+    if (node == nullptr) return;
+    node->shift_position(offset);
+
+    switch (node->kind())
+    {
+        case SyntaxKind::UnaryExpression:
+        {
+            UnaryExpressionSyntax* t = (UnaryExpressionSyntax*)node;
+            t->get_op_token()->shift_position(offset);
+            shift_positions(t->get_operand(), offset);
+            break;
+        }
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            t->get_op_token()->shift_position(offset);
+            shift_positions(t->get_left(), offset);
+            shift_positions(t->get_right(), offset);
+            break;
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            shift_positions(t->get_to_access(), offset);
+            shift_positions(t->get_indexer(), offset);
+            break;
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+                shift_positions(t->get_node(i), offset);
+            break;
+        }
+        case SyntaxKind::VarDeclareExpression:
+        {
+            VarDeclareExpressionSyntax* t = (VarDeclareExpressionSyntax*)node;
+            t->get_var_keyword()->shift_position(offset);
+            t->get_identifier()->shift_position(offset);
+            break;
+        }
+        case SyntaxKind::VarAssignExpression:
+        {
+            VarAssignExpressionSyntax* t = (VarAssignExpressionSyntax*)node;
+            t->get_identifier()->shift_position(offset);
+            shift_positions(t->get_value(), offset);
+            break;
+        }
+        case SyntaxKind::VarAccessExpression:
+            ((VarAccessExpressionSyntax*)node)->get_identifier()->shift_position(offset);
+            break;
+        case SyntaxKind::WhileExpression:
+        {
+            WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            shift_positions(t->get_condition(), offset);
+            shift_positions(t->get_body(), offset);
+            break;
+        }
+        case SyntaxKind::ForExpression:
+        {
+            ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            shift_positions(t->get_init(), offset);
+            shift_positions(t->get_condition(), offset);
+            shift_positions(t->get_update(), offset);
+            shift_positions(t->get_body(), offset);
+            break;
+        }
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            int n = t->get_size();
+            for (int i = 0; i < n; i++)
+            {
+                shift_positions(t->get_condition(i), offset);
+                shift_positions(t->get_body(i), offset);
+            }
+            shift_positions(t->get_else_body(), offset);
+            break;
+        }
+        case SyntaxKind::FuncDefineExpression:
+        {
+            FuncDefineExpressionSyntax* t = (FuncDefineExpressionSyntax*)node;
+            t->get_identifier()->shift_position(offset);
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                t->get_arg_name(i)->shift_position(offset);
+            shift_positions(t->get_body(), offset);
+            break;
+        }
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            t->get_identifier()->shift_position(offset);
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                shift_positions(t->get_arg(i), offset);
+            break;
+        }
+        case SyntaxKind::ReturnExpression:
+            shift_positions(((ReturnExpressionSyntax*)node)->get_to_return(), offset);
+            break;
+        default:
+            break;
+    }
+}
+
+// Runs on a thread of the pool. The positions and the diagnostics of the chunk are kept on the side until
+// every chunk is done. The whole chunk is lexed first, so its lexer diagnostics all come before the parser's.
+void ParallelParser::parse_chunk(Chunk& chunk)
+{
+    SyntaxNode::set_position_table(&chunk.positions);
+    DiagnosticBag::collect_into(&chunk.diagnostics);
+    {
+        Parser parser(_text.substr(0, chunk.end), _show_return, false, _is_lazy, chunk.start);
+        chunk.lexed = chunk.diagnostics.size();
+        chunk.first = parser.get_offset();
+        while (!parser.is_done())
+            chunk.statements.push_back(parser.parse_next());
+    }
+    SyntaxNode::set_position_table(nullptr);
+    DiagnosticBag::collect_into(nullptr);
+}
+
+// Scripts too small to be cut into a few chunks, or machines with one core, are parsed in one go.
+SyntaxNode* ParallelParser::parse()
+{
+    unsigned int threads = std::thread::hardware_concurrency();
+    size_t target = _text.size()/(threads*4+1);
+    if (target < MIN_CHUNK_SIZE) target = MIN_CHUNK_SIZE;
+    std::vector<int> starts;
+    if (threads > 1)
+        starts = find_chunks(_text, target);
+    if (starts.size() < 2)
+        return Parser(_text, _show_return, false, _is_lazy).parse();
+
+    std::vector<Chunk> chunks(starts.size());
+    for (size_t i = 0; i < chunks.size(); i++)
+    {
+        chunks[i].start = starts[i];
+        chunks[i].end = i+1 < starts.size() ? starts[i+1] : _text.size();
+    }
+
+    // Each thread takes the next chunk nobody has taken yet, and this one works along with them.
+    std::atomic<size_t> next_chunk(0);
+    auto work = [&]()
+    {
+        for (size_t i = next_chunk++; i < chunks.size(); i = next_chunk++)
+            parse_chunk(chunks[i]);
+    };
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads && i < chunks.size(); i++)
+        pool.emplace_back(work);
+    work();
+    for (std::thread& thread : pool)
+        thread.join();
+
+    std::vector<SyntaxNode*> program_seq;
+    for (Chunk& chunk : chunks)
+    {
+        int offset = SyntaxNode::add_positions(chunk.positions);
+        for (SyntaxNode* statement : chunk.statements)
+        {
+            shift_positions(statement, offset);
+            program_seq.push_back(statement);
+        }
+    }
+
+    // In the order the parser would have reported them in.
+    for (Chunk& chunk : chunks)
+        DiagnosticBag::add(std::vector<Diagnostic>(chunk.diagnostics.begin(), chunk.diagnostics.begin()+chunk.lexed));
+    for (Chunk& chunk : chunks)
+        DiagnosticBag::add(std::vector<Diagnostic>(chunk.diagnostics.begin()+chunk.lexed, chunk.diagnostics.end()));
+
+    return new SequenceExpressionSyntax(program_seq, Position(chunks[0].first, _text.size()+1), _show_return);
+}
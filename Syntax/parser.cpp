@@ -5,41 +5,41 @@ using namespace Syntax;
 using namespace Objects;
 using namespace Diagnostics;
 
-// This turns the tokens into a tree of syntax. 
-Parser::Parser(std::string& text, bool show_return) : _position(0), _show_return(show_return)
+// This turns the tokens into a tree of syntax. The whole script is lexed up front, unless it's being
+// streamed, where tokens are only pulled from the lexer as the parser gets to them.
+// When it's lazy, function bodies are only pre-parsed, so the script has to outlive the tree.
+// It can start partway into the text, for a function body that was pre-parsed or a part of a script
+// that's parsed on its own thread, so the positions still point into the whole script.
+Parser::Parser(std::string_view text, bool show_return, bool is_streaming, bool is_lazy, int position)
+    : _text(text), _lexer(text, position), _functions(0), _taken_end(position), _show_return(show_return), _is_lazy(is_lazy)
 {
-    Lexer lexer(text);
-    SyntaxToken token;
-    do
-    {
-        token = lexer.lex();
-        switch(token.kind())
-        {
-            case SyntaxKind::BadToken:
-            case SyntaxKind::WhitespaceToken:
-            case SyntaxKind::CommentToken:
-                break;
-            default:
-                _tokens.push_back(token);
-        }
-    } while (token.kind() != SyntaxKind::EndOfFileToken);
+    if (is_streaming) return;
+    while (_tokens.empty() || _tokens.back().kind() != SyntaxKind::EndOfFileToken)
+        peek(_tokens.size());
 }
 
-SyntaxToken Parser::peek(int offset) const
+// Bad tokens are skipped, and the end of file token stays once it's reached.
+SyntaxToken Parser::peek(int offset)
 {  
-    unsigned int index = _position+offset;
-    if (index >= _tokens.size()) 
-        index = _tokens.size()-1;
+    while ((int)_tokens.size() <= offset)
+    {
+        if (!_tokens.empty() && _tokens.back().kind() == SyntaxKind::EndOfFileToken)
+            return _tokens.back();
+
+        SyntaxToken token = _lexer.lex();
+        if (token.kind() != SyntaxKind::BadToken)
+            _tokens.push_back(token);
+    }
     
-    return _tokens[index];
+    return _tokens[offset];
 }
 
-SyntaxToken Parser::current() const
+SyntaxToken Parser::current()
 {
     return peek(0);
 }
 
-SyntaxToken Parser::look_ahead() const
+SyntaxToken Parser::look_ahead()
 {
     return peek(1);
 }
@@ -47,7 +47,10 @@ SyntaxToken Parser::look_ahead() const
 SyntaxToken Parser::next_token()
 {
     SyntaxToken curr = current();
-    _position++;
+    if (curr.kind() == SyntaxKind::EndOfFileToken) return curr;
+
+    _taken_end = curr.get_pos().end;
+    _tokens.pop_front();
     return curr;
 }
 
@@ -94,7 +97,7 @@ SyntaxNode* Parser::parse_program(bool sub_program)
                 {
                     match_token(SyntaxKind::RCurlyToken);
                     return new SequenceExpressionSyntax(program_seq, 
-                        Position(start.ln, start.col, start.start, current().get_pos().end), 
+                        Position(start.start, current().get_pos().end), 
                         _show_return); 
                 }
                 default:
@@ -103,32 +106,88 @@ SyntaxNode* Parser::parse_program(bool sub_program)
         }
         next_token();
         return new SequenceExpressionSyntax(program_seq, 
-            Position(start.ln, start.col, start.start, current().get_pos().end),  
+            Position(start.start, current().get_pos().end),  
             _show_return); 
     }
 
-    while(current().kind() != SyntaxKind::EndOfFileToken)
+    while(!is_done())
+        program_seq.push_back(parse_next());
+        
+    return new SequenceExpressionSyntax(program_seq,
+        Position(start.start, current().get_pos().end), 
+        _show_return);
+}
+
+// Refer to lazy-body-syntax.cpp.
+SyntaxNode* Parser::parse_body()
+{
+    SyntaxNode* body = parse_statement();
+    match_token(SyntaxKind::EndOfFileToken);
+    return body;
+}
+
+bool Parser::is_done()
+{
+    return current().kind() == SyntaxKind::EndOfFileToken;
+}
+
+// A single top-level statement. Refer to run_stream in initialize.cpp for running them as they're parsed.
+SyntaxNode* Parser::parse_next()
+{
+    SyntaxNode* statement = parse_statement();
+    switch(current().kind())
     {
-        program_seq.push_back(parse_statement());
-        switch(current().kind())
+        case SyntaxKind::RParenToken:
+        case SyntaxKind::RSquareToken:
+        case SyntaxKind::RCurlyToken:
+        case SyntaxKind::CommaToken:
         {
-            case SyntaxKind::RParenToken:
-            case SyntaxKind::RSquareToken:
-            case SyntaxKind::RCurlyToken:
-            case SyntaxKind::CommaToken:
-            {
-                Diagnostics::DiagnosticBag::report_unexpected_token(kind_to_string(current().kind()), 
-                    kind_to_string(SyntaxKind::SemicolonToken), current().get_pos());
-                next_token();
-            }
-            default:
-                break;
+            Diagnostics::DiagnosticBag::report_unexpected_token(kind_to_string(current().kind()), 
+                kind_to_string(SyntaxKind::SemicolonToken), current().get_pos());
+            next_token();
         }
+        default:
+            break;
     }
-        
-    return new SequenceExpressionSyntax(program_seq,
-        Position(start.ln, start.col, start.start, current().get_pos().end), 
-        _show_return);
+    return statement;
+}
+
+// The number of function definitions parsed so far. The functions they make hold on to their bodies,
+// so a statement that has one can't be deleted.
+int Parser::get_function_count() const
+{
+    return _functions;
+}
+
+// Where the next token starts in the script.
+int Parser::get_offset()
+{
+    return current().get_pos().start;
+}
+
+// Where the arena is at before the next statement. The tokens the parser has already pulled belong to the
+// statements after the mark, so their positions are left out of it when nothing else comes after them.
+SyntaxMark Parser::mark()
+{
+    std::vector<SyntaxNode*> ahead;
+    for (SyntaxToken& token : _tokens)
+        ahead.push_back(&token);
+
+    SyntaxMark mark = SyntaxArena::mark();
+    mark.positions = SyntaxNode::count_positions(ahead);
+    return mark;
+}
+
+// Cuts the arena back to the mark once the statements parsed since then are deleted.
+// The tokens the parser has already pulled keep their positions.
+void Parser::release(const SyntaxMark& mark)
+{
+    std::vector<SyntaxNode*> kept;
+    for (SyntaxToken& token : _tokens)
+        kept.push_back(&token);
+
+    SyntaxArena::release(mark);
+    SyntaxNode::release_positions(mark.positions, kept);
 }
 
 SyntaxNode* Parser::parse_statement()
@@ -176,7 +235,7 @@ SyntaxNode* Parser::parse_statement()
             }
 
             return new IfExpressionSyntax(conditions, bodies, else_body, 
-                Position(start.ln, start.col, start.start, current().get_pos().end));
+                Position(start.start, current().get_pos().end));
         }
         case SyntaxKind::WhileKeyword:
         {
@@ -187,7 +246,7 @@ SyntaxNode* Parser::parse_statement()
             match_token(SyntaxKind::RParenToken);
 
             SyntaxNode* body = parse_statement();
-            return new WhileExpressionSyntax(condition, body, Position(start.ln, start.col, start.start, current().get_pos().end));
+            return new WhileExpressionSyntax(condition, body, Position(start.start, current().get_pos().end));
         }
         case SyntaxKind::ForKeyword:
         {
@@ -202,11 +261,12 @@ SyntaxNode* Parser::parse_statement()
             match_token(SyntaxKind::RParenToken);
 
             SyntaxNode* body = parse_statement();
-            return new ForExpressionSyntax(init, condition, update, body, Position(start.ln, start.col, start.start, current().get_pos().end));
+            return new ForExpressionSyntax(init, condition, update, body, Position(start.start, current().get_pos().end));
         }
         case SyntaxKind::DefineFunctionKeyword:
         {
             Position start = current().get_pos();
+            _functions++;
             next_token();
             SyntaxToken identifier = match_token(SyntaxKind::IdentifierToken);
             match_token(SyntaxKind::LParenToken);
@@ -225,9 +285,9 @@ SyntaxNode* Parser::parse_statement()
             }
             
             match_token(SyntaxKind::RParenToken);
-            SyntaxNode* body = parse_statement();
+            SyntaxNode* body = parse_function_body();
             return new FuncDefineExpressionSyntax(identifier, arg_names, body,
-                Position(start.ln, start.col, start.start, current().get_pos().end));
+                Position(start.start, current().get_pos().end));
         }
         case SyntaxKind::ReturnKeyword:
         {
@@ -277,7 +337,7 @@ SyntaxNode* Parser::parse_expression(int precedence)
         SyntaxToken op_token = next_token();
         SyntaxNode* expression = parse_expression(unary_precedence);
         left = new UnaryExpressionSyntax(op_token, expression, 
-            Position(op_token.get_pos().ln, op_token.get_pos().col, op_token.get_pos().start, expression->get_pos().end));
+            Position(op_token.get_pos().start, expression->get_pos().end));
     }
     else 
     {
@@ -294,16 +354,16 @@ SyntaxNode* Parser::parse_expression(int precedence)
                 SyntaxToken var_keyword = next_token();
                 SyntaxToken identifier = match_token(SyntaxKind::IdentifierToken);
                 SyntaxNode* var_decl = new VarDeclareExpressionSyntax(var_keyword, identifier,
-                    Position(start.ln, start.col, start.start, current().get_pos().end));
+                    Position(start.start, current().get_pos().end));
                 if (current().kind() == SyntaxKind::SemicolonToken)
                     return var_decl;
                 
                 match_token(SyntaxKind::EqualsToken);
                 SyntaxNode* expression = parse_expression(precedence);
                 SyntaxNode* var_ass = new VarAssignExpressionSyntax(identifier, expression,
-                    Position(start.ln, start.col, start.start, current().get_pos().end));
+                    Position(start.start, current().get_pos().end));
                 std::vector<SyntaxNode*> seq = {var_decl, var_ass};
-                return new SequenceExpressionSyntax(seq, Position(start.ln, start.col, start.start, current().get_pos().end));
+                return new SequenceExpressionSyntax(seq, Position(start.start, current().get_pos().end));
             }
             case SyntaxKind::IdentifierToken:
             {
@@ -314,7 +374,7 @@ SyntaxNode* Parser::parse_expression(int precedence)
                     next_token();
                     SyntaxNode* expression = parse_expression(precedence);
                     return new VarAssignExpressionSyntax(identifier, expression,
-                        Position(start.ln, start.col, start.start, current().get_pos().end));
+                        Position(start.start, current().get_pos().end));
                 }
                 break;
             }  
@@ -336,7 +396,7 @@ SyntaxNode* Parser::parse_expression(int precedence)
         Position left_pos = left->get_pos();
         Position right_pos = right->get_pos();
         left = new BinaryExpressionSyntax(left, op_token, right, 
-            Position(left_pos.ln, left_pos.col, left_pos.start, right_pos.end));
+            Position(left_pos.start, right_pos.end));
     }
     return left;
 }
@@ -355,7 +415,7 @@ SyntaxNode* Parser::parse_molecule()
                 SyntaxNode* right = parse_expression();
                 match_token(SyntaxKind::RSquareToken);
                 left = new IndexExpressionSyntax(left, right,
-                    Position(start.ln, start.col, start.start, current().get_pos().end));
+                    Position(start.start, current().get_pos().end));
             }
             break;
         }     
@@ -374,7 +434,7 @@ SyntaxNode* Parser::parse_atom()
             SyntaxToken literal_token = next_token();
             std::istringstream is(literal_token.get_text());
             long long x;
-            if (is >> x) return new LiteralExpressionSyntax(new Integer(x), literal_token.get_pos());
+            if (is >> x) return new LiteralExpressionSyntax(Integer::make(x), literal_token.get_pos());
             
             return new LiteralExpressionSyntax(nullptr, Position());
         }
@@ -397,7 +457,7 @@ SyntaxNode* Parser::parse_atom()
         {
             SyntaxToken keyword = next_token();
             bool value = keyword.kind() == SyntaxKind::TrueKeyword;
-            return new LiteralExpressionSyntax(new Boolean(value), keyword.get_pos());
+            return new LiteralExpressionSyntax(Boolean::make(value), keyword.get_pos());
         }
         case SyntaxKind::LParenToken:
         {
@@ -414,7 +474,7 @@ SyntaxNode* Parser::parse_atom()
             if (current().kind() == SyntaxKind::RSquareToken)
             {
                 next_token();
-                return new SequenceExpressionSyntax(elements, Position(start.ln, start.col, start.start, current().get_pos().end), true);
+                return new SequenceExpressionSyntax(elements, Position(start.start, current().get_pos().end), true);
             }
 
             SyntaxNode* expression = parse_expression();
@@ -427,7 +487,7 @@ SyntaxNode* Parser::parse_atom()
                 elements.push_back(expression);
             }
             match_token(SyntaxKind::RSquareToken);
-            return new SequenceExpressionSyntax(elements, Position(start.ln, start.col, start.start, current().get_pos().end), true);
+            return new SequenceExpressionSyntax(elements, Position(start.start, current().get_pos().end), true);
         }
         case SyntaxKind::PrintFunction:
         case SyntaxKind::InputFunction:
@@ -448,7 +508,7 @@ SyntaxNode* Parser::parse_atom()
             {
                 next_token();
                 return new FuncCallExpressionSyntax(identifier, args,
-                    Position(start.ln, start.col, start.start, current().get_pos().end));
+                    Position(start.start, current().get_pos().end));
             }
 
             SyntaxNode* expression = parse_expression();
@@ -462,7 +522,7 @@ SyntaxNode* Parser::parse_atom()
             }
             match_token(SyntaxKind::RParenToken);
             return new FuncCallExpressionSyntax(identifier, args,
-                Position(start.ln, start.col, start.start, current().get_pos().end));
+                Position(start.start, current().get_pos().end));
         }
         default:
         {
@@ -476,7 +536,7 @@ SyntaxNode* Parser::parse_atom()
                 {
                     next_token();
                     return new FuncCallExpressionSyntax(identifier, args,
-                        Position(start.ln, start.col, start.start, current().get_pos().end));
+                        Position(start.start, current().get_pos().end));
                 }
 
                 SyntaxNode* expression = parse_expression();
@@ -490,10 +550,41 @@ SyntaxNode* Parser::parse_atom()
                 }
                 match_token(SyntaxKind::RParenToken);
                 return new FuncCallExpressionSyntax(identifier, args,
-                    Position(start.ln, start.col, start.start, current().get_pos().end));
+                    Position(start.start, current().get_pos().end));
             }
             return new VarAccessExpressionSyntax(identifier,
-                Position(start.ln, start.col, start.start, current().get_pos().end));
+                Position(start.start, current().get_pos().end));
         }
     }
-}
\ No newline at end of file
+}
+
+// A body in curly braces is only pre-parsed when the parser is lazy. It goes through parse_statement like any
+// other, so syntax errors are still reported where the function is defined, but what it builds is deleted
+// straight away and the arena and the position table are cut back to where they were. Errors from the binder
+// are left for the first call. The functions defined in it are only counted when it's built for real.
+SyntaxNode* Parser::parse_function_body()
+{
+    if (!_is_lazy || current().kind() != SyntaxKind::LCurlyToken)
+        return parse_statement();
+
+    int start = current().get_pos().start;
+    bool is_lexed = _tokens.back().kind() == SyntaxKind::EndOfFileToken;
+    int functions = _functions;
+    SyntaxMark mark = SyntaxArena::mark();
+
+    delete parse_statement();
+    _functions = functions;
+
+    // Only the tokens pulled from the lexer during the pre-parse can have positions past the mark.
+    std::vector<SyntaxNode*> kept;
+    if (!is_lexed)
+    {
+        for (SyntaxToken& token : _tokens)
+            kept.push_back(&token);
+    }
+    SyntaxArena::release(mark);
+    SyntaxNode::release_positions(mark.positions, kept);
+
+    Position pos(start, _taken_end);
+    return new LazyBodyExpressionSyntax(_text.substr(0, pos.end), pos);
+}
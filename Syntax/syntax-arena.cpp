@@ -0,0 +1,91 @@
+#include "syntax.h"
+#include <iostream>
+#include <cstddef>
+#include <new>
+
+using namespace Syntax;
+
+// Syntax nodes are bumped off large chunks instead of being allocated one by one, so a tree sits close
+// together in memory and parsing doesn't go to the system for every node. Deleting a node still runs its
+// destructor, but its memory stays in the chunk. The shell keeps the trees of the functions it defines
+// for as long as it runs, so the chunks are only freed when a streamed run cuts the arena back to a mark.
+// Building with -DNO_OBJECT_POOL, or with AddressSanitizer, skips the arena as well as the object pool.
+#if defined(NO_OBJECT_POOL) || defined(__SANITIZE_ADDRESS__)
+#define SYNTAX_ARENA_ENABLED false
+#else
+#define SYNTAX_ARENA_ENABLED true
+#endif
+
+// Each thread bumps off chunks of its own, so threads that parse parts of a script don't share anything.
+// Nodes can still be deleted on any thread, since deleting one doesn't give its memory back to a chunk.
+// The numbers printed are the ones for the current thread.
+thread_local char* SyntaxArena::_next = nullptr;
+thread_local size_t SyntaxArena::_left = 0;
+thread_local long long SyntaxArena::_nodes = 0;
+thread_local std::vector<char*> SyntaxArena::_chunks;
+
+void* SyntaxArena::allocate(size_t size)
+{
+    if (!SYNTAX_ARENA_ENABLED) return ::operator new(size);
+
+    const size_t align = alignof(std::max_align_t);
+    size = (size + align-1) & ~(align-1);
+    if (size > _left)
+    {
+        size_t chunk_size = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+        _next = (char*)::operator new(chunk_size);
+        _left = chunk_size;
+        _chunks.push_back(_next);
+    }
+
+    void* ptr = _next;
+    _next += size;
+    _left -= size;
+    _nodes++;
+    return ptr;
+}
+
+void SyntaxArena::deallocate(void* ptr)
+{
+    if (!SYNTAX_ARENA_ENABLED) ::operator delete(ptr);
+}
+
+// Where the arena and the position table are at. Refer to Parser::mark in parser.cpp.
+SyntaxMark SyntaxArena::mark()
+{
+    return { _chunks.size(), _next, _left, SyntaxNode::count_positions() };
+}
+
+// Hands back everything allocated since the mark. Every node made since then must already be deleted.
+// The first chunk made since the mark is kept and used from its start, so statements that each cross into
+// a new chunk don't go to the system every time. The position table is cut back by the parser.
+void SyntaxArena::release(const SyntaxMark& mark)
+{
+    if (!SYNTAX_ARENA_ENABLED) return;
+
+    if (_chunks.size() == mark.chunks)
+    {
+        _next = mark.next;
+        _left = mark.left;
+        return;
+    }
+
+    while (_chunks.size() > mark.chunks+1)
+    {
+        ::operator delete(_chunks.back());
+        _chunks.pop_back();
+    }
+    _next = _chunks.back();
+    _left = CHUNK_SIZE;
+}
+
+void SyntaxArena::print_stats()
+{
+    if (!SYNTAX_ARENA_ENABLED)
+    {
+        std::cout << "The syntax arena is disabled in this build.\n" << std::endl;
+        return;
+    }
+
+    std::cout << "Syntax nodes: " << _nodes << " allocations, " << _chunks.size()*CHUNK_SIZE/1024 << " KiB reserved\n" << std::endl;
+}
@@ -0,0 +1,537 @@
+#include "Expressions/syntax-expressions.h"
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Syntax;
+using namespace Objects;
+using namespace Diagnostics;
+
+// The parsed tree of a script, kept on disk so a script that hasn't changed isn't lexed or parsed again.
+// The file is next to the script with '.kcc' added to its name, or in $KALMAN_CACHE_DIR named after the hash
+// of the script. It's only used when its version, the size and the hash of the script, and the checksum
+// of its own contents all match, and it's written again otherwise.
+// Only a tree without errors is kept, and before it's folded or bound, so those still run on every start.
+// Function bodies that were only pre-parsed stay that way, and are still parsed from the script when called.
+// The numbers are written as they are in memory, so the file is only meant for the machine that wrote it.
+//
+// The file is a header, a table of every text in the tree, then the nodes. Each node comes after its children,
+// and refers to them, and to its texts, by their index:
+//     kind, start, end, token count, (kind, start, end, text)*, child count, child*, flag, literal value?
+SyntaxCache::SyntaxCache(const std::string& filename, std::string_view script)
+    : _script(script), _hash(hash(script)), _node_count(0), _is_complete(true), _at(nullptr), _end(nullptr)
+{
+    const char* dir = std::getenv("KALMAN_CACHE_DIR");
+    if (dir == nullptr || *dir == '\0')
+    {
+        _path = filename + ".kcc";
+        return;
+    }
+
+    std::ostringstream path;
+    path << dir << "/" << std::hex << std::setw(16) << std::setfill('0') << _hash << ".kcc";
+    _path = path.str();
+}
+
+// FNV-1a.
+unsigned long long SyntaxCache::hash(std::string_view text)
+{
+    unsigned long long h = 14695981039346656037ull;
+    for (char c : text)
+    {
+        h ^= (unsigned char)c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+template <typename T> void SyntaxCache::put(T value)
+{
+    _out.append((const char*)&value, sizeof(T));
+}
+
+unsigned int SyntaxCache::put_string(const std::string& text)
+{
+    auto it = _string_ids.find(text);
+    if (it != _string_ids.end()) return it->second;
+
+    unsigned int id = _strings.size();
+    _strings.push_back(text);
+    _string_ids.emplace(text, id);
+    return id;
+}
+
+void SyntaxCache::put_token(SyntaxToken* token)
+{
+    put((unsigned int)token->kind());
+    put(token->get_pos().start);
+    put(token->get_pos().end);
+    put(put_string(token->get_text()));
+}
+
+// Writes the node after its children, and returns its index.
+unsigned int SyntaxCache::put_node(SyntaxNode* node)
+{
+    if (node == nullptr) return NO_NODE;
+
+    std::vector<SyntaxToken*> tokens;
+    std::vector<unsigned int> children;
+    unsigned int flag = 0;
+    switch (node->kind())
+    {
+        case SyntaxKind::LiteralExpression:
+        {
+            Object* value = ((LiteralExpressionSyntax*)node)->get_object();
+            flag = (unsigned int)(value != nullptr ? value->type() : Type::NONE);
+            break;
+        }
+        case SyntaxKind::UnaryExpression:
+        {
+            UnaryExpressionSyntax* t = (UnaryExpressionSyntax*)node;
+            tokens.push_back(t->get_op_token());
+            children.push_back(put_node(t->get_operand()));
+            break;
+        }
+        case SyntaxKind::BinaryExpression:
+        {
+            BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            tokens.push_back(t->get_op_token());
+            children.push_back(put_node(t->get_left()));
+            children.push_back(put_node(t->get_right()));
+            break;
+        }
+        case SyntaxKind::IndexExpression:
+        {
+            IndexExpressionSyntax* t = (IndexExpressionSyntax*)node;
+            children.push_back(put_node(t->get_to_access()));
+            children.push_back(put_node(t->get_indexer()));
+            break;
+        }
+        case SyntaxKind::SequenceExpression:
+        {
+            SequenceExpressionSyntax* t = (SequenceExpressionSyntax*)node;
+            int n = t->get_nodes_size();
+            for (int i = 0; i < n; i++)
+                children.push_back(put_node(t->get_node(i)));
+            flag = t->get_to_return();
+            break;
+        }
+        case SyntaxKind::VarDeclareExpression:
+        {
+            VarDeclareExpressionSyntax* t = (VarDeclareExpressionSyntax*)node;
+            tokens.push_back(t->get_var_keyword());
+            tokens.push_back(t->get_identifier());
+            break;
+        }
+        case SyntaxKind::VarAssignExpression:
+        {
+            VarAssignExpressionSyntax* t = (VarAssignExpressionSyntax*)node;
+            tokens.push_back(t->get_identifier());
+            children.push_back(put_node(t->get_value()));
+            break;
+        }
+        case SyntaxKind::VarAccessExpression:
+            tokens.push_back(((VarAccessExpressionSyntax*)node)->get_identifier());
+            break;
+        case SyntaxKind::WhileExpression:
+        {
+            WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            children.push_back(put_node(t->get_condition()));
+            children.push_back(put_node(t->get_body()));
+            break;
+        }
+        case SyntaxKind::ForExpression:
+        {
+            ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            children.push_back(put_node(t->get_init()));
+            children.push_back(put_node(t->get_condition()));
+            children.push_back(put_node(t->get_update()));
+            children.push_back(put_node(t->get_body()));
+            break;
+        }
+        case SyntaxKind::IfExpression:
+        {
+            IfExpressionSyntax* t = (IfExpressionSyntax*)node;
+            int n = t->get_size();
+            for (int i = 0; i < n; i++)
+            {
+                children.push_back(put_node(t->get_condition(i)));
+                children.push_back(put_node(t->get_body(i)));
+            }
+            children.push_back(put_node(t->get_else_body()));
+            break;
+        }
+        case SyntaxKind::FuncDefineExpression:
+        {
+            FuncDefineExpressionSyntax* t = (FuncDefineExpressionSyntax*)node;
+            tokens.push_back(t->get_identifier());
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                tokens.push_back(t->get_arg_name(i));
+            children.push_back(put_node(t->get_body()));
+            break;
+        }
+        case SyntaxKind::FuncCallExpression:
+        {
+            FuncCallExpressionSyntax* t = (FuncCallExpressionSyntax*)node;
+            tokens.push_back(t->get_identifier());
+            int n = t->get_arg_size();
+            for (int i = 0; i < n; i++)
+                children.push_back(put_node(t->get_arg(i)));
+            break;
+        }
+        case SyntaxKind::ReturnExpression:
+            children.push_back(put_node(((ReturnExpressionSyntax*)node)->get_to_return()));
+            break;
+        case SyntaxKind::BreakExpression:
+        case SyntaxKind::ContinueExpression:
+        case SyntaxKind::NoneExpression:
+        case SyntaxKind::LazyBodyExpression:
+            break;
+        default:
+            _is_complete = false;
+            return NO_NODE;
+    }
+
+    put((unsigned int)node->kind());
+    put(node->get_pos().start);
+    put(node->get_pos().end);
+    put((unsigned int)tokens.size());
+    for (SyntaxToken* token : tokens)
+        put_token(token);
+    put((unsigned int)children.size());
+    for (unsigned int child : children)
+        put(child);
+    put(flag);
+
+    if (node->kind() == SyntaxKind::LiteralExpression)
+    {
+        Object* value = ((LiteralExpressionSyntax*)node)->get_object();
+        switch ((Type)flag)
+        {
+            case Type::BOOLEAN:
+                put((unsigned int)((Boolean*)value)->get_value());
+                break;
+            case Type::INTEGER:
+                put(((Integer*)value)->get_value());
+                break;
+            case Type::DOUBLE:
+                put(((Double*)value)->get_value());
+                break;
+            case Type::STRING:
+                put(put_string(((String*)value)->get_value()));
+                break;
+            case Type::NONE:
+                break;
+            default:
+                _is_complete = false;
+        }
+    }
+    return _node_count++;
+}
+
+// Written to a file of its own first and then moved over the old one, so a run that reads the cache at the
+// same time sees either all of the old file or all of the new one.
+void SyntaxCache::store(SyntaxNode* root)
+{
+#ifndef _WIN32
+    put_node(root);
+    if (!_is_complete) return;
+
+    std::string nodes;
+    nodes.swap(_out);
+    put((unsigned int)_strings.size());
+    put(_node_count);
+    for (const std::string& text : _strings)
+    {
+        put((unsigned int)text.size());
+        _out.append(text);
+    }
+    _out.append(nodes);
+
+    std::string body;
+    body.swap(_out);
+    put(MAGIC);
+    put(VERSION);
+    put((unsigned long long)_script.size());
+    put(_hash);
+    put(hash(body));
+    _out.append(body);
+
+    std::string temp = _path + ".tmp" + std::to_string(getpid());
+    std::ofstream file(temp, std::ios::binary);
+    if (!file.is_open()) return;
+    file.write(_out.data(), _out.size());
+    file.close();
+    if (!file || std::rename(temp.c_str(), _path.c_str()) != 0)
+        std::remove(temp.c_str());
+#endif
+}
+
+template <typename T> bool SyntaxCache::get(T& value)
+{
+    if ((size_t)(_end-_at) < sizeof(T)) return false;
+    std::memcpy(&value, _at, sizeof(T));
+    _at += sizeof(T);
+    return true;
+}
+
+bool SyntaxCache::get_string(std::string_view& text)
+{
+    unsigned int id;
+    if (!get(id) || id >= _texts.size()) return false;
+    text = _texts[id];
+    return true;
+}
+
+// Makes the next node out of its record. Its children are the nodes made before it that nothing owns yet.
+bool SyntaxCache::get_node()
+{
+    unsigned int kind_id, token_count, child_count, flag;
+    int start, end;
+    if (!get(kind_id) || !get(start) || !get(end) || !get(token_count)) return false;
+    if (token_count > (size_t)(_end-_at)) return false;
+    SyntaxKind kind = (SyntaxKind)kind_id;
+    Position pos(start, end);
+
+    std::vector<SyntaxToken> tokens;
+    for (unsigned int i = 0; i < token_count; i++)
+    {
+        unsigned int token_kind;
+        int token_start, token_end;
+        std::string_view text;
+        if (!get(token_kind) || !get(token_start) || !get(token_end) || !get_string(text)) return false;
+        tokens.push_back(SyntaxToken((SyntaxKind)token_kind, Position(token_start, token_end), text));
+    }
+
+    if (!get(child_count) || child_count > (size_t)(_end-_at)) return false;
+    std::vector<unsigned int> ids(child_count);
+    for (unsigned int& id : ids)
+        if (!get(id)) return false;
+    if (!get(flag)) return false;
+
+    size_t t = tokens.size();
+    size_t c = ids.size();
+    bool is_shaped;
+    switch (kind)
+    {
+        case SyntaxKind::UnaryExpression: is_shaped = t == 1 && c == 1; break;
+        case SyntaxKind::BinaryExpression: is_shaped = t == 1 && c == 2; break;
+        case SyntaxKind::IndexExpression: is_shaped = t == 0 && c == 2; break;
+        case SyntaxKind::SequenceExpression: is_shaped = t == 0; break;
+        case SyntaxKind::VarDeclareExpression: is_shaped = t == 2 && c == 0; break;
+        case SyntaxKind::VarAssignExpression: is_shaped = t == 1 && c == 1; break;
+        case SyntaxKind::VarAccessExpression: is_shaped = t == 1 && c == 0; break;
+        case SyntaxKind::WhileExpression: is_shaped = t == 0 && c == 2; break;
+        case SyntaxKind::ForExpression: is_shaped = t == 0 && c == 4; break;
+        case SyntaxKind::IfExpression: is_shaped = t == 0 && c >= 3 && c % 2 == 1; break;
+        case SyntaxKind::FuncDefineExpression: is_shaped = t >= 1 && c == 1; break;
+        case SyntaxKind::FuncCallExpression: is_shaped = t == 1; break;
+        case SyntaxKind::ReturnExpression: is_shaped = t == 0 && c == 1; break;
+        default: is_shaped = t == 0 && c == 0; break;
+    }
+    if (!is_shaped) return false;
+
+    // Nothing is taken until every child checks out, so a bad record doesn't leave a node owned twice or not at all.
+    std::vector<unsigned int> taken;
+    std::vector<SyntaxNode*> children;
+    for (unsigned int id : ids)
+    {
+        if (id != NO_NODE && (id >= _built.size() || _owned[id]))
+        {
+            for (unsigned int i : taken)
+                _owned[i] = false;
+            return false;
+        }
+        if (id != NO_NODE)
+        {
+            _owned[id] = true;
+            taken.push_back(id);
+        }
+        children.push_back(id != NO_NODE ? _built[id] : nullptr);
+    }
+
+    SyntaxNode* node = nullptr;
+    switch (kind)
+    {
+        case SyntaxKind::LiteralExpression:
+        {
+            Object* value = nullptr;
+            bool is_read = true;
+            switch ((Type)flag)
+            {
+                case Type::BOOLEAN:
+                {
+                    unsigned int b;
+                    is_read = get(b);
+                    if (is_read) value = Boolean::make(b != 0);
+                    break;
+                }
+                case Type::INTEGER:
+                {
+                    long long x;
+                    is_read = get(x);
+                    if (is_read) value = Integer::make(x);
+                    break;
+                }
+                case Type::DOUBLE:
+                {
+                    long double x;
+                    is_read = get(x);
+                    if (is_read) value = new Double(x);
+                    break;
+                }
+                case Type::STRING:
+                {
+                    std::string_view text;
+                    is_read = get_string(text);
+                    if (is_read) value = new String(std::string(text));
+                    break;
+                }
+                case Type::NONE:
+                    break;
+                default:
+                    is_read = false;
+            }
+            if (!is_read) return false;
+            node = new LiteralExpressionSyntax(value, pos);
+            break;
+        }
+        case SyntaxKind::UnaryExpression:
+            node = new UnaryExpressionSyntax(tokens[0], children[0], pos);
+            break;
+        case SyntaxKind::BinaryExpression:
+            node = new BinaryExpressionSyntax(children[0], tokens[0], children[1], pos);
+            break;
+        case SyntaxKind::IndexExpression:
+            node = new IndexExpressionSyntax(children[0], children[1], pos);
+            break;
+        case SyntaxKind::SequenceExpression:
+            node = new SequenceExpressionSyntax(children, pos, flag != 0);
+            break;
+        case SyntaxKind::VarDeclareExpression:
+            node = new VarDeclareExpressionSyntax(tokens[0], tokens[1], pos);
+            break;
+        case SyntaxKind::VarAssignExpression:
+            node = new VarAssignExpressionSyntax(tokens[0], children[0], pos);
+            break;
+        case SyntaxKind::VarAccessExpression:
+            node = new VarAccessExpressionSyntax(tokens[0], pos);
+            break;
+        case SyntaxKind::WhileExpression:
+            node = new WhileExpressionSyntax(children[0], children[1], pos);
+            break;
+        case SyntaxKind::ForExpression:
+            node = new ForExpressionSyntax(children[0], children[1], children[2], children[3], pos);
+            break;
+        case SyntaxKind::IfExpression:
+        {
+            std::vector<SyntaxNode*> conditions, bodies;
+            for (size_t i = 0; i+1 < children.size(); i += 2)
+            {
+                conditions.push_back(children[i]);
+                bodies.push_back(children[i+1]);
+            }
+            node = new IfExpressionSyntax(conditions, bodies, children.back(), pos);
+            break;
+        }
+        case SyntaxKind::FuncDefineExpression:
+        {
+            std::vector<SyntaxToken> arg_names(tokens.begin()+1, tokens.end());
+            node = new FuncDefineExpressionSyntax(tokens[0], arg_names, children[0], pos);
+            break;
+        }
+        case SyntaxKind::FuncCallExpression:
+            node = new FuncCallExpressionSyntax(tokens[0], children, pos);
+            break;
+        case SyntaxKind::ReturnExpression:
+            node = new ReturnExpressionSyntax(children[0]);
+            break;
+        case SyntaxKind::BreakExpression:
+            node = new BreakExpressionSyntax();
+            break;
+        case SyntaxKind::ContinueExpression:
+            node = new ContinueExpressionSyntax();
+            break;
+        case SyntaxKind::NoneExpression:
+            node = new NoneExpressionSyntax();
+            break;
+        case SyntaxKind::LazyBodyExpression:
+            if (end < 0 || (size_t)end > _script.size()) return false;
+            node = new LazyBodyExpressionSyntax(_script.substr(0, end), pos);
+            break;
+        default:
+            return false;
+    }
+
+    _built.push_back(node);
+    _owned.push_back(false);
+    return true;
+}
+
+SyntaxNode* SyntaxCache::read()
+{
+    unsigned int magic, version, string_count, node_count;
+    unsigned long long size, script_hash, checksum;
+    if (!get(magic) || magic != MAGIC || !get(version) || version != VERSION) return nullptr;
+    if (!get(size) || size != _script.size() || !get(script_hash) || script_hash != _hash) return nullptr;
+    if (!get(checksum) || checksum != hash(std::string_view(_at, _end-_at))) return nullptr;
+    if (!get(string_count) || !get(node_count)) return nullptr;
+
+    for (unsigned int i = 0; i < string_count; i++)
+    {
+        unsigned int length;
+        if (!get(length) || length > (size_t)(_end-_at)) return nullptr;
+        _texts.push_back(std::string_view(_at, length));
+        _at += length;
+    }
+
+    bool is_read = true;
+    for (unsigned int i = 0; i < node_count && is_read; i++)
+        is_read = get_node();
+
+    // Everything but the root has to belong to some node.
+    size_t roots = 0;
+    for (size_t i = 0; i < _built.size(); i++)
+        roots += !_owned[i];
+    if (is_read && _at == _end && roots == 1 && !_owned.back())
+        return _built.back();
+
+    for (size_t i = 0; i < _built.size(); i++)
+        if (!_owned[i]) delete _built[i];
+    return nullptr;
+}
+
+// Gives nothing back when there's no usable cache, and the script has to be parsed.
+SyntaxNode* SyntaxCache::load()
+{
+#ifndef _WIN32
+    int fd = open(_path.c_str(), O_RDONLY);
+    if (fd == -1) return nullptr;
+
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+
+    _at = (const char*)data;
+    _end = _at + st.st_size;
+    SyntaxNode* root = read();
+    munmap(data, st.st_size);
+    return root;
+#else
+    return nullptr;
+#endif
+}
@@ -3,74 +3,83 @@
 
 using namespace Syntax;
 
-// Yes, I'm using an if statements here. Switches only work for integers, so I'm out of options.
-// I'm just hoping that the C++ compiler optimizes this.
-SyntaxKind SyntaxFacts::get_keyword_kind(std::string text)
+// Every keyword and builtin name, in the order the old chain of comparisons checked them.
+// If two of them are the same word, the first one wins.
+static const std::pair<const std::string*, SyntaxKind> KEYWORDS[] =
 {
-    if (text == KT_TRUE)
-        return SyntaxKind::TrueKeyword;
-    else if (text == KT_FALSE)
-        return SyntaxKind::FalseKeyword;
-    else if (text == KT_BOOL)
-        return SyntaxKind::BooleanKeyword;
-    else if (text == KT_INTEGER)
-        return SyntaxKind::IntegerKeyword;
-    else if (text == KT_DOUBLE)
-        return SyntaxKind::DoubleKeyword;
-    else if (text == KT_LIST)
-        return SyntaxKind::ListKeyword;
-    else if (text == KT_STRING)
-        return SyntaxKind::StringKeyword;
-    else if (text == KT_FUNCTION)
-        return SyntaxKind::FunctionKeyword;
-    else if (text == KT_DEFINE)
-        return SyntaxKind::DefineFunctionKeyword;
-    else if (text == KT_IF)
-        return SyntaxKind::IfKeyword;
-    else if (text == KT_ELIF)
-        return SyntaxKind::ElifKeyword;
-    else if (text == KT_ELSE)
-        return SyntaxKind::ElseKeyword;
-    else if (text == KT_WHILE)
-        return SyntaxKind::WhileKeyword;
-    else if (text == KT_FOR)
-        return SyntaxKind::ForKeyword;
-    else if (text == KT_AND)
-        return SyntaxKind::AndKeyword;
-    else if (text == KT_OR)
-        return SyntaxKind::OrKeyword;
-    else if (text == KT_XOR)
-        return SyntaxKind::XorKeyword;
-    else if (text == KT_NOT)
-        return SyntaxKind::NotKeyword;
-    else if (text == KT_RETURN)
-        return SyntaxKind::ReturnKeyword;
-    else if (text == KT_BREAK)
-        return SyntaxKind::BreakKeyword;
-    else if (text == KT_CONTINUE)
-        return SyntaxKind::ContinueKeyword;
-    else if (text == BI_PRINT)
-        return SyntaxKind::PrintFunction;
-    else if (text == BI_INPUT)
-        return SyntaxKind::InputFunction;
-    else if (text == BI_SPLIT)
-        return SyntaxKind::SplitFunction;
-    else if (text == BI_SIZE)
-        return SyntaxKind::SizeFunction;
-    else if (text == BI_TYPE)
-        return SyntaxKind::TypeFunction;
-    else if (text == BI_TO_BOOL)
-        return SyntaxKind::ToBoolFunction;
-    else if (text == BI_TO_INT)
-        return SyntaxKind::ToIntFunction;
-    else if (text == BI_TO_DOUBLE)
-        return SyntaxKind::ToDoubleFunction;
-    else if (text == BI_TO_STRING)
-        return SyntaxKind::ToStringFunction;
-    else if (text == BI_SET_INDEX)
-        return SyntaxKind::SetIndexFunction;
-    else
-        return SyntaxKind::IdentifierToken;
+    {&KT_TRUE, SyntaxKind::TrueKeyword},            {&KT_FALSE, SyntaxKind::FalseKeyword},
+    {&KT_BOOL, SyntaxKind::BooleanKeyword},         {&KT_INTEGER, SyntaxKind::IntegerKeyword},
+    {&KT_DOUBLE, SyntaxKind::DoubleKeyword},        {&KT_LIST, SyntaxKind::ListKeyword},
+    {&KT_STRING, SyntaxKind::StringKeyword},        {&KT_FUNCTION, SyntaxKind::FunctionKeyword},
+    {&KT_DEFINE, SyntaxKind::DefineFunctionKeyword},{&KT_IF, SyntaxKind::IfKeyword},
+    {&KT_ELIF, SyntaxKind::ElifKeyword},            {&KT_ELSE, SyntaxKind::ElseKeyword},
+    {&KT_WHILE, SyntaxKind::WhileKeyword},          {&KT_FOR, SyntaxKind::ForKeyword},
+    {&KT_AND, SyntaxKind::AndKeyword},              {&KT_OR, SyntaxKind::OrKeyword},
+    {&KT_XOR, SyntaxKind::XorKeyword},              {&KT_NOT, SyntaxKind::NotKeyword},
+    {&KT_RETURN, SyntaxKind::ReturnKeyword},        {&KT_BREAK, SyntaxKind::BreakKeyword},
+    {&KT_CONTINUE, SyntaxKind::ContinueKeyword},
+    {&BI_PRINT, SyntaxKind::PrintFunction},         {&BI_INPUT, SyntaxKind::InputFunction},
+    {&BI_SPLIT, SyntaxKind::SplitFunction},         {&BI_SIZE, SyntaxKind::SizeFunction},
+    {&BI_TYPE, SyntaxKind::TypeFunction},           {&BI_TO_BOOL, SyntaxKind::ToBoolFunction},
+    {&BI_TO_INT, SyntaxKind::ToIntFunction},        {&BI_TO_DOUBLE, SyntaxKind::ToDoubleFunction},
+    {&BI_TO_STRING, SyntaxKind::ToStringFunction},  {&BI_SET_INDEX, SyntaxKind::SetIndexFunction},
+};
+
+// FNV-1a over the text, then mixed so that every bit of it reaches the slot.
+unsigned int SyntaxFacts::hash_keyword(std::string_view text, unsigned int seed)
+{
+    unsigned int hash = 2166136261u ^ seed;
+    for (char c : text)
+        hash = (hash ^ (unsigned char)c) * 16777619u;
+
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash % KEYWORD_SLOTS;
+}
+
+// The keywords come from constants.h, which can be swapped for another language, so the hash can't be
+// written by hand. Instead, seeds are tried until every keyword gets a slot of its own. With eight times
+// as many slots as keywords, that only takes a few tries.
+SyntaxFacts::KeywordTable SyntaxFacts::build_keyword_table()
+{
+    KeywordTable table;
+    for (table.seed = 0; ; table.seed++)
+    {
+        table.max_length = 0;
+        for (KeywordSlot& slot : table.slots) slot = {std::string_view(), SyntaxKind::IdentifierToken};
+
+        bool is_perfect = true;
+        for (const auto& keyword : KEYWORDS)
+        {
+            std::string_view text = *keyword.first;
+            KeywordSlot& slot = table.slots[hash_keyword(text, table.seed)];
+            if (slot.kind != SyntaxKind::IdentifierToken && slot.text == text) continue;
+            if (slot.kind != SyntaxKind::IdentifierToken)
+            {
+                is_perfect = false;
+                break;
+            }
+            slot = {text, keyword.second};
+            if (text.size() > table.max_length) table.max_length = text.size();
+        }
+        if (is_perfect) return table;
+    }
+}
+
+// This is built after the constants above, since they are in the same file.
+SyntaxFacts::KeywordTable SyntaxFacts::_keywords = SyntaxFacts::build_keyword_table();
+
+// One hash and one comparison. Most identifiers are longer than any keyword, or land in an empty slot.
+SyntaxKind SyntaxFacts::get_keyword_kind(std::string_view text)
+{
+    if (text.size() > _keywords.max_length) return SyntaxKind::IdentifierToken;
+
+    const KeywordSlot& slot = _keywords.slots[hash_keyword(text, _keywords.seed)];
+    if (slot.text == text) return slot.kind;
+    return SyntaxKind::IdentifierToken;
 }
 
 Objects::Type SyntaxFacts::get_keyword_type(SyntaxKind kind)
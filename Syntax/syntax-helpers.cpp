@@ -102,6 +102,11 @@ std::string Syntax::kind_to_string(SyntaxKind kind)
         PROCESS_VAL(SyntaxKind::BreakExpression);
         PROCESS_VAL(SyntaxKind::ContinueExpression);
         PROCESS_VAL(SyntaxKind::NoneExpression);  
+        PROCESS_VAL(SyntaxKind::BoundBinaryExpression);
+        PROCESS_VAL(SyntaxKind::LazyBodyExpression);
+        PROCESS_VAL(SyntaxKind::HoistedExpression);
+        PROCESS_VAL(SyntaxKind::InlinedCallExpression);
+        PROCESS_VAL(SyntaxKind::ParameterExpression);
 
         // Builtin Functions   
         PROCESS_VAL(SyntaxKind::PrintFunction);  
@@ -119,6 +124,63 @@ std::string Syntax::kind_to_string(SyntaxKind kind)
     return s;
 }
 
+// Helper function to convert the bound operator to a string.
+std::string Syntax::bound_operator_to_string(BoundBinaryOperator op)
+{
+    const char* s = 0;
+#define PROCESS_VAL(p) case(p): s = #p; break;
+    switch(op)
+    {
+        PROCESS_VAL(BoundBinaryOperator::IntAdd);
+        PROCESS_VAL(BoundBinaryOperator::IntSubtract);
+        PROCESS_VAL(BoundBinaryOperator::IntMultiply);
+        PROCESS_VAL(BoundBinaryOperator::IntDivide);
+        PROCESS_VAL(BoundBinaryOperator::IntModulo);
+        PROCESS_VAL(BoundBinaryOperator::IntLess);
+        PROCESS_VAL(BoundBinaryOperator::IntGreater);
+        PROCESS_VAL(BoundBinaryOperator::IntLessEquals);
+        PROCESS_VAL(BoundBinaryOperator::IntGreaterEquals);
+        PROCESS_VAL(BoundBinaryOperator::IntEquals);
+        PROCESS_VAL(BoundBinaryOperator::IntNotEquals);
+
+        PROCESS_VAL(BoundBinaryOperator::DoubleAdd);
+        PROCESS_VAL(BoundBinaryOperator::DoubleSubtract);
+        PROCESS_VAL(BoundBinaryOperator::DoubleMultiply);
+        PROCESS_VAL(BoundBinaryOperator::DoubleDivide);
+        PROCESS_VAL(BoundBinaryOperator::DoubleLess);
+        PROCESS_VAL(BoundBinaryOperator::DoubleGreater);
+        PROCESS_VAL(BoundBinaryOperator::DoubleLessEquals);
+        PROCESS_VAL(BoundBinaryOperator::DoubleGreaterEquals);
+        PROCESS_VAL(BoundBinaryOperator::DoubleEquals);
+        PROCESS_VAL(BoundBinaryOperator::DoubleNotEquals);
+
+        PROCESS_VAL(BoundBinaryOperator::BoolAnd);
+        PROCESS_VAL(BoundBinaryOperator::BoolOr);
+        PROCESS_VAL(BoundBinaryOperator::BoolXor);
+        PROCESS_VAL(BoundBinaryOperator::BoolEquals);
+        PROCESS_VAL(BoundBinaryOperator::BoolNotEquals);
+    }
+#undef PROCESS_VAL
+    return s;
+}
+
+// Helper function to convert the bound unary operator to a string.
+std::string Syntax::bound_unary_operator_to_string(BoundUnaryOperator op)
+{
+    const char* s = 0;
+#define PROCESS_VAL(p) case(p): s = #p; break;
+    switch(op)
+    {
+        PROCESS_VAL(BoundUnaryOperator::IntNegate);
+        PROCESS_VAL(BoundUnaryOperator::IntIdentity);
+        PROCESS_VAL(BoundUnaryOperator::DoubleNegate);
+        PROCESS_VAL(BoundUnaryOperator::DoubleIdentity);
+        PROCESS_VAL(BoundUnaryOperator::BoolNot);
+    }
+#undef PROCESS_VAL
+    return s;
+}
+
 // Prints the parse tree in a pretty way. This is purely for debugging purposes.
 void Syntax::pretty_print(SyntaxNode* node, std::string indent, bool is_last)
 {
@@ -141,24 +203,41 @@ void Syntax::pretty_print(SyntaxNode* node, std::string indent, bool is_last)
         case SyntaxKind::UnaryExpression:
         {
             UnaryExpressionSyntax* t = (UnaryExpressionSyntax*)node;
+            UnaryFeedback* feedback = t->get_feedback();
+            if (feedback->hits || feedback->misses)
+                std::cout << " (" << (feedback->is_quickened ? bound_unary_operator_to_string(feedback->op) : "generic")
+                    << ", hits: " << feedback->hits << ", misses: " << feedback->misses << ")";
             children = {t->get_op_token(), t->get_operand()};
             break;
         }
         case SyntaxKind::BinaryExpression:
         {
             BinaryExpressionSyntax* t = (BinaryExpressionSyntax*)node;
+            BinaryFeedback* feedback = t->get_feedback();
+            if (feedback->hits || feedback->misses)
+                std::cout << " (" << (feedback->is_quickened ? bound_operator_to_string(feedback->op) : "generic")
+                    << ", hits: " << feedback->hits << ", misses: " << feedback->misses << ")";
             children = {t->get_left(), t->get_op_token(), t->get_right()};
             break;
         }
+        case SyntaxKind::BoundBinaryExpression:
+        {
+            BoundBinaryExpressionSyntax* t = (BoundBinaryExpressionSyntax*)node;
+            std::cout << " " << bound_operator_to_string(t->get_op());
+            children = {t->get_left(), t->get_right()};
+            break;
+        }
         case SyntaxKind::ForExpression:
         {
             ForExpressionSyntax* t = (ForExpressionSyntax*)node;
+            if (t->get_counted_loop()) std::cout << " (counted)";
             children = {t->get_init(), t->get_condition(), t->get_update(), t->get_body()};
             break;
         }
         case SyntaxKind::WhileExpression:
         {
             WhileExpressionSyntax* t = (WhileExpressionSyntax*)node;
+            if (t->get_counted_loop()) std::cout << " (counted)";
             children = {t->get_condition(), t->get_body()};
             break;
         }
@@ -237,6 +316,24 @@ void Syntax::pretty_print(SyntaxNode* node, std::string indent, bool is_last)
             children = {t->get_var_keyword(), t->get_identifier()};
             break;
         }
+        case SyntaxKind::LazyBodyExpression:
+        {
+            LazyBodyExpressionSyntax* t = (LazyBodyExpressionSyntax*)node;
+            if (t->get_body()) children = {t->get_body()};
+            break;
+        }
+        case SyntaxKind::HoistedExpression:
+            children = {((HoistedExpressionSyntax*)node)->get_expression()};
+            break;
+        case SyntaxKind::InlinedCallExpression:
+        {
+            InlinedCallExpressionSyntax* t = (InlinedCallExpressionSyntax*)node;
+            children = {t->get_call(), t->get_body()};
+            break;
+        }
+        case SyntaxKind::ParameterExpression:
+            children = {((ParameterExpressionSyntax*)node)->get_identifier()};
+            break;
         case SyntaxKind::NoneExpression:
         case SyntaxKind::BreakExpression:
         case SyntaxKind::ContinueExpression:
@@ -1,14 +1,88 @@
 #include "syntax.h"
+#include <algorithm>
 
 using namespace Syntax;
 using namespace Diagnostics;
 
-SyntaxNode::SyntaxNode() : _pos(Position()) {}
-SyntaxNode::SyntaxNode(Position pos) : _pos(pos) {}
+// Positions are only needed when a diagnostic gets reported, so they are kept in a table on the side
+// and a node only holds its index into it. A node without a position holds -1.
+// A thread that parses part of a script puts its positions in a table of its own, which is added to this one
+// once it's done. Refer to parallel-parser.cpp.
+std::vector<Position> SyntaxNode::_positions;
+thread_local std::vector<Position>* SyntaxNode::_table = &SyntaxNode::_positions;
 
-Position SyntaxNode::get_pos()
+SyntaxNode::SyntaxNode(SyntaxKind kind) : _kind(kind), _pos_id(-1) {}
+SyntaxNode::SyntaxNode(SyntaxKind kind, Position pos) : _kind(kind), _pos_id(_table->size())
 {
-    return _pos;
+    _table->push_back(pos);
 }
 
-SyntaxNode::~SyntaxNode() {}
\ No newline at end of file
+Position SyntaxNode::get_pos() const
+{
+    if (_pos_id < 0) return Position();
+    return (*_table)[_pos_id];
+}
+
+// The size of the table, leaving out the positions at the end of it that only the nodes in 'ahead' use.
+size_t SyntaxNode::count_positions(const std::vector<SyntaxNode*>& ahead)
+{
+    size_t size = _table->size();
+    bool is_ahead = true;
+    while (size > 0 && is_ahead)
+    {
+        is_ahead = false;
+        for (SyntaxNode* node : ahead)
+            is_ahead = is_ahead || node->_pos_id == (int)size-1;
+        if (is_ahead) size--;
+    }
+    return size;
+}
+
+// Cuts the table back to the mark once the nodes made since then are deleted. The nodes that are kept
+// still need their positions, so the ones past the mark are moved down to right after it.
+void SyntaxNode::release_positions(size_t mark, std::vector<SyntaxNode*>& kept)
+{
+    std::sort(kept.begin(), kept.end(), [](SyntaxNode* a, SyntaxNode* b) { return a->_pos_id < b->_pos_id; });
+
+    size_t end = mark;
+    for (SyntaxNode* node : kept)
+    {
+        if (node->_pos_id < (int)mark) continue;
+        (*_table)[end] = (*_table)[node->_pos_id];
+        node->_pos_id = end++;
+    }
+    _table->resize(end);
+}
+
+// Gives this thread its own table, or the shared one back when it's given nothing.
+void SyntaxNode::set_position_table(std::vector<Position>* table)
+{
+    _table = table != nullptr ? table : &_positions;
+}
+
+// Adds the table of another thread to the end of the shared one, and returns where it starts.
+// The nodes that use it have to be shifted by that much.
+int SyntaxNode::add_positions(const std::vector<Position>& positions)
+{
+    int start = _positions.size();
+    _positions.insert(_positions.end(), positions.begin(), positions.end());
+    return start;
+}
+
+void SyntaxNode::shift_position(int offset)
+{
+    if (_pos_id >= 0) _pos_id += offset;
+}
+
+SyntaxNode::~SyntaxNode() {}
+
+// Refer to syntax-arena.cpp.
+void* SyntaxNode::operator new(size_t size)
+{
+    return SyntaxArena::allocate(size);
+}
+
+void SyntaxNode::operator delete(void* ptr)
+{
+    SyntaxArena::deallocate(ptr);
+}
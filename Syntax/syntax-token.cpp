@@ -4,20 +4,42 @@ using namespace Syntax;
 using namespace Objects;
 using namespace Diagnostics;
 
+// Every distinct text is stored once, so copying a token doesn't copy its text. The lexer looks texts up
+// straight from the script, and only a text that wasn't seen before gets copied out of it. The keys are views
+// of the stored strings, which never move.
+// Threads can lex at the same time, so each one looks in its own copy of the table first, and only locks the
+// shared one for a text it hasn't seen yet.
+std::unordered_map<std::string_view, const std::string*> SyntaxToken::_interned;
+std::mutex SyntaxToken::_interned_lock;
+
+const std::string* SyntaxToken::intern(std::string_view text)
+{
+    thread_local std::unordered_map<std::string_view, const std::string*> seen;
+    auto it = seen.find(text);
+    if (it != seen.end()) return it->second;
+
+    std::lock_guard<std::mutex> lock(_interned_lock);
+    const std::string* stored;
+    auto shared = _interned.find(text);
+    if (shared != _interned.end()) stored = shared->second;
+    else
+    {
+        stored = new std::string(text);
+        _interned.emplace(*stored, stored);
+    }
+    seen.emplace(*stored, stored);
+    return stored;
+}
+
 // These are the tokens that the lexer tokenizes with.
-SyntaxToken::SyntaxToken(SyntaxKind kind, Position position, std::string text)
-    : SyntaxNode(position), _kind(kind), _text(text) {}
+SyntaxToken::SyntaxToken(SyntaxKind kind, Position position, std::string_view text)
+    : SyntaxNode(kind, position), _text(intern(text)) {}
 
-SyntaxToken::SyntaxToken() : _kind(SyntaxKind::BadToken), _text("") {}
+SyntaxToken::SyntaxToken() : SyntaxNode(SyntaxKind::BadToken), _text(intern("")) {}
 
 SyntaxToken::~SyntaxToken() {}
 
-SyntaxKind SyntaxToken::kind() const
+const std::string& SyntaxToken::get_text() const
 {
-    return _kind;
+    return *_text;
 }
-
-std::string SyntaxToken::get_text() const
-{
-    return _text;
-}
\ No newline at end of file
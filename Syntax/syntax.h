@@ -2,6 +2,15 @@
 
 #include "../Objects/object.h"
 #include "../Diagnostics/diagnostic.h"
+#include <string_view>
+#include <unordered_map>
+#include <mutex>
+
+namespace Compilers
+{
+    // Refer to trace-jit.cpp.
+    struct Trace;
+}
 
 namespace Syntax
 {
@@ -86,6 +95,11 @@ namespace Syntax
         BreakExpression,
         ContinueExpression,
         NoneExpression,
+        BoundBinaryExpression,
+        LazyBodyExpression,
+        HoistedExpression,
+        InlinedCallExpression,
+        ParameterExpression,
 
         // Builtin Functions
         PrintFunction,
@@ -102,18 +116,148 @@ namespace Syntax
 
     std::string kind_to_string(SyntaxKind kind);
 
+    // Binary operations specialized for operand types known before evaluation.
+    enum class BoundBinaryOperator
+    {
+        IntAdd,
+        IntSubtract,
+        IntMultiply,
+        IntDivide,
+        IntModulo,
+        IntLess,
+        IntGreater,
+        IntLessEquals,
+        IntGreaterEquals,
+        IntEquals,
+        IntNotEquals,
+
+        DoubleAdd,
+        DoubleSubtract,
+        DoubleMultiply,
+        DoubleDivide,
+        DoubleLess,
+        DoubleGreater,
+        DoubleLessEquals,
+        DoubleGreaterEquals,
+        DoubleEquals,
+        DoubleNotEquals,
+
+        BoolAnd,
+        BoolOr,
+        BoolXor,
+        BoolEquals,
+        BoolNotEquals,
+    };
+
+    std::string bound_operator_to_string(BoundBinaryOperator op);
+
+    // Unary operations specialized for a known operand type.
+    enum class BoundUnaryOperator
+    {
+        IntNegate,
+        IntIdentity,
+        DoubleNegate,
+        DoubleIdentity,
+        BoolNot,
+    };
+
+    std::string bound_unary_operator_to_string(BoundUnaryOperator op);
+
+    class SyntaxNode;
+
+    // Refer to counted-loops.cpp.
+    struct CountedLoop
+    {
+        std::string variable;
+        BoundBinaryOperator compare;
+        SyntaxNode* limit;
+        long long step;
+        std::vector<SyntaxNode*> body;
+        bool is_read;
+    };
+
+    // Refer to trace-jit.cpp.
+    struct LoopHeat
+    {
+        long long back_edges;
+        int bad_exits;
+        bool is_failed;
+        Compilers::Trace* trace;
+    };
+
+    // Refer to binary-syntax.cpp.
+    struct BinaryFeedback
+    {
+        bool is_quickened;
+        Objects::Type left;
+        Objects::Type right;
+        BoundBinaryOperator op;
+        long long hits;
+        long long misses;
+    };
+
+    // Refer to unary-syntax.cpp.
+    struct UnaryFeedback
+    {
+        bool is_quickened;
+        Objects::Type operand;
+        BoundUnaryOperator op;
+        long long hits;
+        long long misses;
+    };
+
+    // Refer to syntax-arena.cpp.
+    struct SyntaxMark
+    {
+        size_t chunks;
+        char* next;
+        size_t left;
+        size_t positions;
+    };
+
+    // Refer to syntax-arena.cpp.
+    class SyntaxArena final
+    {
+    private:
+        static const size_t CHUNK_SIZE = 64*1024;
+        static thread_local char* _next;
+        static thread_local size_t _left;
+        static thread_local long long _nodes;
+        static thread_local std::vector<char*> _chunks;
+    public:
+        static void* allocate(size_t size);
+        static void deallocate(void* ptr);
+        static SyntaxMark mark();
+        static void release(const SyntaxMark& mark);
+        static void print_stats();
+    };
+
+    // Refer to syntax-node.cpp.
     class SyntaxNode
     {
     private:
-        Diagnostics::Position _pos;
+        static std::vector<Diagnostics::Position> _positions;
+        static thread_local std::vector<Diagnostics::Position>* _table;
+
+        SyntaxKind _kind;
+        int _pos_id;
     public:
-        SyntaxNode();
-        SyntaxNode(Diagnostics::Position pos);
+        SyntaxNode(SyntaxKind kind);
+        SyntaxNode(SyntaxKind kind, Diagnostics::Position pos);
+
+        Diagnostics::Position get_pos() const;
 
-        virtual Diagnostics::Position get_pos();
+        static size_t count_positions(const std::vector<SyntaxNode*>& ahead = {});
+        static void release_positions(size_t mark, std::vector<SyntaxNode*>& kept);
+        static void set_position_table(std::vector<Diagnostics::Position>* table);
+        static int add_positions(const std::vector<Diagnostics::Position>& positions);
+        void shift_position(int offset);
 
         virtual ~SyntaxNode(); 
-        virtual SyntaxKind kind() const = 0;
+        SyntaxKind kind() const { return _kind; }
+
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr);
     };
 
     void pretty_print(SyntaxNode* node, std::string indent="", bool is_last=true);
@@ -122,41 +266,64 @@ namespace Syntax
     class SyntaxToken final : public SyntaxNode
     {
     private:
-        SyntaxKind _kind;
-        std::string _text;
+        static std::unordered_map<std::string_view, const std::string*> _interned;
+        static std::mutex _interned_lock;
+
+        static const std::string* intern(std::string_view text);
+
+        const std::string* _text;
     public:
-        SyntaxToken(SyntaxKind kind, Diagnostics::Position position, std::string text);
+        SyntaxToken(SyntaxKind kind, Diagnostics::Position position, std::string_view text);
         SyntaxToken();
         ~SyntaxToken();
 
-        SyntaxKind kind() const;
-        int get_position() const;
-        std::string get_text() const;
+        const std::string& get_text() const;
     };
 
     // Refer to lexer.cpp.
     class Lexer final
     {
     private:
-        const std::string _text;
+        const std::string_view _text;
         int _position;
-        int _ln;
-        int _col;
         
         char peek(int offset) const;
         char current() const;
         char look_ahead() const;
         void next(); 
+        void skip_trivia();
+
+        int scan_whitespace(int from) const;
+        int scan_identifier(int from) const;
+        int find_char(int from, char c) const;
     public:
-        Lexer(const std::string& text);
+        Lexer(std::string_view text, int position=0);
         SyntaxToken lex();
     };
 
     // Refer to syntax-facts.cpp.
     class SyntaxFacts final
     {
+    private:
+        struct KeywordSlot
+        {
+            std::string_view text;
+            SyntaxKind kind;
+        };
+
+        static const unsigned int KEYWORD_SLOTS = 256;
+        struct KeywordTable
+        {
+            KeywordSlot slots[KEYWORD_SLOTS];
+            unsigned int seed;
+            size_t max_length;
+        };
+        static KeywordTable _keywords;
+
+        static unsigned int hash_keyword(std::string_view text, unsigned int seed);
+        static KeywordTable build_keyword_table();
     public:
-        static SyntaxKind get_keyword_kind(std::string text);
+        static SyntaxKind get_keyword_kind(std::string_view text);
         static int get_binary_precedence(SyntaxKind kind);
         static int get_unary_precedence(SyntaxKind kind);
         static Objects::Type get_keyword_type(SyntaxKind kind);
@@ -1,20 +1,38 @@
 #include <iostream>
-#include <fstream>
+#include <vector>
 
 #include "Evaluators/initialize.h"
 
-using Evaluators::initialize;
 using Evaluators::run;
+using Evaluators::run_stream;
+using Evaluators::emit_cpp;
+using Evaluators::ScriptFile;
+
+// Says what went wrong with the arguments, and which flags go together.
+static int usage(const std::string& problem)
+{
+    std::cerr << problem << "\n\n";
+    std::cerr << "Usage: kalman                         runs the shell\n";
+    std::cerr << "       kalman <script> [flags]        runs a script\n";
+    std::cerr << "       kalman --emit-cpp <script>     writes a script out as C++\n\n";
+    std::cerr << "  --emit-cpp    writes the script out as C++ instead of running it, on its own\n";
+    std::cerr << "  --stream      runs each statement as soon as it's parsed, on its own\n";
+    std::cerr << "  --parallel    parses on several threads, not with --cache\n";
+    std::cerr << "  --cache       keeps the parsed script on disk, not with --parallel\n";
+    std::cerr << "  --closures    compiles the tree into closures first, not with --feedback\n";
+    std::cerr << "  --feedback    prints the tree with its type feedback, not with --closures\n";
+    return 1;
+}
 
 int main(int argc, char ** argv)
 {
-    initialize();
     if (argc == 1)
     {
         std::cout << "KalamanC 1.0 (Aug 25, 2020, 18:38)" << std::endl;
         std::cout << "Type \"#help\" for more information\n" << std::endl;
         bool show_tree = false;
         bool show_return = true;
+        bool show_feedback = false;
         while(true)
         {
             std::string line;
@@ -25,6 +43,8 @@ int main(int argc, char ** argv)
                 std::cout << "Shell commands begin with '#'\n" << std::endl;
                 std::cout << "#showtree - toggles to show the parse tree (default: false)" << std::endl;
                 std::cout << "#showreturn - toggles to show the return values of expressions (default: true)" << std::endl;
+                std::cout << "#showfeedback - toggles to show the operand type feedback after evaluation (default: false)" << std::endl;
+                std::cout << "#poolstats - shows how the object pool and the syntax arena are used" << std::endl;
                 std::cout << "#cls - clears the screen (windows only)\n" << std::endl; 
                 continue;
             }
@@ -43,27 +63,81 @@ int main(int argc, char ** argv)
                 continue;
             }
 
+            if (line == "#showfeedback")
+            {
+                show_feedback = !show_feedback;
+                std::cout << (show_feedback ? "Showing type feedback..." : "Not showing type feedback...") << "\n" << std::endl;
+                continue;
+            }
+
+            if (line == "#poolstats")
+            {
+                Objects::ObjectPool::print_stats();
+                Syntax::SyntaxArena::print_stats();
+                continue;
+            }
+
             if (line == "#cls")
             {
                 system("CLS");
                 continue;
             }
             
-            run(line, show_tree, show_return, true);
+            run(line, show_tree, show_return, true, show_feedback);
         }
     }
 
-    std::string filename = argv[1];
-	std::ifstream file(filename);
-	std::string script, line;
-	if (file.is_open())
-	{	
-		while(getline(file, line))
-			script += line + "\n";
+    // The script comes first, and any flags after it. '--emit-cpp' can also come before it.
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args[0] == "--emit-cpp" && args.size() > 1) std::swap(args[0], args[1]);
+    if (args[0].rfind("--", 0) == 0)
+        return usage(args.size() == 1 ? "No script was given." : "The script has to come before the flags.");
 
-		file.close();
-	}
+    bool is_emitting = false;
+    bool is_streaming = false;
+    bool show_feedback = false;
+    bool is_parallel = false;
+    bool is_cached = false;
+    bool use_closures = false;
+    for (size_t i = 1; i < args.size(); i++)
+    {
+        bool* flag = nullptr;
+        if (args[i] == "--emit-cpp") flag = &is_emitting;
+        else if (args[i] == "--stream") flag = &is_streaming;
+        else if (args[i] == "--feedback") flag = &show_feedback;
+        else if (args[i] == "--parallel") flag = &is_parallel;
+        else if (args[i] == "--cache") flag = &is_cached;
+        else if (args[i] == "--closures") flag = &use_closures;
+        if (flag == nullptr) return usage("Unknown flag '" + args[i] + "'.");
+        *flag = true;
+    }
+
+    int flags = args.size() - 1;
+    if ((is_emitting || is_streaming) && flags > 1)
+        return usage("'--emit-cpp' and '--stream' can't be used with other flags.");
+    if (is_parallel && is_cached) return usage("'--parallel' and '--cache' can't be used together.");
+    if (show_feedback && use_closures) return usage("'--feedback' and '--closures' can't be used together.");
+
+    // '--emit-cpp' writes the script out as a C++ program. Refer to cpp-emitter.cpp.
+    if (is_emitting)
+    {
+        ScriptFile script(args[0]);
+        return emit_cpp(script.get_text(), args[0]) ? 0 : 1;
+    }
+
+    ScriptFile script(args[0]);
+
+    // '--stream' runs each statement as soon as it's parsed. Refer to initialize.cpp.
+    if (is_streaming)
+    {
+        run_stream(script);
+        return 0;
+    }
 
-    run(script);
+    // '--feedback' prints the tree with the type feedback once the script is done.
+    // '--parallel' parses a large script on several threads. Refer to parallel-parser.cpp.
+    // '--cache' keeps the parsed script on disk for the next run. Refer to syntax-cache.cpp.
+    // '--closures' compiles the tree into closures before running it. Refer to closure-compiler.cpp.
+    run(script.get_text(), false, false, false, show_feedback, is_parallel, is_cached ? args[0] : "", use_closures);
     return 0;
-}
\ No newline at end of file
+}